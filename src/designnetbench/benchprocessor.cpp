@@ -0,0 +1,75 @@
+#include "benchprocessor.h"
+#include "designnet/designnet_engine/data/matpayload.h"
+#include <QElapsedTimer>
+
+using namespace DesignNet;
+
+static const char INPUT_PORT[]	= "input";
+static const char OUTPUT_PORT[]	= "output";
+
+BenchProcessor::BenchProcessor(DesignNetSpace *space, QObject *parent)
+	: Processor(space, parent),
+	m_iCost(0),
+	m_iPayloadBytes(0),
+	m_checksum(0)
+{
+	setName(QLatin1String("BenchProcessor"));
+	addPort(Port::IN_PORT, DATATYPE_MATRIX, QLatin1String(INPUT_PORT));
+	addPort(Port::OUT_PORT, DATATYPE_MATRIX, QLatin1String(OUTPUT_PORT));
+	getPort(Port::IN_PORT, QLatin1String(INPUT_PORT))->setMultiInputSupported(true);
+}
+
+void BenchProcessor::setCost(const qint64 &microseconds)
+{
+	m_iCost = qMax(Q_INT64_C(0), microseconds);
+}
+
+void BenchProcessor::setPayloadBytes(const int &bytes)
+{
+	m_iPayloadBytes = qMax(0, bytes);
+}
+
+QString BenchProcessor::category() const
+{
+	return QLatin1String("DesignNetBench");
+}
+
+bool BenchProcessor::connect(Processor *src, Processor *dst)
+{
+	Port *outPort = src->getPort(Port::OUT_PORT, QLatin1String(OUTPUT_PORT));
+	Port *inPort = dst->getPort(Port::IN_PORT, QLatin1String(INPUT_PORT));
+	return outPort && inPort && outPort->connect(inPort);
+}
+
+bool BenchProcessor::process(QFutureInterface<ProcessResult> &future)
+{
+	Q_UNUSED(future);
+	///
+	/// 读取每个输入矩阵的首尾字节，模拟处理器访问上游数据
+	foreach (ProcessData *data, getData(QLatin1String(INPUT_PORT)))
+	{
+		const cv::Mat &mat = data->variant.value<MatPayload>().mat();
+		if (!mat.empty())
+			m_checksum ^= mat.data[0] ^ mat.data[mat.total() * mat.elemSize() - 1];
+	}
+
+	///
+	/// 忙等而不是休眠，使处理器真正占用一个工作线程
+	QElapsedTimer timer;
+	timer.start();
+	while (timer.nsecsElapsed() < m_iCost * 1000)
+		;
+
+	MatPayload payload;
+	if (m_iPayloadBytes > 0)
+	{
+		const int cols = 1024;
+		const int rows = (m_iPayloadBytes + cols - 1) / cols;
+		payload.create(rows, cols, CV_8UC1).setTo(cv::Scalar(m_checksum));
+	}
+	ProcessData pd(DATATYPE_MATRIX);
+	pd.variant.setValue(payload);
+	pd.processorID = m_id;
+	pushData(pd, QLatin1String(OUTPUT_PORT));
+	return true;
+}
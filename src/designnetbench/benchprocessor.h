@@ -0,0 +1,36 @@
+#ifndef BENCHPROCESSOR_H
+#define BENCHPROCESSOR_H
+
+#include "designnet/designnet_engine/designnetbase/processor.h"
+
+/*!
+ * \brief 基准测试使用的合成处理器
+ *
+ * 一个支持多输入的输入端口和一个输出端口。每次执行时读取全部输入数据，
+ * 占用CPU忙等cost()微秒，然后从MatBufferPool申请payloadBytes()字节的矩阵写到输出端口，
+ * 因此可以分别控制处理器本身的计算量和端口之间传递的数据量。
+ */
+class BenchProcessor : public DesignNet::Processor
+{
+public:
+	DECLEAR_PROCESSOR(BenchProcessor)
+	explicit BenchProcessor(DesignNet::DesignNetSpace *space = 0, QObject *parent = 0);
+
+	void setCost(const qint64 &microseconds);	//!< 每次执行的计算时间
+	qint64 cost() const { return m_iCost; }
+	void setPayloadBytes(const int &bytes);		//!< 输出数据的字节数，0表示输出空矩阵
+	int payloadBytes() const { return m_iPayloadBytes; }
+
+	virtual QString category() const;
+
+	static bool connect(DesignNet::Processor *src, DesignNet::Processor *dst);	//!< 连接两个BenchProcessor
+
+protected:
+	virtual bool process(QFutureInterface<DesignNet::ProcessResult> &future);
+
+	qint64	m_iCost;
+	int		m_iPayloadBytes;
+	uchar	m_checksum;		//!< 输入数据的校验和，避免读取被优化掉
+};
+
+#endif // BENCHPROCESSOR_H
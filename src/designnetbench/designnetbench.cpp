@@ -0,0 +1,413 @@
+#include "designnetbench.h"
+#include "benchprocessor.h"
+#include "designnet/designnet_engine/data/matbufferpool.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include "designnet/designnet_engine/designnetbase/processorexecutor.h"
+#include "designnet/designnet_engine/designnetbase/processorprofiler.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <qmath.h>
+#include <algorithm>
+
+using namespace DesignNet;
+
+DesignNetBench::Options::Options()
+	: width(8),
+	depth(32),
+	cost(200),
+	payloadBytes(256 * 1024),
+	iterations(20),
+	warmup(3),
+	bLatency(true)
+{
+	topologies << Chain << Diamond << FanOut << Deep;
+}
+
+DesignNetBench::Result::Result()
+	: topology(Chain),
+	processors(0),
+	edges(0),
+	iterations(0),
+	failures(0),
+	minTime(0),
+	medianTime(0),
+	maxTime(0),
+	meanTime(0),
+	stddevTime(0),
+	runsPerSecond(0),
+	processorsPerSecond(0),
+	edgeOverhead(0),
+	latencyMedian(-1),
+	latency99(-1),
+	latencyMax(-1),
+	peakMatBytes(0),
+	pooledBytes(0)
+{
+}
+
+DesignNetBench::DesignNetBench(const Options &options)
+	: m_options(options)
+{
+	m_options.width = qMax(1, m_options.width);
+	m_options.depth = qMax(1, m_options.depth);
+	m_options.iterations = qMax(1, m_options.iterations);
+	m_options.warmup = qMax(0, m_options.warmup);
+}
+
+QList<DesignNetBench::Result> DesignNetBench::run()
+{
+	QList<Result> results;
+	foreach (const Topology &topology, m_options.topologies)
+		results << measure(topology);
+	return results;
+}
+
+QString DesignNetBench::topologyName(const Topology &topology)
+{
+	switch (topology)
+	{
+	case Chain:		return QLatin1String("chain");
+	case Diamond:	return QLatin1String("diamond");
+	case FanOut:	return QLatin1String("fanout");
+	case Deep:		return QLatin1String("deep");
+	}
+	return QString();
+}
+
+bool DesignNetBench::topologyFromName(const QString &name, Topology *topology)
+{
+	const Topology topologies[] = { Chain, Diamond, FanOut, Deep };
+	for (size_t i = 0; i < sizeof(topologies) / sizeof(topologies[0]); ++i)
+	{
+		if (topologyName(topologies[i]).compare(name.trimmed(), Qt::CaseInsensitive) == 0)
+		{
+			*topology = topologies[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+QStringList DesignNetBench::topologyNames()
+{
+	return QStringList() << topologyName(Chain) << topologyName(Diamond)
+		<< topologyName(FanOut) << topologyName(Deep);
+}
+
+Processor* DesignNetBench::addProcessor(DesignNetSpace *space) const
+{
+	BenchProcessor *processor = new BenchProcessor(space, space);
+	processor->setCost(m_options.cost);
+	processor->setPayloadBytes(m_options.payloadBytes);
+	space->addProcessor(processor);
+	return processor;
+}
+
+/*!
+ * \brief 搭建\e topology 结构的网络
+ *
+ * 处理器按拓扑序加入网络，criticalPath()依赖这个顺序。
+ */
+DesignNetSpace* DesignNetBench::build(const Topology &topology, int *edges) const
+{
+	DesignNetSpace *space = new DesignNetSpace;
+	space->setObjectName(topologyName(topology));
+	space->setIncrementalEnabled(false);
+	const int width = m_options.width;
+	const int depth = m_options.depth;
+	int count = 0;
+	switch (topology)
+	{
+	case Chain:
+		{
+			Processor *prev = addProcessor(space);
+			for (int i = 1; i < depth; ++i)
+			{
+				Processor *next = addProcessor(space);
+				count += BenchProcessor::connect(prev, next) ? 1 : 0;
+				prev = next;
+			}
+		}
+		break;
+	case Diamond:
+		{
+			Processor *source = addProcessor(space);
+			for (int i = 0; i < depth; ++i)
+			{
+				QList<Processor*> branches;
+				for (int j = 0; j < width; ++j)
+				{
+					branches << addProcessor(space);
+					count += BenchProcessor::connect(source, branches.last()) ? 1 : 0;
+				}
+				Processor *sink = addProcessor(space);
+				foreach (Processor *branch, branches)
+					count += BenchProcessor::connect(branch, sink) ? 1 : 0;
+				source = sink;
+			}
+		}
+		break;
+	case FanOut:
+		{
+			Processor *source = addProcessor(space);
+			for (int i = 0; i < width * depth; ++i)
+				count += BenchProcessor::connect(source, addProcessor(space)) ? 1 : 0;
+		}
+		break;
+	case Deep:
+		{
+			QList<Processor*> layer;
+			for (int j = 0; j < width; ++j)
+				layer << addProcessor(space);
+			for (int i = 1; i < depth; ++i)
+			{
+				QList<Processor*> next;
+				for (int j = 0; j < width; ++j)
+				{
+					Processor *processor = addProcessor(space);
+					count += BenchProcessor::connect(layer.at(j), processor) ? 1 : 0;
+					if (width > 1)
+						count += BenchProcessor::connect(layer.at((j + 1) % width), processor) ? 1 : 0;
+					next << processor;
+				}
+				layer = next;
+			}
+		}
+		break;
+	}
+	if (edges)
+		*edges = count;
+	return space;
+}
+
+/*!
+ * \brief 关键路径上处理器自身耗时的总和
+ *
+ * \e processors 必须是拓扑序，\e times 是本次执行中每个处理器的耗时。
+ */
+qint64 DesignNetBench::criticalPath(const QList<Processor*> &processors, const QHash<Processor*, qint64> &times)
+{
+	QHash<Processor*, qint64> finish;
+	qint64 longest = 0;
+	foreach (Processor *processor, processors)
+	{
+		qint64 start = 0;
+		foreach (Processor *father, processor->getInputProcessor())
+			start = qMax(start, finish.value(father));
+		const qint64 end = start + times.value(processor);
+		finish.insert(processor, end);
+		longest = qMax(longest, end);
+	}
+	return longest;
+}
+
+qint64 DesignNetBench::percentile(const QList<qint64> &sorted, const double &ratio)
+{
+	if (sorted.isEmpty())
+		return -1;
+	const int index = qBound(0, qCeil(ratio * sorted.size()) - 1, sorted.size() - 1);
+	return sorted.at(index);
+}
+
+DesignNetBench::Result DesignNetBench::measure(const Topology &topology)
+{
+	Result result;
+	result.topology = topology;
+	result.iterations = m_options.iterations;
+	DesignNetSpace *space = build(topology, &result.edges);
+	const QList<Processor*> processors = space->processors();
+	result.processors = processors.size();
+
+	for (int i = 0; i < m_options.warmup; ++i)
+		space->execute();
+
+	///
+	/// 预热之后缓冲区池中已经缓存了各个大小的缓冲区，从这里开始统计使用峰值
+	MatBufferPool *pool = MatBufferPool::instance();
+	pool->resetStatistics();
+
+	QList<qint64> times;
+	double overhead = 0;
+	QHash<Processor*, qint64> lastTime;
+	QHash<Processor*, qint64> elapsed;
+	for (int i = 0; i < m_options.iterations; ++i)
+	{
+		foreach (Processor *processor, processors)
+			lastTime[processor] = processor->executionTime();
+
+		QElapsedTimer timer;
+		timer.start();
+		if (!space->execute())
+			++result.failures;
+		const qint64 wall = timer.nsecsElapsed() / 1000;
+		times << wall;
+
+		foreach (Processor *processor, processors)
+			elapsed[processor] = processor->executionTime() - lastTime.value(processor);
+		if (result.edges > 0)
+			overhead += double(qMax(Q_INT64_C(0), wall - criticalPath(processors, elapsed))) / result.edges;
+	}
+	const MatBufferPool::Statistics statistics = pool->statistics();
+	result.peakMatBytes = statistics.peakUsedBytes;
+	result.pooledBytes = statistics.pooledBytes;
+
+	std::sort(times.begin(), times.end());
+	double sum = 0;
+	foreach (const qint64 &time, times)
+		sum += time;
+	result.meanTime = sum / times.size();
+	double variance = 0;
+	foreach (const qint64 &time, times)
+		variance += (time - result.meanTime) * (time - result.meanTime);
+	result.stddevTime = qSqrt(variance / times.size());
+	result.minTime = times.first();
+	result.maxTime = times.last();
+	result.medianTime = percentile(times, 0.5);
+	result.edgeOverhead = overhead / times.size();
+	if (result.meanTime > 0)
+	{
+		result.runsPerSecond = 1e6 / result.meanTime;
+		result.processorsPerSecond = result.runsPerSecond * result.processors;
+	}
+
+	///
+	/// 记录会增加少量开销，所以调度延迟在单独的一轮中统计
+	if (m_options.bLatency)
+	{
+		ProcessorProfiler *profiler = ProcessorProfiler::instance();
+		profiler->clear();
+		profiler->setEnabled(true);
+		for (int i = 0; i < m_options.iterations; ++i)
+			space->execute();
+		profiler->setEnabled(false);
+
+		QList<qint64> latencies;
+		foreach (const ProcessorProfiler::Record &record, profiler->records())
+		{
+			if (record.queued >= 0)
+				latencies << record.queueWait();
+		}
+		profiler->clear();
+		std::sort(latencies.begin(), latencies.end());
+		result.latencyMedian = percentile(latencies, 0.5);
+		result.latency99 = percentile(latencies, 0.99);
+		result.latencyMax = latencies.isEmpty() ? -1 : latencies.last();
+	}
+
+	delete space;
+	pool->trim();
+	return result;
+}
+
+void DesignNetBench::printResults(const QList<Result> &results, QTextStream &out) const
+{
+	out << tr("%1 worker threads, cost %2 us, payload %3 KB, %4 iterations after %5 warmup runs")
+		.arg(ProcessorExecutor::instance()->threadCount())
+		.arg(m_options.cost)
+		.arg(m_options.payloadBytes / 1024.0, 0, 'f', 1)
+		.arg(m_options.iterations)
+		.arg(m_options.warmup) << endl << endl;
+	out << QString::fromLatin1("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+		.arg(QLatin1String("topology"), -9)
+		.arg(QLatin1String("procs"), 6)
+		.arg(QLatin1String("edges"), 6)
+		.arg(QLatin1String("median ms"), 10)
+		.arg(QLatin1String("runs/s"), 9)
+		.arg(QLatin1String("procs/s"), 10)
+		.arg(QLatin1String("us/edge"), 8)
+		.arg(QLatin1String("lat p50/p99 us"), 15)
+		.arg(QLatin1String("peak MB"), 8) << endl;
+	foreach (const Result &result, results)
+	{
+		const QString latency = result.latencyMedian < 0 ? QString(QLatin1String("-"))
+			: QString::fromLatin1("%1/%2").arg(result.latencyMedian).arg(result.latency99);
+		out << QString::fromLatin1("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+			.arg(topologyName(result.topology), -9)
+			.arg(result.processors, 6)
+			.arg(result.edges, 6)
+			.arg(result.medianTime / 1000.0, 10, 'f', 2)
+			.arg(result.runsPerSecond, 9, 'f', 1)
+			.arg(result.processorsPerSecond, 10, 'f', 0)
+			.arg(result.edgeOverhead, 8, 'f', 2)
+			.arg(latency, 15)
+			.arg(result.peakMatBytes / (1024.0 * 1024.0), 8, 'f', 2);
+		if (result.failures > 0)
+			out << tr("  (%1 failed)").arg(result.failures);
+		out << endl;
+	}
+}
+
+bool DesignNetBench::writeResults(const QList<Result> &results)
+{
+	if (m_options.outputFile.isEmpty())
+		return true;
+	QSaveFile file(m_options.outputFile);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		m_errorString = tr("Cannot write %1: %2").arg(QDir::toNativeSeparators(m_options.outputFile)).arg(file.errorString());
+		return false;
+	}
+	if (m_options.outputFile.endsWith(QLatin1String(".json"), Qt::CaseInsensitive))
+	{
+		QJsonObject root;
+		root.insert(QLatin1String("threads"), ProcessorExecutor::instance()->threadCount());
+		root.insert(QLatin1String("cost_us"), double(m_options.cost));
+		root.insert(QLatin1String("payload_bytes"), m_options.payloadBytes);
+		root.insert(QLatin1String("width"), m_options.width);
+		root.insert(QLatin1String("depth"), m_options.depth);
+		root.insert(QLatin1String("warmup"), m_options.warmup);
+		QJsonArray array;
+		foreach (const Result &result, results)
+		{
+			QJsonObject object;
+			object.insert(QLatin1String("topology"), topologyName(result.topology));
+			object.insert(QLatin1String("processors"), result.processors);
+			object.insert(QLatin1String("edges"), result.edges);
+			object.insert(QLatin1String("iterations"), result.iterations);
+			object.insert(QLatin1String("failures"), result.failures);
+			object.insert(QLatin1String("min_us"), double(result.minTime));
+			object.insert(QLatin1String("median_us"), double(result.medianTime));
+			object.insert(QLatin1String("max_us"), double(result.maxTime));
+			object.insert(QLatin1String("mean_us"), result.meanTime);
+			object.insert(QLatin1String("stddev_us"), result.stddevTime);
+			object.insert(QLatin1String("runs_per_second"), result.runsPerSecond);
+			object.insert(QLatin1String("processors_per_second"), result.processorsPerSecond);
+			object.insert(QLatin1String("edge_overhead_us"), result.edgeOverhead);
+			object.insert(QLatin1String("latency_p50_us"), double(result.latencyMedian));
+			object.insert(QLatin1String("latency_p99_us"), double(result.latency99));
+			object.insert(QLatin1String("latency_max_us"), double(result.latencyMax));
+			object.insert(QLatin1String("peak_mat_bytes"), double(result.peakMatBytes));
+			object.insert(QLatin1String("pooled_bytes"), double(result.pooledBytes));
+			array.append(object);
+		}
+		root.insert(QLatin1String("results"), array);
+		file.write(QJsonDocument(root).toJson());
+	}
+	else
+	{
+		QTextStream out(&file);
+		out << "topology,processors,edges,iterations,failures,min_us,median_us,max_us,mean_us,stddev_us,"
+			"runs_per_second,processors_per_second,edge_overhead_us,latency_p50_us,latency_p99_us,latency_max_us,"
+			"peak_mat_bytes,pooled_bytes\n";
+		foreach (const Result &result, results)
+		{
+			out << topologyName(result.topology) << ',' << result.processors << ',' << result.edges << ','
+				<< result.iterations << ',' << result.failures << ','
+				<< result.minTime << ',' << result.medianTime << ',' << result.maxTime << ','
+				<< result.meanTime << ',' << result.stddevTime << ','
+				<< result.runsPerSecond << ',' << result.processorsPerSecond << ',' << result.edgeOverhead << ','
+				<< result.latencyMedian << ',' << result.latency99 << ',' << result.latencyMax << ','
+				<< result.peakMatBytes << ',' << result.pooledBytes << '\n';
+		}
+	}
+	if (!file.commit())
+	{
+		m_errorString = tr("Cannot write %1: %2").arg(QDir::toNativeSeparators(m_options.outputFile)).arg(file.errorString());
+		return false;
+	}
+	return true;
+}
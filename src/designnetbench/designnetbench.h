@@ -0,0 +1,97 @@
+#ifndef DESIGNNETBENCH_H
+#define DESIGNNETBENCH_H
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+namespace DesignNet{
+class DesignNetSpace;
+class Processor;
+}
+
+/*!
+ * \brief DesignNet执行引擎的基准测试
+ *
+ * 用BenchProcessor搭建几种典型结构的网络，每种结构先预热若干次，再重复执行并统计：
+ * - 吞吐量：每秒执行整个网络的次数和每秒执行的处理器个数；
+ * - 每条连接的开销：整个网络的耗时减去关键路径上处理器自身的耗时，再除以连接数，
+ *   即调度、派发和端口数据传递在每条连接上花费的时间；
+ * - 调度延迟：处理器进入ProcessorExecutor队列到开始执行的时间，由ProcessorProfiler记录；
+ * - 内存峰值：执行期间MatBufferPool中同时被使用的最大字节数。
+ */
+class DesignNetBench
+{
+	Q_DECLARE_TR_FUNCTIONS(DesignNetBench)
+public:
+	enum Topology
+	{
+		Chain,		//!< depth个处理器串联
+		Diamond,	//!< depth级串联的菱形，每级一个处理器分出width个分支再汇合
+		FanOut,		//!< 一个源处理器连接width * depth个末端处理器
+		Deep		//!< depth层、每层width个处理器，每个处理器连接上一层相邻的两个处理器
+	};
+
+	struct Options
+	{
+		Options();
+		QList<Topology>	topologies;
+		int		width;
+		int		depth;
+		qint64	cost;			//!< 每个处理器的计算时间，微秒
+		int		payloadBytes;	//!< 每个处理器输出的字节数
+		int		iterations;		//!< 统计的执行次数
+		int		warmup;			//!< 预热的执行次数，不统计
+		bool	bLatency;		//!< 是否额外执行一轮统计调度延迟
+		QString	outputFile;		//!< 结果文件，.json后缀输出JSON，否则输出CSV
+	};
+
+	struct Result
+	{
+		Result();
+		Topology	topology;
+		int		processors;
+		int		edges;
+		int		iterations;
+		int		failures;
+		qint64	minTime;			//!< 执行整个网络的耗时，微秒
+		qint64	medianTime;
+		qint64	maxTime;
+		double	meanTime;
+		double	stddevTime;
+		double	runsPerSecond;
+		double	processorsPerSecond;
+		double	edgeOverhead;		//!< 每条连接的平均开销，微秒
+		qint64	latencyMedian;		//!< 调度延迟，微秒，-1表示没有统计
+		qint64	latency99;
+		qint64	latencyMax;
+		qint64	peakMatBytes;		//!< MatBufferPool的使用峰值
+		qint64	pooledBytes;		//!< 执行完成后池中缓存的字节数
+	};
+
+	explicit DesignNetBench(const Options &options);
+
+	QList<Result> run();
+	bool writeResults(const QList<Result> &results);
+	void printResults(const QList<Result> &results, QTextStream &out) const;
+	QString errorString() const { return m_errorString; }
+
+	static QString topologyName(const Topology &topology);
+	static bool topologyFromName(const QString &name, Topology *topology);
+	static QStringList topologyNames();
+
+protected:
+	DesignNet::DesignNetSpace* build(const Topology &topology, int *edges) const;
+	DesignNet::Processor* addProcessor(DesignNet::DesignNetSpace *space) const;
+	Result measure(const Topology &topology);
+	static qint64 criticalPath(const QList<DesignNet::Processor*> &processors, const QHash<DesignNet::Processor*, qint64> &times);
+	static qint64 percentile(const QList<qint64> &sorted, const double &ratio);
+
+	Options	m_options;
+	QString	m_errorString;
+};
+
+#endif // DESIGNNETBENCH_H
@@ -0,0 +1,127 @@
+#include "designnetbench.h"
+#include "designnet/designnet_engine/data/matbufferpool.h"
+#include "designnet/designnet_engine/designnetbase/processorexecutor.h"
+#include "designnet/designnet_engine/designnetbase/processorprofiler.h"
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+/*!
+ * \brief 读取整数选项\e option ，不是整数或者小于\e minimum 时输出错误并返回false
+ */
+static bool intOption(const QCommandLineParser &parser, const QCommandLineOption &option, int minimum, int *value)
+{
+	bool bOk = false;
+	const int v = parser.value(option).toInt(&bOk);
+	if (!bOk || v < minimum)
+	{
+		QTextStream(stderr) << QCoreApplication::translate("designnet-bench", "Invalid value for --%1: %2 (must be an integer >= %3).")
+			.arg(option.names().last()).arg(parser.value(option)).arg(minimum) << endl;
+		return false;
+	}
+	*value = v;
+	return true;
+}
+
+/*!
+ * \brief designnet-bench，DesignNet执行引擎的基准测试
+ *
+ * designnet-bench [选项]
+ * 在不同结构的合成网络上测量吞吐量、每条连接的开销、调度延迟和内存峰值。
+ * 返回值：0表示全部执行成功，1表示参数错误或者结果文件无法写入，2表示有执行失败。
+ */
+int main(int argc, char **argv)
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName(QLatin1String("designnet-bench"));
+
+	DesignNetBench::Options defaults;
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QCoreApplication::translate("designnet-bench", "Benchmarks the DesignNet execution engine with synthetic processors."));
+	parser.addHelpOption();
+	QCommandLineOption topologyOption(QStringList() << QLatin1String("t") << QLatin1String("topology"),
+		QCoreApplication::translate("designnet-bench", "Comma separated topologies to run: %1.").arg(DesignNetBench::topologyNames().join(QLatin1String(", "))),
+		QLatin1String("list"), DesignNetBench::topologyNames().join(QLatin1String(",")));
+	QCommandLineOption widthOption(QStringList() << QLatin1String("w") << QLatin1String("width"),
+		QCoreApplication::translate("designnet-bench", "Number of parallel branches."), QLatin1String("n"), QString::number(defaults.width));
+	QCommandLineOption depthOption(QStringList() << QLatin1String("d") << QLatin1String("depth"),
+		QCoreApplication::translate("designnet-bench", "Number of stages."), QLatin1String("n"), QString::number(defaults.depth));
+	QCommandLineOption costOption(QStringList() << QLatin1String("c") << QLatin1String("cost"),
+		QCoreApplication::translate("designnet-bench", "Busy time of each processor in microseconds."), QLatin1String("us"), QString::number(defaults.cost));
+	QCommandLineOption payloadOption(QStringList() << QLatin1String("s") << QLatin1String("payload"),
+		QCoreApplication::translate("designnet-bench", "Output size of each processor in bytes."), QLatin1String("bytes"), QString::number(defaults.payloadBytes));
+	QCommandLineOption iterationOption(QStringList() << QLatin1String("n") << QLatin1String("iterations"),
+		QCoreApplication::translate("designnet-bench", "Measured runs per topology."), QLatin1String("n"), QString::number(defaults.iterations));
+	QCommandLineOption warmupOption(QLatin1String("warmup"),
+		QCoreApplication::translate("designnet-bench", "Unmeasured runs before measuring."), QLatin1String("n"), QString::number(defaults.warmup));
+	QCommandLineOption noLatencyOption(QLatin1String("no-latency"),
+		QCoreApplication::translate("designnet-bench", "Skip the profiled pass that measures the scheduler latency."));
+	QCommandLineOption outputOption(QStringList() << QLatin1String("o") << QLatin1String("output"),
+		QCoreApplication::translate("designnet-bench", "Write the results to <file> (.csv or .json)."), QLatin1String("file"));
+	parser.addOption(topologyOption);
+	parser.addOption(widthOption);
+	parser.addOption(depthOption);
+	parser.addOption(costOption);
+	parser.addOption(payloadOption);
+	parser.addOption(iterationOption);
+	parser.addOption(warmupOption);
+	parser.addOption(noLatencyOption);
+	parser.addOption(outputOption);
+	parser.process(app);
+
+	QTextStream out(stdout);
+	QTextStream err(stderr);
+	DesignNetBench::Options options;
+	options.topologies.clear();
+	foreach (const QString &name, parser.value(topologyOption).split(QLatin1Char(','), QString::SkipEmptyParts))
+	{
+		DesignNetBench::Topology topology;
+		if (!DesignNetBench::topologyFromName(name, &topology))
+		{
+			err << QCoreApplication::translate("designnet-bench", "Unknown topology %1.").arg(name) << endl;
+			return 1;
+		}
+		options.topologies << topology;
+	}
+	if (!intOption(parser, widthOption, 1, &options.width)
+		|| !intOption(parser, depthOption, 1, &options.depth)
+		|| !intOption(parser, payloadOption, 0, &options.payloadBytes)
+		|| !intOption(parser, iterationOption, 1, &options.iterations)
+		|| !intOption(parser, warmupOption, 0, &options.warmup))
+	{
+		err << parser.helpText();
+		return 1;
+	}
+	bool bCostOk = false;
+	options.cost = parser.value(costOption).toLongLong(&bCostOk);
+	if (!bCostOk || options.cost < 0)
+	{
+		err << QCoreApplication::translate("designnet-bench", "Invalid value for --cost: %1 (must be an integer >= 0).").arg(parser.value(costOption)) << endl;
+		err << parser.helpText();
+		return 1;
+	}
+	options.bLatency		= !parser.isSet(noLatencyOption);
+	options.outputFile		= parser.value(outputOption);
+
+	DesignNetBench bench(options);
+	const QList<DesignNetBench::Result> results = bench.run();
+	bench.printResults(results, out);
+	int code = 0;
+	foreach (const DesignNetBench::Result &result, results)
+	{
+		if (result.failures > 0)
+			code = 2;
+	}
+	if (!bench.writeResults(results))
+	{
+		err << bench.errorString() << endl;
+		code = 1;
+	}
+	///
+	/// 没有载入designnet_engine插件，由这里释放执行引擎的单例
+	DesignNet::ProcessorExecutor::Release();
+	DesignNet::ProcessorProfiler::Release();
+	DesignNet::MatBufferPool::Release();
+	return code;
+}
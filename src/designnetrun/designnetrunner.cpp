@@ -0,0 +1,646 @@
+#include "designnetrunner.h"
+#include "app/app_version.h"
+#include "designnet/designnet_engine/data/imagedata.h"
+#include "designnet/designnet_engine/data/matpayload.h"
+#include "designnet/designnet_engine/data/matrixdata.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include "designnet/designnet_engine/designnetbase/port.h"
+#include "designnet/designnet_engine/designnetbase/processor.h"
+#include "designnet/designnet_engine/designnetbase/processorprofiler.h"
+#include "designnet/designnet_engine/designnetbase/replicabatch.h"
+#include "designnet/designnet_engine/designnetbase/resultcache.h"
+#include "designnet/designnet_engine/property/pathdialogproperty.h"
+#include "extensionsystem/pluginmanager.h"
+#include "extensionsystem/pluginspec.h"
+#include "Utils/fileutils.h"
+#include "Utils/XML/binarydeserializer.h"
+#include "Utils/XML/xmlstreamdeserializer.h"
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtAlgorithms>
+
+using namespace DesignNet;
+using namespace ExtensionSystem;
+
+static const char corePluginNameC[] = "Core";					//!< 核心插件的名称
+static const char pluginSpecExtensionC[] = "pluginspec";
+
+/*!
+ * \brief 插件路径，与Totem.exe相同，另外加上命令行指定的路径
+ */
+static QStringList defaultPluginPaths()
+{
+	QStringList rc;
+	QDir rootDir(QCoreApplication::applicationDirPath());
+	rootDir.cdUp();
+	rc.push_back(rootDir.canonicalPath() + QLatin1String("/plugins"));
+	QString pluginPath = QStandardPaths::standardLocations(QStandardPaths::DataLocation).at(0);
+	pluginPath += QLatin1Char('/')
+		+ QLatin1String(Core::Constants::TOTEM_SETTINGSVARIANT_STR)
+		+ QLatin1String("/totem/plugins/")
+		+ QLatin1String(Core::Constants::TOTEM_VERSION_LONG);
+	rc.push_back(pluginPath);
+	return rc;
+}
+
+static QString csvField(const QString &text)
+{
+	if (!text.contains(QLatin1Char(',')) && !text.contains(QLatin1Char('"')) && !text.contains(QLatin1Char('\n')))
+		return text;
+	QString escaped = text;
+	escaped.replace(QLatin1Char('"'), QLatin1String("\"\""));
+	return QLatin1Char('"') + escaped + QLatin1Char('"');
+}
+
+static QString jsonString(const QString &text)
+{
+	QString escaped = text;
+	escaped.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+	escaped.replace(QLatin1Char('"'), QLatin1String("\\\""));
+	escaped.replace(QLatin1Char('\n'), QLatin1String("\\n"));
+	return QLatin1Char('"') + escaped + QLatin1Char('"');
+}
+
+/*!
+ * \brief 在DesignNetSpace的副本上执行输入
+ */
+class DesignNetRunner::Batch : public ReplicaBatch
+{
+public:
+	Batch(DesignNetRunner *runner, const QStringList &inputs)
+		: ReplicaBatch(runner->m_space), m_runner(runner), m_inputs(inputs)
+	{
+	}
+
+protected:
+	bool processInput(DesignNetSpace *replica, int index)
+	{
+		return m_runner->runOnce(replica, index, m_inputs.at(index));
+	}
+
+	DesignNetRunner*	m_runner;
+	QStringList			m_inputs;
+};
+
+DesignNetRunner::Options::Options()
+	: replicas(1),
+	deadline(0),
+	bRecursive(false),
+	bAllPorts(false),
+	bStreaming(false),
+	bIncremental(true),
+	bVerbose(false)
+{
+}
+
+DesignNetRunner::DesignNetRunner(const Options &options, QObject *parent)
+	: QObject(parent),
+	m_options(options),
+	m_space(0),
+	m_inputProperty(0),
+	m_inputProcessorId(-1),
+	m_bPluginsLoaded(false),
+	m_err(stderr)
+{
+}
+
+DesignNetRunner::~DesignNetRunner()
+{
+	shutdown();
+}
+
+bool DesignNetRunner::loadPlugins()
+{
+	QSettings::setPath(QSettings::IniFormat, QSettings::SystemScope,
+		QCoreApplication::applicationDirPath() + QLatin1String(SHARE_PATH));
+	QSettings::setDefaultFormat(QSettings::IniFormat);
+	QSettings *settings = new QSettings(QSettings::IniFormat, QSettings::UserScope,
+		QLatin1String(Core::Constants::TOTEM_SETTINGSVARIANT_STR), QLatin1String("Totem"), this);
+	QSettings *globalSettings = new QSettings(QSettings::IniFormat, QSettings::SystemScope,
+		QLatin1String(Core::Constants::TOTEM_SETTINGSVARIANT_STR), QLatin1String("Totem"), this);
+
+	PluginManager *pm = PluginManager::instance();
+	pm->setHeadless(true);
+	pm->setFileExtension(QLatin1String(pluginSpecExtensionC));
+	pm->setGlobalSettings(globalSettings);
+	pm->setSettings(settings);
+	pm->setPluginPaths(m_options.pluginPaths + defaultPluginPaths());
+
+	PluginSpec *corePlugin = 0;
+	foreach (PluginSpec *spec, pm->plugins())
+	{
+		if (spec->name() == QLatin1String(corePluginNameC))
+		{
+			corePlugin = spec;
+			break;
+		}
+	}
+	if (!corePlugin)
+	{
+		m_errorString = tr("Could not find '%1.pluginspec' in %2")
+			.arg(QLatin1String(corePluginNameC))
+			.arg(QDir::toNativeSeparators(pm->pluginPaths().join(QLatin1String(","))));
+		return false;
+	}
+	pm->loadPluginsAuto();
+	m_bPluginsLoaded = true;
+	if (corePlugin->hasError())
+	{
+		m_errorString = tr("Failed to load plugin %1: %2").arg(corePlugin->name()).arg(corePlugin->errorString());
+		return false;
+	}
+	///
+	/// 其它插件出错时只给出提示，网络中用不到的插件不影响执行
+	foreach (PluginSpec *spec, pm->plugins())
+	{
+		if (spec->hasError())
+			message(tr("Failed to load plugin %1: %2").arg(spec->name()).arg(spec->errorString()));
+	}
+	return true;
+}
+
+bool DesignNetRunner::open()
+{
+	QFileInfo fi(m_options.netFile);
+	if (!fi.isFile())
+	{
+		m_errorString = tr("Cannot open %1.").arg(QDir::toNativeSeparators(m_options.netFile));
+		return false;
+	}
+	m_space = new DesignNetSpace(0, this);
+	m_space->setObjectName(fi.absoluteFilePath());
+	connect(m_space, SIGNAL(logout(QString)), this, SLOT(onLogout(QString)), Qt::DirectConnection);
+	QScopedPointer<Utils::XmlDeserializer> deserializer;
+	if (Utils::BinaryDeserializer::isBinaryFile(fi.absoluteFilePath()))
+	{
+		Utils::BinaryDeserializer *binary = new Utils::BinaryDeserializer(fi.absoluteFilePath());
+		deserializer.reset(binary);
+		if (!binary->isValid())
+		{
+			m_errorString = binary->errorString();
+			return false;
+		}
+	}
+	else
+	{
+		Utils::XmlStreamDeserializer *xml = new Utils::XmlStreamDeserializer(fi.absoluteFilePath());
+		deserializer.reset(xml);
+		if (!xml->isValid())
+		{
+			m_errorString = xml->errorString();
+			return false;
+		}
+	}
+	deserializer->deserialize("DesignNetSpace", *m_space);
+	if (m_space->processors().isEmpty())
+	{
+		m_errorString = tr("%1 does not contain any processor.").arg(QDir::toNativeSeparators(m_options.netFile));
+		return false;
+	}
+	foreach (Processor *processor, m_space->processors())
+		connect(processor, SIGNAL(logout(QString)), this, SLOT(onLogout(QString)), Qt::DirectConnection);
+
+	m_space->setStreamingEnabled(m_options.bStreaming);
+	m_space->setIncrementalEnabled(m_options.bIncremental);
+	m_space->setRunDeadline(m_options.deadline);
+	if (!m_options.cacheDir.isEmpty())
+	{
+		ResultCache::instance()->setDiskDirectory(m_options.cacheDir);
+		m_space->setResultCacheEnabled(true);
+	}
+	if (!m_options.traceFile.isEmpty())
+		ProcessorProfiler::instance()->setEnabled(true);
+	return resolveInputProperty();
+}
+
+/*!
+ * \brief 找到接收输入路径的属性
+ *
+ * 命令行指定时使用"处理器ID:属性ID"，否则使用第一个没有上游处理器、并且有PathDialogProperty的处理器。
+ */
+bool DesignNetRunner::resolveInputProperty()
+{
+	m_inputProperty = 0;
+	m_inputProcessorId = -1;
+	if (m_options.inputs.isEmpty())
+		return true;
+
+	if (!m_options.inputProperty.isEmpty())
+	{
+		const int sep = m_options.inputProperty.indexOf(QLatin1Char(':'));
+		bool bOk = false;
+		const int processorId = m_options.inputProperty.left(sep).toInt(&bOk);
+		Processor *processor = bOk ? m_space->findProcessor(processorId) : 0;
+		if (processor && sep > 0)
+			m_inputProperty = qobject_cast<PathDialogProperty*>(processor->getProperty(m_options.inputProperty.mid(sep + 1)));
+		if (!m_inputProperty)
+		{
+			m_errorString = tr("There is no path property %1 in the designnet space.").arg(m_options.inputProperty);
+			return false;
+		}
+		m_inputProcessorId = processorId;
+		return true;
+	}
+
+	Processor *source = 0;
+	foreach (Processor *processor, m_space->processors())
+	{
+		if (!processor->getInputProcessor().isEmpty())
+			continue;
+		if (source && source->id() < processor->id())
+			continue;
+		foreach (Property *prop, processor->getProperties())
+		{
+			if (PathDialogProperty *pathProperty = qobject_cast<PathDialogProperty*>(prop))
+			{
+				source = processor;
+				m_inputProperty = pathProperty;
+				break;
+			}
+		}
+	}
+	if (!m_inputProperty)
+	{
+		m_errorString = tr("No source processor accepts an input path, use --input-property.");
+		return false;
+	}
+	m_inputProcessorId = source->id();
+	message(tr("Inputs are bound to %1 (id: %2), property %3.")
+		.arg(source->name()).arg(source->id()).arg(m_inputProperty->id()));
+	return true;
+}
+
+QStringList DesignNetRunner::expandInputs() const
+{
+	QStringList files;
+	const QStringList nameFilters = m_inputProperty ? m_inputProperty->nameFilters() : QStringList();
+	foreach (const QString &input, m_options.inputs)
+	{
+		QFileInfo fi(input);
+		if (!fi.isDir())
+		{
+			files << fi.absoluteFilePath();
+			continue;
+		}
+		QStringList dirFiles;
+		QDirIterator it(fi.absoluteFilePath(), nameFilters, QDir::Files,
+			m_options.bRecursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+		while (it.hasNext())
+			dirFiles << it.next();
+		dirFiles.sort();
+		files << dirFiles;
+	}
+	return files;
+}
+
+int DesignNetRunner::run()
+{
+	if (!m_space)
+		return 1;
+	if (!m_options.outputDir.isEmpty() && !QDir().mkpath(m_options.outputDir))
+	{
+		m_errorString = tr("Cannot create the output directory %1.").arg(QDir::toNativeSeparators(m_options.outputDir));
+		return 1;
+	}
+	if (!m_space->prepareProcess())
+	{
+		m_errorString = tr("The designnet space failed to prepare.");
+		return 1;
+	}
+	int failures = 0;
+	if (!m_inputProperty)
+	{
+		///
+		/// 没有输入时按文件中保存的路径执行一次
+		if (!runOnce(m_space, 0, QString()))
+			++failures;
+		return failures;
+	}
+
+	const QStringList inputs = expandInputs();
+	if (inputs.isEmpty())
+	{
+		m_errorString = tr("No input files were found.");
+		return 1;
+	}
+	if (m_options.replicas > 1 && inputs.size() > 1)
+		return runReplicas(inputs);
+	for (int i = 0; i < inputs.size(); ++i)
+	{
+		if (!runOnce(m_space, i, inputs.at(i)))
+			++failures;
+	}
+	return failures;
+}
+
+/*!
+ * \brief 在m_options.replicas个副本上同时执行不同的输入
+ *
+ * 结果按输入的顺序排列，与逐个执行时相同。
+ */
+int DesignNetRunner::runReplicas(const QStringList &inputs)
+{
+	Batch batch(this, inputs);
+	if (!batch.createReplicas(qMin(m_options.replicas, inputs.size())))
+	{
+		m_errorString = tr("Cannot create the replicas of the designnet space.");
+		return 1;
+	}
+	for (int i = 1; i < batch.replicaCount(); ++i)
+	{
+		DesignNetSpace *replica = batch.replica(i);
+		connect(replica, SIGNAL(logout(QString)), this, SLOT(onLogout(QString)), Qt::DirectConnection);
+		foreach (Processor *processor, replica->processors())
+			connect(processor, SIGNAL(logout(QString)), this, SLOT(onLogout(QString)), Qt::DirectConnection);
+	}
+	message(tr("Running %1 replicas.").arg(batch.replicaCount()));
+	const int failures = batch.run(inputs.size());
+	qStableSort(m_runs.begin(), m_runs.end(), inputRunLessThan);
+	return failures;
+}
+
+bool DesignNetRunner::inputRunLessThan(const InputRun &run1, const InputRun &run2)
+{
+	return run1.index < run2.index;
+}
+
+PathDialogProperty *DesignNetRunner::inputPropertyOf(DesignNetSpace *space) const
+{
+	if (space == m_space || !m_inputProperty)
+		return m_inputProperty;
+	Processor *processor = space->findProcessor(m_inputProcessorId);
+	return processor ? qobject_cast<PathDialogProperty*>(processor->getProperty(m_inputProperty->id())) : 0;
+}
+
+bool DesignNetRunner::runOnce(DesignNetSpace *space, int index, const QString &input)
+{
+	if (PathDialogProperty *inputProperty = inputPropertyOf(space))
+	{
+		Utils::Path path;
+		path.m_path = input;
+		path.bRecursion = false;
+		inputProperty->setPaths(QList<Utils::Path>() << path);
+	}
+
+	QHash<int, qint64> lastTime;	//!< 处理器ID -> 累计耗时
+	QHash<int, int> lastCount;		//!< 处理器ID -> 累计执行次数
+	const QList<Processor*> processors = space->processors();
+	foreach (Processor *processor, processors)
+	{
+		lastTime[processor->id()] = processor->executionTime();
+		lastCount[processor->id()] = processor->executionCount();
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	const bool bSucceeded = space->execute();
+	InputRun inputRun;
+	inputRun.index = index;
+	inputRun.input = input;
+	inputRun.bSucceeded = bSucceeded;
+	inputRun.elapsed = timer.nsecsElapsed() / 1000;
+
+	QList<Timing> timings;
+	foreach (Processor *processor, processors)
+	{
+		Timing timing;
+		timing.input = index;
+		timing.processorId = processor->id();
+		timing.processorName = processor->name();
+		timing.processorType = processor->typeID().toString();
+		timing.executions = processor->executionCount() - lastCount.value(processor->id());
+		timing.elapsed = processor->executionTime() - lastTime.value(processor->id());
+		timings << timing;
+	}
+	{
+		QMutexLocker locker(&m_resultMutex);
+		m_runs << inputRun;
+		m_timings << timings;
+	}
+
+	const QString inputName = input.isEmpty() ? QDir::toNativeSeparators(m_options.netFile) : QDir::toNativeSeparators(input);
+	if (!bSucceeded)
+	{
+		if (space->result().m_bCanceled)
+			message(tr("[%1] %2 exceeded the deadline of %3 ms.").arg(index + 1).arg(inputName).arg(m_options.deadline));
+		else
+			message(tr("[%1] %2 failed.").arg(index + 1).arg(inputName));
+		return false;
+	}
+	message(tr("[%1] %2 %3 ms").arg(index + 1).arg(inputName).arg(inputRun.elapsed / 1000.0, 0, 'f', 1));
+	if (!m_options.outputDir.isEmpty())
+		writeOutputs(space, index, input);
+	return true;
+}
+
+/*!
+ * \brief 把输出端口的数据写到"输出目录/序号_输入文件名"下
+ *
+ * 图像和8位矩阵保存为png，其它矩阵保存为yml，数值和字符串追加到输出目录下的values.csv。
+ */
+void DesignNetRunner::writeOutputs(DesignNetSpace *space, int index, const QString &input)
+{
+	QString directory = QString::fromLatin1("%1").arg(index + 1, 4, 10, QLatin1Char('0'));
+	if (!input.isEmpty())
+		directory += QLatin1Char('_') + fileNameOf(QFileInfo(input).completeBaseName());
+	directory = QDir(m_options.outputDir).filePath(directory);
+
+	///
+	/// 图像直接写到各自的目录，数值先收集起来，最后在锁内一次追加到values.csv
+	QString valueLines;
+	QTextStream valueStream(&valueLines);
+	foreach (Processor *processor, space->processors())
+	{
+		if (!m_options.bAllPorts && !processor->getOutputProcessor().isEmpty())
+			continue;
+		foreach (Port *port, processor->getPorts(Port::OUT_PORT))
+		{
+			if (writePort(directory, processor, port))
+				continue;
+			const QVariant &variant = port->data()->variant;
+			if (!variant.isValid() || !variant.canConvert<QString>())
+				continue;
+			valueStream << csvField(input) << ',' << processor->id() << ','
+				<< csvField(processor->name()) << ',' << csvField(port->name()) << ','
+				<< csvField(variant.toString()) << '\n';
+		}
+	}
+	valueStream.flush();
+
+	QMutexLocker locker(&m_resultMutex);
+	QFile values(QDir(m_options.outputDir).filePath(QLatin1String("values.csv")));
+	const bool bNewValues = !values.exists();
+	if (!values.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+		return;
+	QTextStream out(&values);
+	if (bNewValues)
+		out << "input,processor_id,processor,port,value\n";
+	out << valueLines;
+}
+
+bool DesignNetRunner::writePort(const QString &directory, Processor *processor, Port *port)
+{
+	const QVariant &variant = port->data()->variant;
+	cv::Mat mat;
+	if (variant.userType() == qMetaTypeId<MatPayload>())
+		mat = variant.value<MatPayload>().mat();
+	else if (variant.userType() == qMetaTypeId<IData*>())
+	{
+		IData *idata = variant.value<IData*>();
+		if (ImageData *image = qobject_cast<ImageData*>(idata))
+			mat = image->imageData();
+		else if (MatrixData *matrix = qobject_cast<MatrixData*>(idata))
+			mat = matrix->matrix();
+		else
+			return false;
+	}
+	else
+		return false;
+	if (mat.empty())
+		return true;
+
+	QDir().mkpath(directory);
+	const QString baseName = QDir(directory).filePath(QString::fromLatin1("%1-%2-%3")
+		.arg(processor->id()).arg(fileNameOf(processor->name())).arg(fileNameOf(port->name())));
+	const int channels = mat.channels();
+	if (mat.depth() == CV_8U && (channels == 1 || channels == 3 || channels == 4))
+	{
+		const QString fileName = baseName + QLatin1String(".png");
+		if (!cv::imwrite(QFile::encodeName(fileName).constData(), mat))
+			message(tr("Cannot write %1.").arg(QDir::toNativeSeparators(fileName)));
+	}
+	else
+	{
+		const QString fileName = baseName + QLatin1String(".yml");
+		cv::FileStorage fs(QFile::encodeName(fileName).constData(), cv::FileStorage::WRITE);
+		if (fs.isOpened())
+			fs << "data" << mat;
+		else
+			message(tr("Cannot write %1.").arg(QDir::toNativeSeparators(fileName)));
+	}
+	return true;
+}
+
+bool DesignNetRunner::writeTimings()
+{
+	QString fileName = m_options.timingFile;
+	if (fileName.isEmpty())
+	{
+		if (m_options.outputDir.isEmpty())
+			return true;
+		fileName = QDir(m_options.outputDir).filePath(QLatin1String("timings.csv"));
+	}
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+	{
+		m_errorString = tr("Cannot write %1.").arg(QDir::toNativeSeparators(fileName));
+		return false;
+	}
+	QTextStream out(&file);
+	if (fileName.endsWith(QLatin1String(".json"), Qt::CaseInsensitive))
+	{
+		out << "{\n  \"net\": " << jsonString(QFileInfo(m_options.netFile).absoluteFilePath()) << ",\n  \"runs\": [";
+		for (int i = 0; i < m_runs.size(); ++i)
+		{
+			const InputRun &inputRun = m_runs.at(i);
+			out << (i ? "," : "") << "\n    {\"input\": " << jsonString(inputRun.input)
+				<< ", \"succeeded\": " << (inputRun.bSucceeded ? "true" : "false")
+				<< ", \"elapsed_us\": " << inputRun.elapsed << ", \"processors\": [";
+			bool bFirst = true;
+			foreach (const Timing &timing, m_timings)
+			{
+				if (timing.input != i)
+					continue;
+				out << (bFirst ? "" : ",") << "\n      {\"id\": " << timing.processorId
+					<< ", \"name\": " << jsonString(timing.processorName)
+					<< ", \"type\": " << jsonString(timing.processorType)
+					<< ", \"executions\": " << timing.executions
+					<< ", \"elapsed_us\": " << timing.elapsed << "}";
+				bFirst = false;
+			}
+			out << "]}";
+		}
+		out << "\n  ]\n}\n";
+	}
+	else
+	{
+		out << "input,processor_id,processor,type,executions,elapsed_us\n";
+		for (int i = 0; i < m_runs.size(); ++i)
+		{
+			const InputRun &inputRun = m_runs.at(i);
+			out << csvField(inputRun.input) << ",-1,DesignNetSpace,,"
+				<< (inputRun.bSucceeded ? 1 : 0) << ',' << inputRun.elapsed << '\n';
+			foreach (const Timing &timing, m_timings)
+			{
+				if (timing.input != i)
+					continue;
+				out << csvField(inputRun.input) << ',' << timing.processorId << ','
+					<< csvField(timing.processorName) << ',' << csvField(timing.processorType) << ','
+					<< timing.executions << ',' << timing.elapsed << '\n';
+			}
+		}
+	}
+	return true;
+}
+
+bool DesignNetRunner::writeTrace()
+{
+	if (m_options.traceFile.isEmpty())
+		return true;
+	QString errorString;
+	if (!ProcessorProfiler::instance()->exportChromeTrace(m_options.traceFile, &errorString))
+	{
+		m_errorString = tr("Cannot write %1: %2").arg(QDir::toNativeSeparators(m_options.traceFile)).arg(errorString);
+		return false;
+	}
+	return true;
+}
+
+void DesignNetRunner::shutdown()
+{
+	if (m_space)
+	{
+		delete m_space;
+		m_space = 0;
+		m_inputProperty = 0;
+	}
+	if (m_bPluginsLoaded)
+	{
+		PluginManager::instance()->shutdown();
+		m_bPluginsLoaded = false;
+	}
+}
+
+void DesignNetRunner::onLogout(QString log)
+{
+	if (m_options.bVerbose)
+		message(log);
+}
+
+QString DesignNetRunner::fileNameOf(const QString &text)
+{
+	QString name = text;
+	for (int i = 0; i < name.size(); ++i)
+	{
+		const QChar c = name.at(i);
+		if (!c.isLetterOrNumber() && c != QLatin1Char('-') && c != QLatin1Char('_') && c != QLatin1Char('.'))
+			name[i] = QLatin1Char('_');
+	}
+	return name.isEmpty() ? QString(QLatin1String("_")) : name;
+}
+
+void DesignNetRunner::message(const QString &text)
+{
+	QMutexLocker locker(&m_logMutex);
+	m_err << text << endl;
+}
@@ -0,0 +1,112 @@
+#ifndef DESIGNNETRUNNER_H
+#define DESIGNNETRUNNER_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+namespace DesignNet{
+class DesignNetSpace;
+class PathDialogProperty;
+class Processor;
+class Port;
+}
+
+/*!
+ * \brief 无界面执行.designnet文件
+ *
+ * 通过ExtensionSystem::PluginManager以无界面模式载入插件（不创建主窗口和编辑器），
+ * 用DesignNetSpace::deserialize()读取网络，然后对每一个输入文件执行一次：
+ * 输入路径写到源处理器的PathDialogProperty中，执行完成后把末端处理器输出端口的数据
+ * 写到输出目录，并记录每个处理器的执行次数和耗时。
+ */
+class DesignNetRunner : public QObject
+{
+	Q_OBJECT
+public:
+	struct Options
+	{
+		Options();
+		QString		netFile;		//!< .designnet文件
+		QStringList	inputs;			//!< 输入文件或文件夹，文件夹展开为其中的文件
+		QString		inputProperty;	//!< 接收输入路径的属性，格式为"处理器ID:属性ID"，为空时自动选择
+		QString		outputDir;		//!< 输出目录
+		QString		timingFile;		//!< 耗时记录，.json后缀输出JSON，否则输出CSV
+		QString		traceFile;		//!< 不为空时启用ProcessorProfiler，输出Chrome trace-event格式的时间线
+		QString		cacheDir;		//!< 不为空时使用ResultCache，并把结果保存到该目录
+		QStringList	pluginPaths;	//!< 额外的插件路径
+		int			replicas;		//!< 同时处理不同输入的DesignNetSpace副本个数
+		int			deadline;		//!< 每个输入的时间上限，毫秒，超过后停止该输入，0表示不限制
+		bool		bRecursive;		//!< 递归展开输入文件夹
+		bool		bAllPorts;		//!< 输出全部处理器的端口数据，否则只输出末端处理器
+		bool		bStreaming;		//!< 以流水线方式执行
+		bool		bIncremental;	//!< 两次执行之间只重新执行数据已过期的处理器
+		bool		bVerbose;		//!< 输出处理器日志
+	};
+
+	explicit DesignNetRunner(const Options &options, QObject *parent = 0);
+	~DesignNetRunner();
+
+	bool loadPlugins();		//!< 载入插件，失败时返回false
+	bool open();			//!< 读取网络文件
+	int  run();				//!< 执行全部输入，返回失败的次数
+	bool writeTimings();	//!< 写耗时记录
+	bool writeTrace();		//!< 写执行时间线
+	void shutdown();		//!< 释放网络并关闭插件
+
+	QString errorString() const { return m_errorString; }
+
+public slots:
+	void onLogout(QString log);
+
+protected:
+	struct Timing
+	{
+		int		input;			//!< 输入序号
+		int		processorId;
+		QString	processorName;
+		QString	processorType;
+		int		executions;		//!< 本次执行中execute()的次数，0表示复用了之前的结果
+		qint64	elapsed;		//!< 微秒
+	};
+
+	struct InputRun
+	{
+		int		index;			//!< 输入序号
+		QString	input;
+		bool	bSucceeded;
+		qint64	elapsed;		//!< 整个网络的耗时，微秒
+	};
+
+	class Batch;
+
+	QStringList expandInputs() const;
+	bool resolveInputProperty();
+	DesignNet::PathDialogProperty *inputPropertyOf(DesignNet::DesignNetSpace *space) const;
+	int  runReplicas(const QStringList &inputs);
+	bool runOnce(DesignNet::DesignNetSpace *space, int index, const QString &input);
+	void writeOutputs(DesignNet::DesignNetSpace *space, int index, const QString &input);
+	bool writePort(const QString &directory, DesignNet::Processor *processor, DesignNet::Port *port);
+	static QString fileNameOf(const QString &text);
+	static bool inputRunLessThan(const InputRun &run1, const InputRun &run2);
+
+	void message(const QString &text);
+
+	Options							m_options;
+	DesignNet::DesignNetSpace*		m_space;
+	DesignNet::PathDialogProperty*	m_inputProperty;
+	int								m_inputProcessorId;	//!< m_inputProperty所在的处理器，用于在副本中查找
+	QList<Timing>					m_timings;
+	QList<InputRun>					m_runs;
+	QString							m_errorString;
+	bool							m_bPluginsLoaded;
+	QMutex							m_logMutex;		//!< 处理器在工作线程中输出日志
+	QMutex							m_resultMutex;	//!< 多个副本同时记录耗时和写输出
+	QTextStream						m_err;
+};
+
+#endif // DESIGNNETRUNNER_H
@@ -0,0 +1,132 @@
+#include "designnetrunner.h"
+#include <QApplication>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+
+/*!
+ * \brief designnet-run，在命令行中执行.designnet文件
+ *
+ * designnet-run [选项] 网络文件 [输入文件或文件夹...]
+ * 返回值：0表示全部成功，1表示参数、插件或网络文件有错误，2表示部分输入执行失败。
+ */
+int main(int argc, char **argv)
+{
+	///
+	/// 处理器和属性依赖QtWidgets，没有显示设备时使用offscreen平台
+	if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+	QApplication::setApplicationName(QLatin1String("designnet-run"));
+	QApplication::setQuitOnLastWindowClosed(false);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QApplication::translate("designnet-run", "Runs a .designnet file without the user interface."));
+	parser.addHelpOption();
+	parser.addPositionalArgument(QLatin1String("net"), QApplication::translate("designnet-run", "The .designnet file."));
+	parser.addPositionalArgument(QLatin1String("inputs"), QApplication::translate("designnet-run", "Input files or directories, one run per file."), QLatin1String("[inputs...]"));
+	QCommandLineOption listOption(QStringList() << QLatin1String("l") << QLatin1String("input-list"),
+		QApplication::translate("designnet-run", "Read input files from <file>, one per line."), QLatin1String("file"));
+	QCommandLineOption propertyOption(QStringList() << QLatin1String("p") << QLatin1String("input-property"),
+		QApplication::translate("designnet-run", "Bind inputs to the path property <processor id:property id>."), QLatin1String("property"));
+	QCommandLineOption outputOption(QStringList() << QLatin1String("o") << QLatin1String("output"),
+		QApplication::translate("designnet-run", "Write the outputs of the sink processors to <dir>."), QLatin1String("dir"));
+	QCommandLineOption timingOption(QStringList() << QLatin1String("t") << QLatin1String("timings"),
+		QApplication::translate("designnet-run", "Write per-processor timings to <file> (.csv or .json)."), QLatin1String("file"));
+	QCommandLineOption traceOption(QLatin1String("trace"),
+		QApplication::translate("designnet-run", "Write the execution timeline to <file> in the Chrome trace-event format."), QLatin1String("file"));
+	QCommandLineOption cacheOption(QLatin1String("cache"),
+		QApplication::translate("designnet-run", "Reuse results through the result cache stored in <dir>."), QLatin1String("dir"));
+	QCommandLineOption pluginOption(QLatin1String("plugin-path"),
+		QApplication::translate("designnet-run", "Additional plugin directory."), QLatin1String("dir"));
+	QCommandLineOption replicaOption(QStringList() << QLatin1String("j") << QLatin1String("replicas"),
+		QApplication::translate("designnet-run", "Process <n> inputs at the same time on copies of the net."), QLatin1String("n"));
+	QCommandLineOption deadlineOption(QLatin1String("deadline"),
+		QApplication::translate("designnet-run", "Stop processing an input after <ms> milliseconds and count it as failed."), QLatin1String("ms"));
+	QCommandLineOption recursiveOption(QStringList() << QLatin1String("r") << QLatin1String("recursive"),
+		QApplication::translate("designnet-run", "Search input directories recursively."));
+	QCommandLineOption allPortsOption(QLatin1String("all-ports"),
+		QApplication::translate("designnet-run", "Write the outputs of every processor."));
+	QCommandLineOption streamOption(QLatin1String("stream"),
+		QApplication::translate("designnet-run", "Process the inputs in the pipelined streaming mode."));
+	QCommandLineOption fullOption(QLatin1String("no-incremental"),
+		QApplication::translate("designnet-run", "Execute every processor for every input."));
+	QCommandLineOption verboseOption(QStringList() << QLatin1String("v") << QLatin1String("verbose"),
+		QApplication::translate("designnet-run", "Print the processor logs."));
+	parser.addOption(listOption);
+	parser.addOption(propertyOption);
+	parser.addOption(outputOption);
+	parser.addOption(timingOption);
+	parser.addOption(traceOption);
+	parser.addOption(cacheOption);
+	parser.addOption(pluginOption);
+	parser.addOption(replicaOption);
+	parser.addOption(deadlineOption);
+	parser.addOption(recursiveOption);
+	parser.addOption(allPortsOption);
+	parser.addOption(streamOption);
+	parser.addOption(fullOption);
+	parser.addOption(verboseOption);
+	parser.process(app);
+
+	QTextStream err(stderr);
+	QStringList positional = parser.positionalArguments();
+	if (positional.isEmpty())
+	{
+		err << parser.helpText();
+		return 1;
+	}
+
+	DesignNetRunner::Options options;
+	options.netFile = positional.takeFirst();
+	options.inputs = positional;
+	if (parser.isSet(listOption))
+	{
+		QFile list(parser.value(listOption));
+		if (!list.open(QIODevice::ReadOnly | QIODevice::Text))
+		{
+			err << QApplication::translate("designnet-run", "Cannot open %1.").arg(list.fileName()) << endl;
+			return 1;
+		}
+		QTextStream in(&list);
+		while (!in.atEnd())
+		{
+			const QString line = in.readLine().trimmed();
+			if (!line.isEmpty() && !line.startsWith(QLatin1Char('#')))
+				options.inputs << line;
+		}
+	}
+	options.inputProperty	= parser.value(propertyOption);
+	options.outputDir		= parser.value(outputOption);
+	options.timingFile		= parser.value(timingOption);
+	options.traceFile		= parser.value(traceOption);
+	options.cacheDir		= parser.value(cacheOption);
+	options.pluginPaths		= parser.values(pluginOption);
+	options.replicas		= parser.isSet(replicaOption) ? qMax(1, parser.value(replicaOption).toInt()) : 1;
+	options.deadline		= qMax(0, parser.value(deadlineOption).toInt());
+	options.bRecursive		= parser.isSet(recursiveOption);
+	options.bAllPorts		= parser.isSet(allPortsOption);
+	options.bStreaming		= parser.isSet(streamOption);
+	options.bIncremental	= !parser.isSet(fullOption);
+	options.bVerbose		= parser.isSet(verboseOption);
+
+	DesignNetRunner runner(options);
+	if (!runner.loadPlugins() || !runner.open())
+	{
+		err << runner.errorString() << endl;
+		return 1;
+	}
+	const int failures = runner.run();
+	if (!runner.errorString().isEmpty())
+	{
+		err << runner.errorString() << endl;
+		return 1;
+	}
+	if (!runner.writeTimings())
+		err << runner.errorString() << endl;
+	if (!runner.writeTrace())
+		err << runner.errorString() << endl;
+	runner.shutdown();
+	return failures > 0 ? 2 : 0;
+}
@@ -0,0 +1,60 @@
+#include "aggregatetest.h"
+#include "Aggregation/aggregate.h"
+#include <QScopedPointer>
+#include <QtTest/QtTest>
+
+using namespace Aggregation;
+
+BaseComponent::BaseComponent(Aggregate *aggregate)
+{
+	if (aggregate)
+		aggregate->add(this);
+}
+
+void AggregateTest::indexedTypes()
+{
+	QScopedPointer<Aggregate> aggregate(new Aggregate);
+	BaseComponent *base = new BaseComponent;
+	DerivedComponent *derived = new DerivedComponent;
+	aggregate->add(base);
+	aggregate->add(derived);
+
+	QCOMPARE(aggregate->component<DerivedComponent>(), derived);
+	QCOMPARE(aggregate->component<BaseComponent>(), base);
+	QCOMPARE(aggregate->components<BaseComponent>(), QList<BaseComponent*>() << base << derived);
+	QCOMPARE(aggregate->components<QObject>().size(), 2);
+	QVERIFY(!aggregate->component<InterfaceComponent>());
+	QCOMPARE(query<DerivedComponent>(base), derived);
+
+	aggregate->remove(derived);
+	QVERIFY(!aggregate->component<DerivedComponent>());
+	QCOMPARE(aggregate->components<BaseComponent>(), QList<BaseComponent*>() << base);
+	delete derived;
+}
+
+void AggregateTest::interfaceType()
+{
+	QScopedPointer<Aggregate> aggregate(new Aggregate);
+	BaseComponent *base = new BaseComponent;
+	InterfaceComponent *component = new InterfaceComponent;
+	aggregate->add(base);
+	aggregate->add(component);
+
+	AggregateInterface *result = query<AggregateInterface>(base);
+	QVERIFY(result == component);
+	QCOMPARE(result->value(), 7);
+	QCOMPARE(query_all<AggregateInterface>(aggregate.data()).size(), 1);
+	///
+	/// 从同一集合中的其它对象也能找到
+	BaseComponent *other = new BaseComponent(aggregate.data());
+	QVERIFY(query<AggregateInterface>(other) == component);
+}
+
+void AggregateTest::addedInConstructor()
+{
+	QScopedPointer<Aggregate> aggregate(new Aggregate);
+	DerivedComponent *derived = new DerivedComponent(aggregate.data());
+	QCOMPARE(aggregate->component<DerivedComponent>(), derived);
+	QCOMPARE(aggregate->component<BaseComponent>(), static_cast<BaseComponent*>(derived));
+	QCOMPARE(query<DerivedComponent>(aggregate.data()), derived);
+}
@@ -0,0 +1,61 @@
+#ifndef AGGREGATETEST_H
+#define AGGREGATETEST_H
+
+#include <QObject>
+
+namespace Aggregation{
+class Aggregate;
+}
+
+/*!
+ * \brief 只用Q_DECLARE_INTERFACE声明的接口
+ */
+class AggregateInterface
+{
+public:
+	virtual ~AggregateInterface() {}
+	virtual int value() const = 0;
+};
+Q_DECLARE_INTERFACE(AggregateInterface, "com.totem.designnettest.AggregateInterface")
+
+class InterfaceComponent : public QObject, public AggregateInterface
+{
+	Q_OBJECT
+	Q_INTERFACES(AggregateInterface)
+public:
+	virtual int value() const { return 7; }
+};
+
+/*!
+ * \brief 给出\e aggregate 时在构造函数中把自己加入，此时metaObject()还是BaseComponent
+ */
+class BaseComponent : public QObject
+{
+	Q_OBJECT
+public:
+	explicit BaseComponent(Aggregation::Aggregate *aggregate = 0);
+};
+
+class DerivedComponent : public BaseComponent
+{
+	Q_OBJECT
+public:
+	explicit DerivedComponent(Aggregation::Aggregate *aggregate = 0)
+		: BaseComponent(aggregate)
+	{
+	}
+};
+
+/*!
+ * \brief Aggregate按类型索引的查找
+ */
+class AggregateTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void indexedTypes();		//!< 按类型和父类型查找，顺序与添加的顺序相同
+	void interfaceType();		//!< 接口类型逐个qobject_cast
+	void addedInConstructor();	//!< 构造函数中添加的component也能按最终的类型找到
+};
+
+#endif // AGGREGATETEST_H
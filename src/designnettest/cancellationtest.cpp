@@ -0,0 +1,152 @@
+#include "cancellationtest.h"
+#include "testprocessor.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QThread>
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+static const int LONG_DELAY = 5000;	//!< 没有被取消时处理器的执行时间，毫秒
+static const int DEADLINE	= 50;
+
+/*!
+ * \brief 处理器开始执行之后从另一个线程调用DesignNetSpace::cancel()
+ *
+ * execute()开始时会清除取消标记，因此不能在执行之前调用。
+ */
+class CancelThread : public QThread
+{
+public:
+	CancelThread(DesignNetSpace *space, QSemaphore *started)
+		: m_space(space), m_started(started), m_bCanceled(false)
+	{
+	}
+	bool canceled() const { return m_bCanceled; }
+
+protected:
+	void run()
+	{
+		if (!m_started->tryAcquire(1, LONG_DELAY))
+			return;
+		m_space->cancel();
+		m_bCanceled = true;
+	}
+
+	DesignNetSpace*	m_space;
+	QSemaphore*		m_started;
+	bool			m_bCanceled;
+};
+
+/*!
+ * \brief a -> b，a执行LONG_DELAY毫秒，除非被取消
+ */
+class CancelNet
+{
+public:
+	CancelNet()
+		: space(new DesignNetSpace)
+	{
+		space->setIncrementalEnabled(false);
+		a = new TestProcessor(space.data(), space.data());
+		b = new TestProcessor(space.data(), space.data());
+		a->setObjectName(QLatin1String("a"));
+		b->setObjectName(QLatin1String("b"));
+		space->addProcessor(a);
+		space->addProcessor(b);
+		TestProcessor::connect(a, b);
+		a->setDelay(LONG_DELAY);
+	}
+
+	///
+	/// 执行一次，返回execute()的结果，\e msecs 为所用的时间
+	bool execute(qint64 &msecs)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		const bool bSucessed = space->execute();
+		msecs = timer.elapsed();
+		return bSucessed;
+	}
+
+	QScopedPointer<DesignNetSpace> space;
+	TestProcessor *a;
+	TestProcessor *b;
+};
+
+void CancellationTest::cancelRunning()
+{
+	CancelNet net;
+	QSemaphore started;
+	net.a->setStartedSemaphore(&started);
+	CancelThread thread(net.space.data(), &started);
+	thread.start();
+
+	qint64 msecs = 0;
+	QVERIFY(!net.execute(msecs));
+	thread.wait();
+	QVERIFY(thread.canceled());
+	QVERIFY(msecs < LONG_DELAY / 2);
+	QVERIFY(net.a->result().m_bCanceled);
+	QVERIFY(net.space->result().m_bCanceled);
+	QCOMPARE(net.b->executionCount(), 0);
+}
+
+void CancellationTest::runDeadline()
+{
+	CancelNet net;
+	net.space->setRunDeadline(DEADLINE);
+	QCOMPARE(net.space->runDeadline(), DEADLINE);
+
+	qint64 msecs = 0;
+	QVERIFY(!net.execute(msecs));
+	QVERIFY(msecs >= DEADLINE);
+	QVERIFY(msecs < LONG_DELAY / 2);
+	QVERIFY(net.a->result().m_bCanceled);
+	QVERIFY(net.space->result().m_bCanceled);
+	QCOMPARE(net.b->executionCount(), 0);
+}
+
+void CancellationTest::processTimeout()
+{
+	CancelNet net;
+	net.space->setProcessTimeout(DEADLINE);
+	QCOMPARE(net.space->processTimeout(), DEADLINE);
+
+	qint64 msecs = 0;
+	QVERIFY(!net.execute(msecs));
+	QVERIFY(msecs >= DEADLINE);
+	QVERIFY(msecs < LONG_DELAY / 2);
+	QVERIFY(net.a->result().m_bCanceled);
+	QCOMPARE(net.b->executionCount(), 0);
+}
+
+void CancellationTest::runAfterCancel()
+{
+	CancelNet net;
+	QSemaphore started;
+	net.a->setStartedSemaphore(&started);
+	CancelThread thread(net.space.data(), &started);
+	thread.start();
+	qint64 msecs = 0;
+	QVERIFY(!net.execute(msecs));
+	thread.wait();
+
+	net.a->setStartedSemaphore(0);
+	net.a->setDelay(0);
+	QVERIFY(net.execute(msecs));
+	QVERIFY(!net.space->result().m_bCanceled);
+	QCOMPARE(net.b->value(), 2);
+
+	///
+	/// 期限设置之后保持有效，清除之后不再限制
+	net.space->setRunDeadline(DEADLINE);
+	net.a->setDelay(LONG_DELAY);
+	QVERIFY(!net.execute(msecs));
+	net.space->setRunDeadline(0);
+	net.a->setDelay(DEADLINE * 2);
+	QVERIFY(net.execute(msecs));
+	QVERIFY(msecs >= DEADLINE * 2);
+	QCOMPARE(net.b->executionCount(), 2);
+}
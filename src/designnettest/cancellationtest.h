@@ -0,0 +1,19 @@
+#ifndef CANCELLATIONTEST_H
+#define CANCELLATIONTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief DesignNetSpace的取消和执行期限
+ */
+class CancellationTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void cancelRunning();		//!< 执行期间cancel()，正在执行的处理器尽快返回，之后的处理器不再执行
+	void runDeadline();			//!< 超过setRunDeadline()之后与cancel()相同
+	void processTimeout();		//!< 单个处理器的一次执行超过setProcessTimeout()之后停止
+	void runAfterCancel();		//!< 取消之后的下一次执行不受影响
+};
+
+#endif // CANCELLATIONTEST_H
@@ -0,0 +1,108 @@
+#include "coreidtest.h"
+#include "testprocessor.h"
+#include "coreplugin/Common/id.h"
+#include <QSemaphore>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QtTest/QtTest>
+
+/*!
+ * \brief 等待\e gate 之后从\e offset 开始依次创建全部名称的Id
+ *
+ * 各个线程从不同的位置开始，同一时刻既有首次创建的名称，也有其它线程刚刚创建的名称。
+ */
+class IdThread : public QThread
+{
+public:
+	IdThread(QSemaphore *gate, const QStringList &names, int offset)
+		: m_gate(gate), m_names(names), m_iOffset(offset)
+	{
+	}
+	QVector<int> ids() const { return m_ids; }
+	int literal() const { return m_iLiteral; }
+
+protected:
+	void run()
+	{
+		m_gate->acquire();
+		m_ids.resize(m_names.size());
+		for (int i = 0; i < m_names.size(); ++i)
+		{
+			const int index = (i + m_iOffset) % m_names.size();
+			///
+			/// 交替使用两个构造函数，它们查找同一张表
+			m_ids[index] = index % 2 ? Core::Id(m_names.at(index)).uniqueIdentifier()
+				: Core::Id(m_names.at(index).toLatin1().constData()).uniqueIdentifier();
+		}
+		m_iLiteral = CORE_ID("DesignNetTest.Id.Literal").uniqueIdentifier();
+	}
+
+	QSemaphore*		m_gate;
+	QStringList		m_names;
+	int				m_iOffset;
+	QVector<int>	m_ids;
+	int				m_iLiteral;
+};
+
+static QList<IdThread*> runThreads(const QStringList &names, int count)
+{
+	QSemaphore gate;
+	QList<IdThread*> threads;
+	for (int i = 0; i < count; ++i)
+	{
+		threads << new IdThread(&gate, names, i * names.size() / count);
+		threads.last()->start();
+	}
+	gate.release(count);
+	foreach (IdThread *thread, threads)
+		thread->wait();
+	return threads;
+}
+
+void CoreIdTest::concurrentInterning()
+{
+	QStringList names;
+	for (int i = 0; i < 2000; ++i)
+		names << QString::fromLatin1("DesignNetTest.Id.%1").arg(i);
+
+	QList<IdThread*> threads = runThreads(names, 8);
+	const QVector<int> ids = threads.first()->ids();
+	foreach (IdThread *thread, threads)
+		QCOMPARE(thread->ids(), ids);
+	qDeleteAll(threads);
+
+	QSet<int> unique;
+	for (int i = 0; i < names.size(); ++i)
+	{
+		QVERIFY(ids.at(i) != 0);
+		unique.insert(ids.at(i));
+		const Core::Id id = Core::Id::fromUniqueIdentifier(ids.at(i));
+		QCOMPARE(id.toString(), names.at(i));
+		QCOMPARE(Core::Id(names.at(i)), id);
+	}
+	QCOMPARE(unique.size(), names.size());
+}
+
+void CoreIdTest::literalMatchesRuntime()
+{
+	QList<IdThread*> threads = runThreads(QStringList() << QLatin1String("DesignNetTest.Id.Other"), 8);
+	const int literal = Core::Id("DesignNetTest.Id.Literal").uniqueIdentifier();
+	QVERIFY(literal != 0);
+	foreach (IdThread *thread, threads)
+		QCOMPARE(thread->literal(), literal);
+	qDeleteAll(threads);
+	QCOMPARE(CORE_ID("DesignNetTest.Id.Literal"), Core::Id("DesignNetTest.Id.Literal"));
+}
+
+void CoreIdTest::processorTypeId()
+{
+	TestProcessor first;
+	TestProcessor second;
+	const Core::Id expected(QString(first.category() + QLatin1String("/") + first.name()));
+	QCOMPARE(first.typeID(), expected);
+	QCOMPARE(second.typeID(), expected);
+	QCOMPARE(first.DesignNet::Processor::typeID(), expected);
+	QCOMPARE(first.serializableType(), QLatin1String("DesignNetTest/TestProcessor"));
+}
@@ -0,0 +1,18 @@
+#ifndef COREIDTEST_H
+#define COREIDTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief 多个线程同时创建Core::Id
+ */
+class CoreIdTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void concurrentInterning();		//!< 同一个名称在所有线程中得到同一个Id，不同名称的Id不同
+	void literalMatchesRuntime();	//!< CORE_ID()与运行时创建的Id相同
+	void processorTypeId();			//!< DECLEAR_PROCESSOR按类型缓存的typeID()与按名称计算的相同
+};
+
+#endif // COREIDTEST_H
@@ -0,0 +1,118 @@
+#include "executionplantest.h"
+#include "testprocessor.h"
+#include "designnet/designnet_engine/designnetbase/executionplan.h"
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+static QList<int> children(const ExecutionPlan &plan, int index)
+{
+	QList<int> res;
+	for (const int *child = plan.childBegin(index); child != plan.childEnd(index); ++child)
+		res << *child;
+	return res;
+}
+
+static QList<int> inEdgeSources(const ExecutionPlan &plan, int index)
+{
+	QList<int> res;
+	for (const int *edge = plan.inEdgeBegin(index); edge != plan.inEdgeEnd(index); ++edge)
+	{
+		Q_ASSERT(plan.edge(*edge).dst == index);
+		res << plan.edge(*edge).src;
+	}
+	qSort(res);
+	return res;
+}
+
+static Port* outputPort(Processor *processor)
+{
+	return processor->getPorts(Port::OUT_PORT).first();
+}
+
+void ExecutionPlanTest::diamond()
+{
+	TestProcessor a, b, c, d;
+	QVERIFY(TestProcessor::connect(&a, &b));
+	QVERIFY(TestProcessor::connect(&a, &c));
+	QVERIFY(TestProcessor::connect(&b, &d));
+	QVERIFY(TestProcessor::connect(&c, &d));
+
+	ExecutionPlan plan;
+	plan.build(QList<Processor*>() << &a << &b << &c << &d);
+	QCOMPARE(plan.size(), 4);
+	QVERIFY(plan.processor(3) == &d);
+
+	QCOMPARE(plan.parentCount(0), 0);
+	QCOMPARE(plan.parentCount(1), 1);
+	QCOMPARE(plan.parentCount(2), 1);
+	QCOMPARE(plan.parentCount(3), 2);
+	QCOMPARE(plan.childCount(0), 2);
+	QCOMPARE(children(plan, 0), QList<int>() << 1 << 2);
+	QCOMPARE(children(plan, 1), QList<int>() << 3);
+	QCOMPARE(children(plan, 2), QList<int>() << 3);
+	QCOMPARE(plan.childCount(3), 0);
+
+	///
+	/// 输出边按源处理器连续排列
+	QCOMPARE(plan.edgeCount(), 4);
+	QCOMPARE(plan.outEdgeBegin(0), 0);
+	QCOMPARE(plan.outEdgeEnd(0), 2);
+	for (int i = 0; i < plan.size(); i++)
+	{
+		for (int e = plan.outEdgeBegin(i); e < plan.outEdgeEnd(i); e++)
+			QCOMPARE(plan.edge(e).src, i);
+	}
+	QCOMPARE(plan.outEdgeEnd(3), plan.edgeCount());
+	QVERIFY(plan.edge(0).srcPort == outputPort(&a));
+
+	QCOMPARE(inEdgeSources(plan, 0), QList<int>());
+	QCOMPARE(inEdgeSources(plan, 1), QList<int>() << 0);
+	QCOMPARE(inEdgeSources(plan, 3), QList<int>() << 1 << 2);
+
+	///
+	/// d的输入槽冻结为b和c的输出端口
+	QSet<Port*> sources;
+	sources << d.inputSource(0, 0) << d.inputSource(0, 1);
+	QCOMPARE(sources, QSet<Port*>() << outputPort(&b) << outputPort(&c));
+	QVERIFY(d.inputSource(0, 2) == 0);
+	QVERIFY(a.inputSource(0, 0) == 0);
+}
+
+void ExecutionPlanTest::outsideProcessorsIgnored()
+{
+	TestProcessor a, b, outside;
+	QVERIFY(TestProcessor::connect(&a, &b));
+	QVERIFY(TestProcessor::connect(&b, &outside));
+	QVERIFY(TestProcessor::connect(&outside, &a));
+
+	ExecutionPlan plan;
+	plan.build(QList<Processor*>() << &a << &b);
+	QCOMPARE(plan.edgeCount(), 1);
+	QCOMPARE(plan.parentCount(0), 0);
+	QCOMPARE(plan.parentCount(1), 1);
+	QCOMPARE(plan.childCount(1), 0);
+	QCOMPARE(inEdgeSources(plan, 0), QList<int>());
+}
+
+void ExecutionPlanTest::rebuild()
+{
+	TestProcessor a, b, c;
+	QVERIFY(TestProcessor::connect(&a, &b));
+
+	ExecutionPlan plan;
+	plan.build(QList<Processor*>() << &a << &b << &c);
+	const int revision = plan.revision();
+	QCOMPARE(plan.childCount(1), 0);
+
+	QVERIFY(TestProcessor::connect(&b, &c));
+	plan.build(QList<Processor*>() << &a << &b << &c);
+	QCOMPARE(plan.revision(), revision + 1);
+	QCOMPARE(children(plan, 1), QList<int>() << 2);
+	QCOMPARE(plan.parentCount(2), 1);
+	QVERIFY(c.inputSource(0, 0) == outputPort(&b));
+
+	plan.clear();
+	QCOMPARE(plan.size(), 0);
+	QCOMPARE(plan.edgeCount(), 0);
+}
@@ -0,0 +1,18 @@
+#ifndef EXECUTIONPLANTEST_H
+#define EXECUTIONPLANTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief ExecutionPlan的CSR数组和冻结的输入槽
+ */
+class ExecutionPlanTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void diamond();					//!< a -> b, a -> c, b -> d, c -> d的父子关系、边和输入槽
+	void outsideProcessorsIgnored();	//!< 不在计划中的处理器的连接不计入
+	void rebuild();					//!< 连接变化后重新建立，revision()加一
+};
+
+#endif // EXECUTIONPLANTEST_H
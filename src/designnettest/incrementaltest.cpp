@@ -0,0 +1,123 @@
+#include "incrementaltest.h"
+#include "testprocessor.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include "designnet/designnet_engine/property/boolproperty.h"
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+/*!
+ * \brief a -> b -> c，d与其它处理器没有连接
+ */
+class IncrementalNet
+{
+public:
+	IncrementalNet()
+		: space(new DesignNetSpace)
+	{
+		space->setIncrementalEnabled(true);
+		a = add();
+		b = add();
+		c = add();
+		d = add();
+		TestProcessor::connect(a, b);
+		TestProcessor::connect(b, c);
+	}
+
+	QList<int> counts() const
+	{
+		return QList<int>() << a->executionCount() << b->executionCount()
+			<< c->executionCount() << d->executionCount();
+	}
+
+	QScopedPointer<DesignNetSpace> space;
+	TestProcessor *a;
+	TestProcessor *b;
+	TestProcessor *c;
+	TestProcessor *d;
+
+private:
+	TestProcessor* add()
+	{
+		TestProcessor *processor = new TestProcessor(space.data(), space.data());
+		space->addProcessor(processor);
+		return processor;
+	}
+};
+
+void IncrementalTest::defaultDisabled()
+{
+	DesignNetSpace space;
+	QVERIFY(!space.isIncrementalEnabled());
+}
+
+void IncrementalTest::unchangedSkipped()
+{
+	IncrementalNet net;
+	QVERIFY(net.space->isIncrementalEnabled());
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.counts(), QList<int>() << 1 << 1 << 1 << 1);
+	QCOMPARE(net.c->value(), 3);
+
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.counts(), QList<int>() << 1 << 1 << 1 << 1);
+	QVERIFY(!net.c->isDataDirty());
+}
+
+void IncrementalTest::invalidateDownstream()
+{
+	IncrementalNet net;
+	QVERIFY(net.space->execute());
+
+	net.b->setOffset(10);
+	net.b->invalidate();
+	QVERIFY(net.b->isDataDirty());
+	QVERIFY(net.c->isDataDirty());
+	QVERIFY(!net.a->isDataDirty());
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.counts(), QList<int>() << 1 << 2 << 2 << 1);
+	QCOMPARE(net.c->value(), 12);
+	QCOMPARE(net.c->received().last(), 11);
+}
+
+void IncrementalTest::propertyChange()
+{
+	IncrementalNet net;
+	QVERIFY(net.space->execute());
+
+	net.a->option()->setValue(true);
+	QVERIFY(net.a->isDataDirty());
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.counts(), QList<int>() << 2 << 2 << 2 << 1);
+}
+
+/*!
+ * \brief b在执行期间被修改，结束后仍是过期的，下一次执行再执行一次
+ */
+void IncrementalTest::editWhileRunning()
+{
+	IncrementalNet net;
+	QVERIFY(net.space->execute());
+
+	net.b->setInvalidateWhileRunning(true);
+	net.b->invalidate();
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.counts(), QList<int>() << 1 << 2 << 2 << 1);
+	QVERIFY(net.b->isDataDirty());
+
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.counts(), QList<int>() << 1 << 3 << 3 << 1);
+	QVERIFY(!net.b->isDataDirty());
+
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.counts(), QList<int>() << 1 << 3 << 3 << 1);
+}
+
+void IncrementalTest::disabled()
+{
+	IncrementalNet net;
+	net.space->setIncrementalEnabled(false);
+	QVERIFY(net.space->execute());
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.counts(), QList<int>() << 2 << 2 << 2 << 2);
+}
@@ -0,0 +1,21 @@
+#ifndef INCREMENTALTEST_H
+#define INCREMENTALTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief 增量执行只重新执行数据已过期的处理器及其下游
+ */
+class IncrementalTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void defaultDisabled();		//!< 增量执行默认关闭
+	void unchangedSkipped();		//!< 没有修改时第二次执行不执行任何处理器
+	void invalidateDownstream();	//!< invalidate()的处理器和它的下游重新执行，其它处理器不执行
+	void propertyChange();			//!< 修改属性使处理器过期
+	void editWhileRunning();		//!< 执行期间的修改不会被执行结束时清除
+	void disabled();				//!< 关闭增量执行时每次都执行全部处理器
+};
+
+#endif // INCREMENTALTEST_H
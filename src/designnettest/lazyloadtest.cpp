@@ -0,0 +1,114 @@
+#include "lazyloadtest.h"
+#include "testprocessor.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include "Utils/XML/xmlserializablefactory.h"
+#include "Utils/XML/xmlserializer.h"
+#include "Utils/XML/xmldeserializer.h"
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+/*!
+ * \brief 保存source和嵌套的inner(x -> y)之后重新打开
+ *
+ * 打开时最外层的DesignNetSpace直接读取，inner只记录位置。
+ */
+class NestedNet
+{
+public:
+	NestedNet()
+		: space(new DesignNetSpace),
+		inner(0)
+	{
+		DesignNetSpace original;
+		original.setIncrementalEnabled(false);
+		TestProcessor *source = new TestProcessor(&original, &original);
+		original.addProcessor(source);
+		DesignNetSpace *nested = new DesignNetSpace(&original, &original);
+		original.addProcessor(nested);
+		TestProcessor *x = new TestProcessor(nested, nested);
+		TestProcessor *y = new TestProcessor(nested, nested);
+		nested->addProcessor(x);
+		nested->addProcessor(y);
+		TestProcessor::connect(x, y);
+
+		Utils::XmlSerializer s;
+		s.serialize("DesignNetSpace", original);
+		Utils::XmlDeserializer ds(s.document());
+		ds.deserialize("DesignNetSpace", *space);
+		space->setIncrementalEnabled(false);
+		foreach (Processor *processor, space->processors())
+		{
+			processor->setParent(space.data());
+			if (DesignNetSpace *loaded = qobject_cast<DesignNetSpace*>(processor))
+				inner = loaded;
+		}
+	}
+	~NestedNet()
+	{
+		///
+		/// 载入后的处理器没有父对象，随inner一起释放
+		if (inner->isLoaded())
+		{
+			foreach (Processor *processor, inner->processors())
+				processor->setParent(inner);
+		}
+	}
+
+	QList<int> innerValues() const	//!< inner中每个处理器最近一次输出的值，从小到大
+	{
+		QList<int> values;
+		foreach (Processor *processor, inner->processors())
+			values << static_cast<TestProcessor*>(processor)->value();
+		qSort(values);
+		return values;
+	}
+
+	QScopedPointer<DesignNetSpace> space;
+	DesignNetSpace *inner;
+};
+
+void LazyLoadTest::initTestCase()
+{
+	m_processor = new TestProcessor;
+	m_space = new DesignNetSpace;
+	Utils::XmlSerializableFactory::instance()->registerSerializable(m_processor);
+	Utils::XmlSerializableFactory::instance()->registerSerializable(m_space);
+}
+
+void LazyLoadTest::cleanupTestCase()
+{
+	Utils::XmlSerializableFactory::Release();
+	delete m_processor;
+	delete m_space;
+}
+
+void LazyLoadTest::deferredUntilPrepare()
+{
+	NestedNet net;
+	QVERIFY(net.space->isLoaded());
+	QVERIFY(!net.inner->isLoaded());
+
+	QVERIFY(net.space->prepareProcess());
+	QVERIFY(net.inner->isLoaded());
+	QCOMPARE(net.inner->processors().size(), 2);
+	foreach (Processor *processor, net.inner->processors())
+		QVERIFY(static_cast<TestProcessor*>(processor)->creationThread() == thread());
+
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.innerValues(), QList<int>() << 1 << 2);
+}
+
+void LazyLoadTest::loadedBeforeScheduling()
+{
+	NestedNet net;
+	QVERIFY(!net.inner->isLoaded());
+
+	///
+	/// inner在调度器的工作线程中执行，载入必须已经在这之前完成
+	QVERIFY(net.space->execute());
+	QVERIFY(net.inner->isLoaded());
+	foreach (Processor *processor, net.inner->processors())
+		QVERIFY(static_cast<TestProcessor*>(processor)->creationThread() == thread());
+	QCOMPARE(net.innerValues(), QList<int>() << 1 << 2);
+}
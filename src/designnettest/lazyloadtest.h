@@ -0,0 +1,28 @@
+#ifndef LAZYLOADTEST_H
+#define LAZYLOADTEST_H
+
+#include <QObject>
+
+namespace DesignNet{
+class DesignNetSpace;
+}
+class TestProcessor;
+
+/*!
+ * \brief 嵌套DesignNetSpace的延迟载入
+ */
+class LazyLoadTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+	void cleanupTestCase();
+	void deferredUntilPrepare();	//!< 打开时不读取嵌套的处理器，prepareProcess()在所在线程中读取
+	void loadedBeforeScheduling();	//!< 没有调用prepareProcess()直接执行时，也在工作线程执行之前读取
+
+private:
+	TestProcessor*				m_processor;	//!< 在XmlSerializableFactory中注册的原型
+	DesignNet::DesignNetSpace*	m_space;
+};
+
+#endif // LAZYLOADTEST_H
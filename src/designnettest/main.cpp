@@ -0,0 +1,69 @@
+#include "netschedulertest.h"
+#include "processorexecutortest.h"
+#include "streamingtest.h"
+#include "matpayloadtest.h"
+#include "incrementaltest.h"
+#include "resultcachetest.h"
+#include "serializertest.h"
+#include "coreidtest.h"
+#include "cancellationtest.h"
+#include "lazyloadtest.h"
+#include "aggregatetest.h"
+#include "pluginobjecttest.h"
+#include "tiletest.h"
+#include "typedporttest.h"
+#include "executionplantest.h"
+#include "settingsdatabasetest.h"
+#include "plugincachetest.h"
+#include "designnet/designnet_engine/data/matbufferpool.h"
+#include "designnet/designnet_engine/designnetbase/processorexecutor.h"
+#include "designnet/designnet_engine/designnetbase/resultcache.h"
+#include <QCoreApplication>
+#include <QtTest/QtTest>
+
+/*!
+ * \brief designnet-test，DesignNet执行引擎的行为测试
+ *
+ * designnet-test [QTest选项]
+ * 依次执行每个测试类，命令行参数传给QTest::qExec()。
+ * 返回值为有失败的测试类个数，0表示全部通过。
+ */
+int main(int argc, char **argv)
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName(QLatin1String("designnet-test"));
+
+	QList<QObject*> tests;
+	tests << new NetSchedulerTest
+		<< new ProcessorExecutorTest
+		<< new StreamingTest
+		<< new MatPayloadTest
+		<< new IncrementalTest
+		<< new ResultCacheTest
+		<< new SerializerTest
+		<< new CoreIdTest
+		<< new CancellationTest
+		<< new LazyLoadTest
+		<< new AggregateTest
+		<< new PluginObjectTest
+		<< new TileTest
+		<< new TypedPortTest
+		<< new ExecutionPlanTest
+		<< new SettingsDatabaseTest
+		<< new PluginCacheTest;
+
+	int failures = 0;
+	foreach (QObject *test, tests)
+	{
+		if (QTest::qExec(test, argc, argv) != 0)
+			++failures;
+	}
+	qDeleteAll(tests);
+
+	///
+	/// 没有载入designnet_engine插件，由这里释放执行引擎的单例
+	DesignNet::ResultCache::Release();
+	DesignNet::ProcessorExecutor::Release();
+	DesignNet::MatBufferPool::Release();
+	return failures;
+}
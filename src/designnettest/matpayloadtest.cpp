@@ -0,0 +1,102 @@
+#include "matpayloadtest.h"
+#include "designnet/designnet_engine/data/imagedata.h"
+#include "designnet/designnet_engine/data/matpayload.h"
+#include <QScopedPointer>
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+void MatPayloadTest::copySharesBuffer()
+{
+	MatPayload a;
+	a.create(4, 4, CV_8UC1).setTo(cv::Scalar(1));
+	QVERIFY(!a.isShared());
+
+	MatPayload b = a;
+	QVERIFY(a.isShared());
+	QVERIFY(b.isShared());
+	QVERIFY(a.mat().data == b.mat().data);
+	QCOMPARE(b.byteSize(), size_t(16));
+}
+
+void MatPayloadTest::mutableMatDetaches()
+{
+	MatPayload a;
+	a.create(4, 4, CV_8UC1).setTo(cv::Scalar(1));
+	MatPayload b = a;
+
+	b.mutableMat().setTo(cv::Scalar(2));
+	QVERIFY(a.mat().data != b.mat().data);
+	QCOMPARE(int(a.mat().at<uchar>(3, 3)), 1);
+	QCOMPARE(int(b.mat().at<uchar>(3, 3)), 2);
+	QVERIFY(!a.isShared());
+	QVERIFY(!b.isShared());
+
+	///
+	/// 独占的缓冲区直接写入
+	const uchar *data = a.mat().data;
+	a.mutableMat().at<uchar>(0, 0) = 5;
+	QVERIFY(a.mat().data == data);
+	QCOMPARE(int(a.mat().at<uchar>(0, 0)), 5);
+}
+
+void MatPayloadTest::createDetaches()
+{
+	MatPayload a;
+	a.create(4, 4, CV_8UC1).setTo(cv::Scalar(1));
+	MatPayload b = a;
+
+	b.create(4, 4, CV_8UC1).setTo(cv::Scalar(9));
+	QCOMPARE(int(a.mat().at<uchar>(0, 0)), 1);
+	QCOMPARE(int(b.mat().at<uchar>(0, 0)), 9);
+}
+
+void MatPayloadTest::adoptedMatUnchanged()
+{
+	cv::Mat external(2, 2, CV_8UC1, cv::Scalar(3));
+	MatPayload payload(external);
+	QVERIFY(payload.mat().data == external.data);
+	QVERIFY(payload.isShared());
+
+	payload.mutableMat().setTo(cv::Scalar(4));
+	QVERIFY(payload.mat().data != external.data);
+	QCOMPARE(int(external.at<uchar>(1, 1)), 3);
+	QCOMPARE(int(payload.mat().at<uchar>(1, 1)), 4);
+}
+
+void MatPayloadTest::setImageDataCopies()
+{
+	cv::Mat mat(2, 2, CV_8UC1, cv::Scalar(1));
+	ImageData image(ImageData::IMAGE_GRAY);
+	image.setImageData(mat);
+	QVERIFY(image.imageData().data != mat.data);
+
+	mat.setTo(cv::Scalar(7));
+	QCOMPARE(int(image.imageData().at<uchar>(0, 0)), 1);
+}
+
+void MatPayloadTest::imageDataClone()
+{
+	ImageData image(ImageData::IMAGE_GRAY);
+	image.setImageData(cv::Mat(2, 2, CV_8UC1, cv::Scalar(1)));
+	QScopedPointer<IData> copy(image.clone());
+	ImageData *clone = qobject_cast<ImageData*>(copy.data());
+	QVERIFY(clone != 0);
+	QVERIFY(clone->imageData().data == image.imageData().data);
+
+	{
+		ImageDataWriter writer(clone);
+		writer.mat().setTo(cv::Scalar(2));
+	}
+	QCOMPARE(int(image.imageData().at<uchar>(0, 0)), 1);
+	QCOMPARE(int(clone->imageData().at<uchar>(0, 0)), 2);
+
+	///
+	/// 原对象现在独占缓冲区，写入不影响副本
+	{
+		ImageDataWriter writer(&image);
+		writer.mat().setTo(cv::Scalar(3));
+	}
+	QCOMPARE(int(image.imageData().at<uchar>(0, 0)), 3);
+	QCOMPARE(int(clone->imageData().at<uchar>(0, 0)), 2);
+}
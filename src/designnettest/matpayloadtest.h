@@ -0,0 +1,21 @@
+#ifndef MATPAYLOADTEST_H
+#define MATPAYLOADTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief MatPayload和ImageData的写时复制
+ */
+class MatPayloadTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void copySharesBuffer();		//!< 复制只增加引用计数
+	void mutableMatDetaches();		//!< 共享时写入前复制，独占时原地写入
+	void createDetaches();			//!< create()不修改其它对象仍在使用的缓冲区
+	void adoptedMatUnchanged();		//!< 构造时传入的外部cv::Mat不会被写入
+	void setImageDataCopies();		//!< setImageData()之后修改原矩阵不影响ImageData
+	void imageDataClone();			//!< clone()共享缓冲区，写入其中一个不影响另一个
+};
+
+#endif // MATPAYLOADTEST_H
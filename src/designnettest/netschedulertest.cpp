@@ -0,0 +1,121 @@
+#include "netschedulertest.h"
+#include "testprocessor.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+static TestProcessor* addProcessor(DesignNetSpace *space, const char *name, ExecutionLog *log = 0)
+{
+	TestProcessor *processor = new TestProcessor(space, space);
+	processor->setObjectName(QLatin1String(name));
+	processor->setLog(log);
+	space->addProcessor(processor);
+	return processor;
+}
+
+static int indexOf(const ExecutionLog &log, const char *event, const char *name)
+{
+	return log.indexOf(QLatin1String(event) + QLatin1Char(':') + QLatin1String(name));
+}
+
+/*!
+ * \brief 菱形结构a -> b, c -> d，b和c执行时间不同
+ */
+void NetSchedulerTest::dependencyOrder()
+{
+	ExecutionLog log;
+	QScopedPointer<DesignNetSpace> space(new DesignNetSpace);
+	space->setIncrementalEnabled(false);
+	TestProcessor *a = addProcessor(space.data(), "a", &log);
+	TestProcessor *b = addProcessor(space.data(), "b", &log);
+	TestProcessor *c = addProcessor(space.data(), "c", &log);
+	TestProcessor *d = addProcessor(space.data(), "d", &log);
+	b->setDelay(20);
+	c->setDelay(5);
+	QVERIFY(TestProcessor::connect(a, b));
+	QVERIFY(TestProcessor::connect(a, c));
+	QVERIFY(TestProcessor::connect(b, d));
+	QVERIFY(TestProcessor::connect(c, d));
+
+	for (int i = 0; i < 3; ++i)
+	{
+		log.clear();
+		QVERIFY(space->execute());
+		QCOMPARE(log.events().size(), 8);
+		QVERIFY(indexOf(log, "end", "a") < indexOf(log, "begin", "b"));
+		QVERIFY(indexOf(log, "end", "a") < indexOf(log, "begin", "c"));
+		QVERIFY(indexOf(log, "end", "b") < indexOf(log, "begin", "d"));
+		QVERIFY(indexOf(log, "end", "c") < indexOf(log, "begin", "d"));
+	}
+	QCOMPARE(d->executionCount(), 3);
+}
+
+void NetSchedulerTest::dataFlow()
+{
+	QScopedPointer<DesignNetSpace> space(new DesignNetSpace);
+	space->setIncrementalEnabled(false);
+	TestProcessor *a = addProcessor(space.data(), "a");
+	TestProcessor *b = addProcessor(space.data(), "b");
+	TestProcessor *c = addProcessor(space.data(), "c");
+	TestProcessor *d = addProcessor(space.data(), "d");
+	a->setOffset(1);
+	b->setOffset(10);
+	c->setOffset(100);
+	d->setOffset(1000);
+	QVERIFY(TestProcessor::connect(a, b));
+	QVERIFY(TestProcessor::connect(a, c));
+	QVERIFY(TestProcessor::connect(b, d));
+	QVERIFY(TestProcessor::connect(c, d));
+
+	QVERIFY(space->execute());
+	QCOMPARE(b->value(), 11);
+	QCOMPARE(c->value(), 101);
+	QCOMPARE(d->value(), 1112);
+
+	a->setOffset(2);
+	QVERIFY(space->execute());
+	QCOMPARE(d->value(), 1114);
+}
+
+void NetSchedulerTest::failureStopsDescendants()
+{
+	ExecutionLog log;
+	QScopedPointer<DesignNetSpace> space(new DesignNetSpace);
+	space->setIncrementalEnabled(false);
+	TestProcessor *a = addProcessor(space.data(), "a", &log);
+	TestProcessor *b = addProcessor(space.data(), "b", &log);
+	TestProcessor *c = addProcessor(space.data(), "c", &log);
+	QVERIFY(TestProcessor::connect(a, b));
+	QVERIFY(TestProcessor::connect(b, c));
+	b->setFailing(true);
+
+	QVERIFY(!space->execute());
+	QVERIFY(!space->result().m_bSucessed);
+	QVERIFY(!b->result().m_bSucessed);
+	QVERIFY(!b->result().m_bCanceled);
+	QCOMPARE(a->executionCount(), 1);
+	QCOMPARE(b->executionCount(), 1);
+	QCOMPARE(c->executionCount(), 0);
+	QCOMPARE(indexOf(log, "begin", "c"), -1);
+	QVERIFY(b->isDataDirty());
+}
+
+void NetSchedulerTest::failureRecovery()
+{
+	QScopedPointer<DesignNetSpace> space(new DesignNetSpace);
+	space->setIncrementalEnabled(false);
+	TestProcessor *a = addProcessor(space.data(), "a");
+	TestProcessor *b = addProcessor(space.data(), "b");
+	TestProcessor *c = addProcessor(space.data(), "c");
+	QVERIFY(TestProcessor::connect(a, b));
+	QVERIFY(TestProcessor::connect(b, c));
+
+	b->setFailing(true);
+	QVERIFY(!space->execute());
+	b->setFailing(false);
+	QVERIFY(space->execute());
+	QVERIFY(space->result().m_bSucessed);
+	QCOMPARE(c->executionCount(), 1);
+	QCOMPARE(c->value(), 3);
+}
@@ -0,0 +1,19 @@
+#ifndef NETSCHEDULERTEST_H
+#define NETSCHEDULERTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief NetScheduler的执行顺序和失败传递
+ */
+class NetSchedulerTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void dependencyOrder();		//!< 子处理器在全部父处理器完成之后才开始
+	void dataFlow();			//!< 每个处理器读到的是父处理器本次的输出
+	void failureStopsDescendants();	//!< 失败的处理器之后的处理器不再执行，执行返回false
+	void failureRecovery();		//!< 失败之后修正，下一次执行成功
+};
+
+#endif // NETSCHEDULERTEST_H
@@ -0,0 +1,141 @@
+#include "plugincachetest.h"
+#include "extensionsystem/pluginmanager.h"
+#include "extensionsystem/pluginspec.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+using namespace ExtensionSystem;
+
+static const char SPEC_EXTENSION[] = "pluginspec";
+
+static void writeSpec(const QString &fileName, const QString &name, const QString &version,
+					  const QString &dependency = QString())
+{
+	QFile file(fileName);
+	QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+	QString xml = QString::fromLatin1("<plugin name=\"%1\" version=\"%2\" compatVersion=\"1.0.0\">\n"
+		"    <category>PluginCacheTest</category>\n").arg(name, version);
+	if (!dependency.isEmpty())
+	{
+		xml += QString::fromLatin1("    <dependencyList>\n"
+			"        <dependency name=\"%1\" version=\"1.0.0\"/>\n"
+			"    </dependencyList>\n").arg(dependency);
+	}
+	xml += QLatin1String("</plugin>\n");
+	QVERIFY(file.write(xml.toUtf8()) > 0);
+}
+
+///
+/// 文件系统的修改时间可能只精确到秒，修改之前等待使新的修改时间一定不同
+static void waitForNewTimestamp()
+{
+	QTest::qSleep(1100);
+}
+
+void PluginCacheTest::init()
+{
+	m_dir = new QTemporaryDir;
+	QVERIFY(m_dir->isValid());
+	QVERIFY(QDir(m_dir->path()).mkpath(QLatin1String("plugins/sub")));
+	writeSpec(pluginDir() + QLatin1String("/alpha.pluginspec"), QLatin1String("Alpha"), QLatin1String("1.0.0"));
+	writeSpec(pluginDir() + QLatin1String("/sub/beta.pluginspec"), QLatin1String("Beta"), QLatin1String("1.0.0"),
+		QLatin1String("Alpha"));
+}
+
+void PluginCacheTest::cleanup()
+{
+	delete m_dir;
+	m_dir = 0;
+}
+
+QString PluginCacheTest::pluginDir() const
+{
+	return m_dir->path() + QLatin1String("/plugins");
+}
+
+QMap<QString, QString> PluginCacheTest::load(bool *pbBetaResolved) const
+{
+	PluginManager manager;
+	manager.setFileExtension(QLatin1String(SPEC_EXTENSION));
+	manager.setSettings(new QSettings(m_dir->path() + QLatin1String("/settings.ini"), QSettings::IniFormat));
+	manager.setPluginPaths(QStringList() << pluginDir());
+
+	QMap<QString, QString> versions;
+	bool bBetaResolved = false;
+	foreach (PluginSpec *spec, manager.plugins())
+	{
+		versions.insert(spec->name(), spec->version());
+		if (spec->name() == QLatin1String("Beta"))
+		{
+			const QList<PluginSpec*> dependencies = spec->dependencySpecs().values();
+			bBetaResolved = dependencies.size() == 1 && dependencies.first()->name() == QLatin1String("Alpha");
+		}
+	}
+	if (pbBetaResolved)
+		*pbBetaResolved = bBetaResolved;
+	return versions;
+}
+
+qint64 PluginCacheTest::cacheStamp() const
+{
+	const QFileInfoList caches = QDir(m_dir->path()).entryInfoList(QStringList(QLatin1String("plugincache-*.dat")), QDir::Files);
+	if (caches.size() != 1)
+		return -1;
+	return caches.first().lastModified().toMSecsSinceEpoch();
+}
+
+void PluginCacheTest::reusedWhenUnchanged()
+{
+	bool bResolved = false;
+	const QMap<QString, QString> scanned = load(&bResolved);
+	QCOMPARE(QStringList(scanned.keys()), QStringList() << QLatin1String("Alpha") << QLatin1String("Beta"));
+	QVERIFY(bResolved);
+	const qint64 stamp = cacheStamp();
+	QVERIFY(stamp != -1);
+
+	waitForNewTimestamp();
+	bResolved = false;
+	QCOMPARE(load(&bResolved), scanned);
+	QVERIFY(bResolved);
+	QCOMPARE(cacheStamp(), stamp);
+}
+
+void PluginCacheTest::specFileAdded()
+{
+	load();
+	const qint64 stamp = cacheStamp();
+	waitForNewTimestamp();
+	writeSpec(pluginDir() + QLatin1String("/sub/gamma.pluginspec"), QLatin1String("Gamma"), QLatin1String("2.0.0"));
+
+	const QMap<QString, QString> versions = load();
+	QCOMPARE(versions.value(QLatin1String("Gamma")), QString(QLatin1String("2.0.0")));
+	QCOMPARE(versions.size(), 3);
+	QVERIFY(cacheStamp() != stamp);
+}
+
+void PluginCacheTest::specFileChanged()
+{
+	load();
+	waitForNewTimestamp();
+	///
+	/// 版本号长度相同，只有修改时间不同
+	writeSpec(pluginDir() + QLatin1String("/alpha.pluginspec"), QLatin1String("Alpha"), QLatin1String("1.0.1"));
+
+	bool bResolved = false;
+	const QMap<QString, QString> versions = load(&bResolved);
+	QCOMPARE(versions.value(QLatin1String("Alpha")), QString(QLatin1String("1.0.1")));
+	QVERIFY(bResolved);
+}
+
+void PluginCacheTest::specFileRemoved()
+{
+	load();
+	waitForNewTimestamp();
+	QVERIFY(QFile::remove(pluginDir() + QLatin1String("/sub/beta.pluginspec")));
+
+	QCOMPARE(QStringList(load().keys()), QStringList() << QLatin1String("Alpha"));
+}
@@ -0,0 +1,36 @@
+#ifndef PLUGINCACHETEST_H
+#define PLUGINCACHETEST_H
+
+#include <QMap>
+#include <QObject>
+
+QT_BEGIN_NAMESPACE
+class QTemporaryDir;
+QT_END_NAMESPACE
+
+/*!
+ * \brief PluginManager的插件描述缓存
+ *
+ * 每个测试在新的临时目录中建立插件文件夹plugins（Alpha，以及子文件夹sub中依赖Alpha的Beta）
+ * 和设置文件，缓存文件与设置文件在同一个文件夹中。
+ */
+class PluginCacheTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void init();
+	void cleanup();
+	void reusedWhenUnchanged();		//!< 没有变化时从缓存恢复插件和依赖关系，不重写缓存
+	void specFileAdded();			//!< 子文件夹中新增的插件描述文件使缓存失效
+	void specFileChanged();			//!< 修改插件描述文件（大小不变）使缓存失效
+	void specFileRemoved();			//!< 删除插件描述文件使缓存失效
+
+private:
+	QMap<QString, QString> load(bool *pbBetaResolved = 0) const;	//!< 用新的PluginManager读取插件，返回名称 -> 版本
+	qint64 cacheStamp() const;		//!< 缓存文件的修改时间，没有缓存时返回-1
+	QString pluginDir() const;
+
+	QTemporaryDir*	m_dir;
+};
+
+#endif // PLUGINCACHETEST_H
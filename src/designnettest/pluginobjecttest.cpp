@@ -0,0 +1,63 @@
+#include "pluginobjecttest.h"
+#include "aggregatetest.h"
+#include "extensionsystem/pluginmanager.h"
+#include <QScopedPointer>
+#include <QtTest/QtTest>
+
+using namespace ExtensionSystem;
+
+void PluginObjectTest::indexedLookup()
+{
+	PluginManager manager;
+	BaseComponent base;
+	DerivedComponent derived;
+	manager.addObject(&base);
+	QCOMPARE(manager.getObjects<BaseComponent>(), QList<BaseComponent*>() << &base);
+	QVERIFY(manager.getObjects<DerivedComponent>().isEmpty());
+
+	manager.addObject(&derived);
+	QCOMPARE(manager.getObjects<BaseComponent>(), QList<BaseComponent*>() << &base << &derived);
+	QCOMPARE(manager.getObject<DerivedComponent>(), &derived);
+
+	manager.removeObject(&base);
+	QCOMPARE(manager.getObjects<BaseComponent>(), QList<BaseComponent*>() << &derived);
+	manager.removeObject(&derived);
+	QVERIFY(!manager.getObject<BaseComponent>());
+}
+
+void PluginObjectTest::aggregateJoinedLater()
+{
+	PluginManager manager;
+	BaseComponent *anchor = new BaseComponent;
+	manager.addObject(anchor);
+	///
+	/// 先查询一次，InterfaceComponent的索引中没有anchor
+	QVERIFY(manager.getObjects<InterfaceComponent>().isEmpty());
+
+	QScopedPointer<Aggregation::Aggregate> aggregate(new Aggregation::Aggregate);
+	InterfaceComponent *component = new InterfaceComponent;
+	aggregate->add(anchor);
+	aggregate->add(component);
+	QCOMPARE(manager.getObjects<InterfaceComponent>(), QList<InterfaceComponent*>() << component);
+	QCOMPARE(manager.getObject<InterfaceComponent>(), component);
+
+	manager.removeObject(anchor);
+	QVERIFY(manager.getObjects<InterfaceComponent>().isEmpty());
+}
+
+void PluginObjectTest::interfaceLookup()
+{
+	PluginManager manager;
+	InterfaceComponent component;
+	BaseComponent base;
+	manager.addObject(&base);
+	manager.addObject(&component);
+
+	QList<AggregateInterface*> results = manager.getObjects<AggregateInterface>();
+	QCOMPARE(results.size(), 1);
+	QVERIFY(results.first() == &component);
+	QVERIFY(manager.getObject<AggregateInterface>() == &component);
+
+	manager.removeObject(&component);
+	manager.removeObject(&base);
+}
@@ -0,0 +1,18 @@
+#ifndef PLUGINOBJECTTEST_H
+#define PLUGINOBJECTTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief PluginManager对象池按类型的索引
+ */
+class PluginObjectTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void indexedLookup();		//!< addObject()和removeObject()之后按类型查找的结果立即更新
+	void aggregateJoinedLater();	//!< 对象加入对象池之后才加入Aggregate，之前缓存的类型也能找到新的component
+	void interfaceLookup();		//!< 只用Q_DECLARE_INTERFACE声明的接口也能查找
+};
+
+#endif // PLUGINOBJECTTEST_H
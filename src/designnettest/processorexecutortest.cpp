@@ -0,0 +1,120 @@
+#include "processorexecutortest.h"
+#include "testprocessor.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include "designnet/designnet_engine/designnetbase/processorexecutor.h"
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+/*!
+ * \brief 等待\e gate 之后调用ProcessorExecutor::instance()
+ */
+class InstanceThread : public QThread
+{
+public:
+	explicit InstanceThread(QSemaphore *gate) : m_gate(gate), m_executor(0) {}
+	ProcessorExecutor* executor() const { return m_executor; }
+
+protected:
+	void run()
+	{
+		m_gate->acquire();
+		m_executor = ProcessorExecutor::instance();
+	}
+
+	QSemaphore*			m_gate;
+	ProcessorExecutor*	m_executor;
+};
+
+class CountingTask : public QRunnable
+{
+public:
+	explicit CountingTask(QAtomicInt *counter) : m_counter(counter) {}
+	void run() { m_counter->ref(); }
+
+protected:
+	QAtomicInt*	m_counter;
+};
+
+void ProcessorExecutorTest::concurrentInstance()
+{
+	///
+	/// 先释放已有的执行器，使所有线程都走创建的路径
+	ProcessorExecutor::Release();
+
+	const int count = 8;
+	QSemaphore gate;
+	QList<InstanceThread*> threads;
+	for (int i = 0; i < count; ++i)
+	{
+		threads << new InstanceThread(&gate);
+		threads.last()->start();
+	}
+	gate.release(count);
+	foreach (InstanceThread *thread, threads)
+		QVERIFY(thread->wait(10000));
+
+	ProcessorExecutor *executor = ProcessorExecutor::instance();
+	QVERIFY(executor != 0);
+	foreach (InstanceThread *thread, threads)
+		QCOMPARE(thread->executor(), executor);
+	qDeleteAll(threads);
+}
+
+void ProcessorExecutorTest::waitForTask()
+{
+	ProcessorExecutor *executor = ProcessorExecutor::instance();
+	QVERIFY(!executor->isWorkerThread());
+
+	QAtomicInt counter;
+	const int before = executor->completedTasks();
+	executor->start(new CountingTask(&counter));
+	int completed = executor->completedTasks();
+	while (completed == before)
+	{
+		executor->waitForTask(completed);
+		completed = executor->completedTasks();
+	}
+	QCOMPARE(counter.load(), 1);
+	QVERIFY(completed > before);
+}
+
+/*!
+ * \brief 每个嵌套的DesignNetSpace在一个工作线程中等待自己的处理器，个数超过工作线程数
+ */
+void ProcessorExecutorTest::nestedSpaces()
+{
+	QScopedPointer<DesignNetSpace> space(new DesignNetSpace);
+	space->setIncrementalEnabled(false);
+	QList<TestProcessor*> sinks;
+	const int count = ProcessorExecutor::instance()->threadCount() * 2 + 1;
+	for (int i = 0; i < count; ++i)
+	{
+		DesignNetSpace *inner = new DesignNetSpace(space.data(), space.data());
+		inner->setIncrementalEnabled(false);
+		space->addProcessor(inner);
+		Processor *previous = 0;
+		for (int j = 0; j < 3; ++j)
+		{
+			TestProcessor *processor = new TestProcessor(inner, inner);
+			processor->setDelay(2);
+			inner->addProcessor(processor);
+			if (previous)
+				QVERIFY(TestProcessor::connect(previous, processor));
+			previous = processor;
+		}
+		sinks << static_cast<TestProcessor*>(previous);
+	}
+
+	for (int i = 0; i < 2; ++i)
+		QVERIFY(space->execute());
+	foreach (TestProcessor *sink, sinks)
+	{
+		QCOMPARE(sink->executionCount(), 2);
+		QCOMPARE(sink->value(), 3);
+	}
+}
@@ -0,0 +1,18 @@
+#ifndef PROCESSOREXECUTORTEST_H
+#define PROCESSOREXECUTORTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief ProcessorExecutor的单例和等待
+ */
+class ProcessorExecutorTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void concurrentInstance();		//!< 多个线程同时第一次调用instance()得到同一个执行器
+	void waitForTask();				//!< 非工作线程中waitForTask()阻塞到有任务完成
+	void nestedSpaces();			//!< 嵌套的DesignNetSpace多于工作线程时不会死锁
+};
+
+#endif // PROCESSOREXECUTORTEST_H
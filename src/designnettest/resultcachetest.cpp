@@ -0,0 +1,164 @@
+#include "resultcachetest.h"
+#include "testprocessor.h"
+#include "designnet/designnet_engine/data/matpayload.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include "designnet/designnet_engine/designnetbase/resultcache.h"
+#include "designnet/designnet_engine/property/boolproperty.h"
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+/*!
+ * \brief source -> filter -> sink
+ */
+class CacheNet
+{
+public:
+	CacheNet()
+		: space(new DesignNetSpace)
+	{
+		space->setIncrementalEnabled(false);
+		source	= add();
+		filter	= add();
+		sink	= add();
+		source->setOffset(3);
+		TestProcessor::connect(source, filter);
+		TestProcessor::connect(filter, sink);
+	}
+
+	int output(Processor *processor) const
+	{
+		return TestProcessor::valueOf(processor->getPort(Port::OUT_PORT, QLatin1String("output"))->data());
+	}
+
+	QScopedPointer<DesignNetSpace> space;
+	TestProcessor *source;
+	TestProcessor *filter;
+	TestProcessor *sink;
+
+private:
+	TestProcessor* add()
+	{
+		TestProcessor *processor = new TestProcessor(space.data(), space.data());
+		processor->setCacheable(true);
+		space->addProcessor(processor);
+		return processor;
+	}
+};
+
+static ProcessData payloadData(const cv::Mat &mat)
+{
+	ProcessData data(DATATYPE_MATRIX);
+	data.variant.setValue(MatPayload(mat));
+	return data;
+}
+
+void ResultCacheTest::init()
+{
+	ResultCache::instance()->clear();
+}
+
+void ResultCacheTest::keyStability()
+{
+	ResultCache *cache = ResultCache::instance();
+	CacheNet net;
+	QVERIFY(net.space->execute());
+
+	const QByteArray key = cache->key(net.filter);
+	QVERIFY(!key.isEmpty());
+	QCOMPARE(cache->key(net.filter), key);
+	///
+	/// 没有输入的处理器不缓存
+	QVERIFY(cache->key(net.source).isEmpty());
+
+	///
+	/// 另一个相同的网络，处理器的ID和所在的Space不影响键
+	CacheNet other;
+	QVERIFY(other.space->execute());
+	QCOMPARE(cache->key(other.filter), key);
+	QCOMPARE(cache->key(other.sink), cache->key(net.sink));
+
+	net.filter->option()->setValue(true);
+	QVERIFY(cache->key(net.filter) != key);
+	net.filter->option()->setValue(false);
+	QCOMPARE(cache->key(net.filter), key);
+
+	net.source->setOffset(4);
+	QVERIFY(net.space->execute());
+	QVERIFY(cache->key(net.filter) != key);
+}
+
+void ResultCacheTest::payloadHash()
+{
+	cv::Mat big(8, 8, CV_8UC1);
+	for (int r = 0; r < big.rows; ++r)
+	{
+		for (int c = 0; c < big.cols; ++c)
+			big.at<uchar>(r, c) = uchar(r * big.cols + c);
+	}
+	cv::Mat roi = big(cv::Rect(2, 2, 4, 4));
+	cv::Mat copy = roi.clone();
+	QVERIFY(!roi.isContinuous());
+	QVERIFY(copy.isContinuous());
+
+	const QByteArray hash = ResultCache::payloadHash(payloadData(roi));
+	QVERIFY(!hash.isEmpty());
+	QCOMPARE(ResultCache::payloadHash(payloadData(copy)), hash);
+	QCOMPARE(ResultCache::payloadHash(payloadData(roi)), hash);
+
+	copy.at<uchar>(3, 3) += 1;
+	QVERIFY(ResultCache::payloadHash(payloadData(copy)) != hash);
+	QVERIFY(ResultCache::payloadHash(payloadData(roi.clone().reshape(1, 2))) != hash);
+
+	ProcessData five(DATATYPE_INT);
+	five.variant = 5;
+	ProcessData six(DATATYPE_INT);
+	six.variant = 6;
+	QCOMPARE(ResultCache::payloadHash(five), ResultCache::payloadHash(five));
+	QVERIFY(ResultCache::payloadHash(five) != ResultCache::payloadHash(six));
+}
+
+void ResultCacheTest::storeRestore()
+{
+	ResultCache *cache = ResultCache::instance();
+	const ResultCache::Statistics before = cache->statistics();
+	CacheNet net;
+	net.space->setResultCacheEnabled(true);
+
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.filter->executionCount(), 1);
+	QCOMPARE(net.sink->executionCount(), 1);
+	QCOMPARE(cache->statistics().stores - before.stores, qint64(2));
+
+	///
+	/// 源处理器每次都执行，输出相同，下游从缓存恢复
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.source->executionCount(), 2);
+	QCOMPARE(net.filter->executionCount(), 1);
+	QCOMPARE(net.sink->executionCount(), 1);
+	QCOMPARE(cache->statistics().hits - before.hits, qint64(2));
+	QCOMPARE(net.output(net.filter), 4);
+	QCOMPARE(net.output(net.sink), 5);
+
+	net.source->setOffset(10);
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.filter->executionCount(), 2);
+	QCOMPARE(net.sink->executionCount(), 2);
+	QCOMPARE(net.output(net.sink), 12);
+}
+
+void ResultCacheTest::notCacheableByDefault()
+{
+	ResultCache *cache = ResultCache::instance();
+	CacheNet net;
+	net.filter->setCacheable(false);
+	net.space->setResultCacheEnabled(true);
+	QVERIFY(!net.filter->Processor::isCacheable());
+
+	QVERIFY(net.space->execute());
+	QVERIFY(cache->key(net.filter).isEmpty());
+	QVERIFY(!cache->key(net.sink).isEmpty());
+	QVERIFY(net.space->execute());
+	QCOMPARE(net.filter->executionCount(), 2);
+	QCOMPARE(net.sink->executionCount(), 1);
+}
@@ -0,0 +1,20 @@
+#ifndef RESULTCACHETEST_H
+#define RESULTCACHETEST_H
+
+#include <QObject>
+
+/*!
+ * \brief ResultCache的键和命中
+ */
+class ResultCacheTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void init();
+	void keyStability();		//!< 相同的类型、属性和输入得到相同的键，任何一项变化时键变化
+	void payloadHash();			//!< 按内容计算，与矩阵是否连续存储无关
+	void storeRestore();		//!< 命中时不执行process()，输出端口得到相同的数据
+	void notCacheableByDefault();	//!< 没有重载isCacheable()的处理器不缓存
+};
+
+#endif // RESULTCACHETEST_H
@@ -0,0 +1,233 @@
+#include "serializertest.h"
+#include "Utils/XML/binarydeserializer.h"
+#include "Utils/XML/binaryserializer.h"
+#include "Utils/XML/xmlserializable.h"
+#include "Utils/XML/xmlstreamdeserializer.h"
+#include "Utils/XML/xmlstreamserializer.h"
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+/*!
+ * \brief 集合中的元素
+ */
+class SerializerItem : public Utils::XmlSerializable
+{
+public:
+	DECLARE_SERIALIZABLE_NOTYPE(SerializerItem)
+	SerializerItem(int value = 0, const QString &name = QString())
+		: value(value), name(name)
+	{
+	}
+	virtual void serialize(Utils::XmlSerializer &s) const
+	{
+		s.serialize("value", value);
+		s.serialize("name", name);
+	}
+	virtual void deserialize(Utils::XmlDeserializer &s)
+	{
+		s.deserialize("value", value);
+		s.deserialize("name", name);
+	}
+	bool operator==(const SerializerItem &other) const
+	{
+		return value == other.value && name == other.name;
+	}
+
+	int		value;
+	QString	name;
+};
+
+/*!
+ * \brief 包含全部数值类型、二进制数据、子节点和集合
+ *
+ * 数值和字符串在子节点之前写出，XmlStreamSerializer要求这样的顺序。
+ */
+class SerializerSample : public Utils::XmlSerializable
+{
+public:
+	DECLARE_SERIALIZABLE_NOTYPE(SerializerSample)
+	SerializerSample()
+		: iValue(0), bValue(false), fValue(0), dValue(0)
+	{
+	}
+	virtual void serialize(Utils::XmlSerializer &s) const
+	{
+		s.serialize("int", iValue);
+		s.serialize("bool", bValue);
+		s.serialize("float", fValue);
+		s.serialize("double", dValue);
+		s.serialize("text", text);
+		s.serializeBinary("blob", blob);
+		s.serialize("Child", child);
+		s.serialize("Items", items, "Item");
+	}
+	virtual void deserialize(Utils::XmlDeserializer &s)
+	{
+		s.deserialize("int", iValue);
+		s.deserialize("bool", bValue);
+		s.deserialize("float", fValue);
+		s.deserialize("double", dValue);
+		s.deserialize("text", text);
+		s.deserializeBinary("blob", blob);
+		s.deserialize("Child", child);
+		s.deserializeCollection("Items", items, "Item");
+	}
+
+	static SerializerSample create()
+	{
+		SerializerSample sample;
+		sample.iValue	= -42;
+		sample.bValue	= true;
+		sample.fValue	= 3.25f;
+		sample.dValue	= -1.75;
+		///
+		/// 需要转义的字符以及"中文"
+		sample.text		= QString::fromUtf8("a<b>&\"c\" '\xe4\xb8\xad\xe6\x96\x87'");
+		for (int i = 0; i < 256; ++i)
+			sample.blob.append(char(i));
+		sample.child	= SerializerItem(7, QLatin1String("child"));
+		for (int i = 0; i < 3; ++i)
+			sample.items << SerializerItem(i, QString::fromLatin1("item%1").arg(i));
+		return sample;
+	}
+
+	void verify(const SerializerSample &expected) const
+	{
+		QCOMPARE(iValue, expected.iValue);
+		QCOMPARE(bValue, expected.bValue);
+		QCOMPARE(fValue, expected.fValue);
+		QCOMPARE(dValue, expected.dValue);
+		QCOMPARE(text, expected.text);
+		QCOMPARE(blob, expected.blob);
+		QVERIFY(child == expected.child);
+		QCOMPARE(items.size(), expected.items.size());
+		for (int i = 0; i < items.size(); ++i)
+			QVERIFY(items.at(i) == expected.items.at(i));
+	}
+
+	int			iValue;
+	bool		bValue;
+	float		fValue;
+	double		dValue;
+	QString		text;
+	QByteArray	blob;
+	SerializerItem			child;
+	QList<SerializerItem>	items;
+};
+
+void SerializerTest::binaryRoundTrip()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString path = dir.path() + QLatin1String("/sample.dnb");
+	const SerializerSample sample = SerializerSample::create();
+	{
+		Utils::BinarySerializer s(path);
+		s.serialize("Sample", sample);
+		QVERIFY2(s.write(path), qPrintable(s.errorString()));
+	}
+	QVERIFY(Utils::BinaryDeserializer::isBinaryFile(path));
+
+	Utils::BinaryDeserializer d(path);
+	QVERIFY2(d.isValid(), qPrintable(d.errorString()));
+	SerializerSample result;
+	d.deserialize("Sample", result);
+	result.verify(sample);
+}
+
+void SerializerTest::binaryTruncated()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString path = dir.path() + QLatin1String("/sample.dnb");
+	const QString truncatedPath = dir.path() + QLatin1String("/truncated.dnb");
+	{
+		Utils::BinarySerializer s(path);
+		s.serialize("Sample", SerializerSample::create());
+		QVERIFY(s.write(path));
+	}
+	QFile file(path);
+	QVERIFY(file.open(QIODevice::ReadOnly));
+	const QByteArray bytes = file.readAll();
+	QFile truncated(truncatedPath);
+	QVERIFY(truncated.open(QIODevice::WriteOnly));
+	truncated.write(bytes.left(bytes.size() - 16));
+	truncated.close();
+
+	Utils::BinaryDeserializer d(truncatedPath);
+	QVERIFY(!d.isValid());
+	QVERIFY(!d.errorString().isEmpty());
+}
+
+void SerializerTest::streamRoundTrip()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString path = dir.path() + QLatin1String("/sample.xml");
+	const SerializerSample sample = SerializerSample::create();
+	{
+		Utils::XmlStreamSerializer s(path);
+		s.serialize("Sample", sample);
+		QVERIFY2(s.write(), qPrintable(s.errorString()));
+	}
+	QVERIFY(!Utils::BinaryDeserializer::isBinaryFile(path));
+
+	Utils::XmlStreamDeserializer d(path);
+	QVERIFY2(d.isValid(), qPrintable(d.errorString()));
+	SerializerSample result;
+	d.deserialize("Sample", result);
+	result.verify(sample);
+}
+
+void SerializerTest::streamMatchesDom()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString streamPath = dir.path() + QLatin1String("/stream.xml");
+	const QString domPath = dir.path() + QLatin1String("/dom.xml");
+	const SerializerSample sample = SerializerSample::create();
+	{
+		Utils::XmlStreamSerializer s(streamPath);
+		s.serialize("Sample", sample);
+		QVERIFY(s.write());
+	}
+	{
+		Utils::XmlSerializer s(domPath);
+		s.serialize("Sample", sample);
+		QVERIFY(s.write(domPath));
+	}
+
+	{
+		Utils::XmlDeserializer d(streamPath);
+		QVERIFY(d.isValid());
+		SerializerSample result;
+		d.deserialize("Sample", result);
+		result.verify(sample);
+	}
+	{
+		Utils::XmlStreamDeserializer d(domPath);
+		QVERIFY2(d.isValid(), qPrintable(d.errorString()));
+		SerializerSample result;
+		d.deserialize("Sample", result);
+		result.verify(sample);
+	}
+}
+
+void SerializerTest::streamWithoutWrite()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString path = dir.path() + QLatin1String("/sample.xml");
+	const QByteArray original("<Sample int=\"1\"/>");
+	QFile file(path);
+	QVERIFY(file.open(QIODevice::WriteOnly));
+	file.write(original);
+	file.close();
+	{
+		Utils::XmlStreamSerializer s(path);
+		s.serialize("Sample", SerializerSample::create());
+	}
+	QVERIFY(file.open(QIODevice::ReadOnly));
+	QCOMPARE(file.readAll(), original);
+}
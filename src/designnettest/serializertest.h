@@ -0,0 +1,20 @@
+#ifndef SERIALIZERTEST_H
+#define SERIALIZERTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief 序列化格式的往返读写
+ */
+class SerializerTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void binaryRoundTrip();		//!< BinarySerializer写出的文件由BinaryDeserializer读回相同的数据
+	void binaryTruncated();		//!< 被截断的二进制文件不能读取，并给出错误信息
+	void streamRoundTrip();		//!< XmlStreamSerializer写出的文件由XmlStreamDeserializer读回相同的数据
+	void streamMatchesDom();	//!< 流式和DOM两种实现可以互相读取对方写出的文件
+	void streamWithoutWrite();	//!< 没有调用write()时目标文件保持不变
+};
+
+#endif // SERIALIZERTEST_H
@@ -0,0 +1,96 @@
+#include "settingsdatabasetest.h"
+#include "coreplugin/Common/settingsdatabase.h"
+#include <QScopedPointer>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+using namespace Core;
+
+void SettingsDatabaseTest::init()
+{
+	m_dir = new QTemporaryDir;
+	QVERIFY(m_dir->isValid());
+}
+
+void SettingsDatabaseTest::cleanup()
+{
+	delete m_dir;
+	m_dir = 0;
+}
+
+SettingsDatabase* SettingsDatabaseTest::open() const
+{
+	return new SettingsDatabase(m_dir->path(), QLatin1String("settingsdatabasetest"));
+}
+
+void SettingsDatabaseTest::removeThenSetInOneFlush()
+{
+	{
+		QScopedPointer<SettingsDatabase> db(open());
+		db->setValue(QLatin1String("group/old"), 1);
+		db->sync();
+
+		db->remove(QLatin1String("group"));
+		db->setValue(QLatin1String("group/new"), 2);
+		QVERIFY(!db->contains(QLatin1String("group/old")));
+		QCOMPARE(db->value(QLatin1String("group/new")).toInt(), 2);
+		db->sync();
+	}
+	QScopedPointer<SettingsDatabase> db(open());
+	QVERIFY(!db->contains(QLatin1String("group/old")));
+	QVERIFY(db->contains(QLatin1String("group/new")));
+	QCOMPARE(db->value(QLatin1String("group/new")).toInt(), 2);
+}
+
+void SettingsDatabaseTest::setThenRemoveInOneFlush()
+{
+	{
+		QScopedPointer<SettingsDatabase> db(open());
+		db->setValue(QLatin1String("stored"), 1);
+		db->sync();
+
+		db->setValue(QLatin1String("stored"), 2);
+		db->setValue(QLatin1String("pending"), 3);
+		db->remove(QLatin1String("stored"));
+		db->remove(QLatin1String("pending"));
+		QVERIFY(!db->contains(QLatin1String("stored")));
+		QCOMPARE(db->value(QLatin1String("pending"), -1).toInt(), -1);
+		db->sync();
+	}
+	QScopedPointer<SettingsDatabase> db(open());
+	QVERIFY(!db->contains(QLatin1String("stored")));
+	QVERIFY(!db->contains(QLatin1String("pending")));
+}
+
+void SettingsDatabaseTest::removeOnlyMatchesGroup()
+{
+	{
+		QScopedPointer<SettingsDatabase> db(open());
+		db->setValue(QLatin1String("group"), 1);
+		db->setValue(QLatin1String("group/child"), 2);
+		db->setValue(QLatin1String("group2"), 3);
+		db->setValue(QLatin1String("group2/child"), 4);
+		db->sync();
+		db->remove(QLatin1String("group"));
+		db->sync();
+	}
+	QScopedPointer<SettingsDatabase> db(open());
+	QVERIFY(!db->contains(QLatin1String("group")));
+	QVERIFY(!db->contains(QLatin1String("group/child")));
+	QCOMPARE(db->value(QLatin1String("group2")).toInt(), 3);
+	QCOMPARE(db->value(QLatin1String("group2/child")).toInt(), 4);
+}
+
+void SettingsDatabaseTest::destructorFlushes()
+{
+	{
+		QScopedPointer<SettingsDatabase> db(open());
+		db->beginGroup(QLatin1String("group"));
+		db->setValue(QLatin1String("key"), QLatin1String("value"));
+		db->endGroup();
+	}
+	QScopedPointer<SettingsDatabase> db(open());
+	QCOMPARE(db->value(QLatin1String("group/key")).toString(), QLatin1String("value"));
+	db->beginGroup(QLatin1String("group"));
+	QCOMPARE(db->childKeys(), QStringList() << QLatin1String("key"));
+}
@@ -0,0 +1,36 @@
+#ifndef SETTINGSDATABASETEST_H
+#define SETTINGSDATABASETEST_H
+
+#include <QObject>
+
+QT_BEGIN_NAMESPACE
+class QTemporaryDir;
+QT_END_NAMESPACE
+
+namespace Core{
+class SettingsDatabase;
+}
+
+/*!
+ * \brief SettingsDatabase批量写入时remove()和setValue()的顺序
+ *
+ * 每个测试在新的临时目录中打开数据库，关闭后重新打开检查实际写入的内容。
+ */
+class SettingsDatabaseTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void init();
+	void cleanup();
+	void removeThenSetInOneFlush();		//!< 同一次flush()中先remove()再setValue()，新值不会被删除
+	void setThenRemoveInOneFlush();		//!< setValue()之后remove()，写入后数据库中没有该key
+	void removeOnlyMatchesGroup();		//!< remove("group")删除group和group/...，不影响group2
+	void destructorFlushes();			//!< 没有sync()时析构也会写入
+
+private:
+	Core::SettingsDatabase* open() const;	//!< 调用者负责释放，同一时间只能打开一个
+
+	QTemporaryDir*	m_dir;
+};
+
+#endif // SETTINGSDATABASETEST_H
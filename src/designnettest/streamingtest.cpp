@@ -0,0 +1,151 @@
+#include "streamingtest.h"
+#include "testprocessor.h"
+#include "designnet/designnet_engine/data/imagedata.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include <QThread>
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+static const char IMAGE_PORT[] = "image";
+
+/*!
+ * \brief 逐帧输出同一个ImageData，每一帧把帧号写到唯一的像素中
+ */
+class ImageSource : public Processor
+{
+public:
+	DECLEAR_PROCESSOR(ImageSource)
+	explicit ImageSource(DesignNetSpace *space = 0, QObject *parent = 0)
+		: Processor(space, parent), m_image(ImageData::IMAGE_GRAY), m_iFrames(0), m_iFrame(0)
+	{
+		setName(QLatin1String("ImageSource"));
+		addPort(Port::OUT_PORT, DATATYPE_USERTYPE, QLatin1String(IMAGE_PORT));
+	}
+	void setFrames(const int &frames) { m_iFrames = frames; m_iFrame = 0; }
+
+protected:
+	virtual bool process(QFutureInterface<ProcessResult> &future)
+	{
+		{
+			ImageDataWriter writer(&m_image, 1, 1, CV_8UC1);
+			writer.mat().at<uchar>(0, 0) = uchar(m_iFrame);
+		}
+		pushData(&m_image, QLatin1String(IMAGE_PORT));
+		ProcessResult pr;
+		pr.m_bNeedLoop = ++m_iFrame < m_iFrames;
+		future.reportResult(pr, 0);
+		return true;
+	}
+
+	ImageData	m_image;
+	int			m_iFrames;
+	int			m_iFrame;
+};
+
+/*!
+ * \brief 记录每一帧读到的像素值，每帧休眠\e delay 毫秒使上游处理器领先
+ */
+class ImageSink : public Processor
+{
+public:
+	DECLEAR_PROCESSOR(ImageSink)
+	explicit ImageSink(DesignNetSpace *space = 0, QObject *parent = 0)
+		: Processor(space, parent), m_iDelay(0)
+	{
+		setName(QLatin1String("ImageSink"));
+		addPort(Port::IN_PORT, DATATYPE_USERTYPE, QLatin1String(IMAGE_PORT));
+	}
+	void setDelay(const int &msecs) { m_iDelay = msecs; }
+	QList<int> received() const { return m_received; }
+
+protected:
+	virtual bool process(QFutureInterface<ProcessResult> &future)
+	{
+		Q_UNUSED(future);
+		foreach (ProcessData *data, getData(QLatin1String(IMAGE_PORT)))
+		{
+			ImageData *image = qobject_cast<ImageData*>(data->variant.value<IData*>());
+			if (image)
+				m_received << image->imageData().at<uchar>(0, 0);
+		}
+		QThread::msleep(m_iDelay);
+		return true;
+	}
+
+	int			m_iDelay;
+	QList<int>	m_received;
+};
+
+static QList<int> sequence(int begin, int count)
+{
+	QList<int> values;
+	for (int i = 0; i < count; ++i)
+		values << begin + i;
+	return values;
+}
+
+void StreamingTest::payloadFrames()
+{
+	const int frames = 32;
+	QScopedPointer<DesignNetSpace> space(new DesignNetSpace);
+	space->setStreamingEnabled(true);
+	space->setStreamQueueCapacity(2);
+	TestProcessor *source = new TestProcessor(space.data(), space.data());
+	TestProcessor *sink = new TestProcessor(space.data(), space.data());
+	space->addProcessor(source);
+	space->addProcessor(sink);
+	source->setOffset(0);
+	source->setFrames(frames);
+	sink->setOffset(0);
+	sink->setDelay(2);
+	QVERIFY(TestProcessor::connect(source, sink));
+
+	QVERIFY(space->execute());
+	QCOMPARE(source->executionCount(), frames);
+	QCOMPARE(sink->executionCount(), frames);
+	QCOMPARE(sink->received(), sequence(0, frames));
+}
+
+void StreamingTest::constantInput()
+{
+	const int frames = 16;
+	QScopedPointer<DesignNetSpace> space(new DesignNetSpace);
+	space->setStreamingEnabled(true);
+	TestProcessor *source = new TestProcessor(space.data(), space.data());
+	TestProcessor *constant = new TestProcessor(space.data(), space.data());
+	TestProcessor *sink = new TestProcessor(space.data(), space.data());
+	space->addProcessor(source);
+	space->addProcessor(constant);
+	space->addProcessor(sink);
+	source->setOffset(0);
+	source->setFrames(frames);
+	constant->setOffset(100);
+	sink->setOffset(0);
+	QVERIFY(TestProcessor::connect(source, sink));
+	QVERIFY(TestProcessor::connect(constant, sink));
+
+	QVERIFY(space->execute());
+	QCOMPARE(constant->executionCount(), 1);
+	QCOMPARE(sink->received(), sequence(100, frames));
+}
+
+void StreamingTest::inPlaceImageData()
+{
+	const int frames = 32;
+	QScopedPointer<DesignNetSpace> space(new DesignNetSpace);
+	space->setStreamingEnabled(true);
+	space->setStreamQueueCapacity(4);
+	ImageSource *source = new ImageSource(space.data(), space.data());
+	ImageSink *sink = new ImageSink(space.data(), space.data());
+	space->addProcessor(source);
+	space->addProcessor(sink);
+	source->setFrames(frames);
+	sink->setDelay(2);
+	Port *outPort = source->getPort(Port::OUT_PORT, QLatin1String(IMAGE_PORT));
+	Port *inPort = sink->getPort(Port::IN_PORT, QLatin1String(IMAGE_PORT));
+	QVERIFY(outPort->connect(inPort));
+
+	QVERIFY(space->execute());
+	QCOMPARE(sink->received(), sequence(0, frames));
+}
@@ -0,0 +1,18 @@
+#ifndef STREAMINGTEST_H
+#define STREAMINGTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief 流水线执行时每一帧的数据互不影响
+ */
+class StreamingTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void payloadFrames();		//!< 慢的下游处理器按顺序收到每一帧MatPayload
+	void constantInput();		//!< 只执行一次的处理器的输出被每一帧重复使用
+	void inPlaceImageData();	//!< 源处理器原地修改自己的ImageData，下游读到的仍是放入队列时的数据
+};
+
+#endif // STREAMINGTEST_H
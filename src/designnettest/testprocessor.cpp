@@ -0,0 +1,185 @@
+#include "testprocessor.h"
+#include "designnet/designnet_engine/data/matpayload.h"
+#include "designnet/designnet_engine/property/boolproperty.h"
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QThread>
+
+using namespace DesignNet;
+
+static const char INPUT_PORT[]	= "input";
+static const char OUTPUT_PORT[]	= "output";
+
+void ExecutionLog::append(const QString &event)
+{
+	QMutexLocker locker(&m_mutex);
+	m_events << event;
+}
+
+QStringList ExecutionLog::events() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_events;
+}
+
+int ExecutionLog::indexOf(const QString &event) const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_events.indexOf(event);
+}
+
+void ExecutionLog::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	m_events.clear();
+}
+
+TestProcessor::TestProcessor(DesignNetSpace *space, QObject *parent)
+	: Processor(space, parent),
+	m_iOffset(1),
+	m_iFrames(0),
+	m_iFrame(0),
+	m_iDelay(0),
+	m_bFailing(false),
+	m_bInvalidate(false),
+	m_bCacheable(false),
+	m_log(0),
+	m_started(0),
+	m_iValue(0),
+	m_creationThread(QThread::currentThread())
+{
+	setName(QLatin1String("TestProcessor"));
+	addPort(Port::IN_PORT, DATATYPE_MATRIX, QLatin1String(INPUT_PORT));
+	addPort(Port::OUT_PORT, DATATYPE_MATRIX, QLatin1String(OUTPUT_PORT));
+	getPort(Port::IN_PORT, QLatin1String(INPUT_PORT))->setMultiInputSupported(true);
+	m_option = new BoolProperty(QLatin1String("option"), QLatin1String("Option"));
+	addProperty(m_option);
+}
+
+void TestProcessor::setOffset(const int &offset)
+{
+	m_iOffset = offset;
+}
+
+void TestProcessor::setFrames(const int &frames)
+{
+	m_iFrames	= qMax(0, frames);
+	m_iFrame	= 0;
+}
+
+void TestProcessor::setDelay(const int &msecs)
+{
+	m_iDelay = qMax(0, msecs);
+}
+
+void TestProcessor::setFailing(const bool &bFailing)
+{
+	m_bFailing = bFailing;
+}
+
+void TestProcessor::setInvalidateWhileRunning(const bool &bInvalidate)
+{
+	m_bInvalidate = bInvalidate;
+}
+
+void TestProcessor::setCacheable(const bool &bCacheable)
+{
+	m_bCacheable = bCacheable;
+}
+
+void TestProcessor::setLog(ExecutionLog *log)
+{
+	m_log = log;
+}
+
+void TestProcessor::setStartedSemaphore(QSemaphore *semaphore)
+{
+	m_started = semaphore;
+}
+
+QString TestProcessor::category() const
+{
+	return QLatin1String("DesignNetTest");
+}
+
+bool TestProcessor::isCacheable() const
+{
+	return m_bCacheable;
+}
+
+bool TestProcessor::connect(Processor *src, Processor *dst)
+{
+	Port *outPort = src->getPort(Port::OUT_PORT, QLatin1String(OUTPUT_PORT));
+	Port *inPort = dst->getPort(Port::IN_PORT, QLatin1String(INPUT_PORT));
+	return outPort && inPort && outPort->connect(inPort);
+}
+
+int TestProcessor::valueOf(const ProcessData *data)
+{
+	if (!data)
+		return 0;
+	const cv::Mat &mat = data->variant.value<MatPayload>().mat();
+	return mat.empty() ? 0 : mat.at<int>(0, 0);
+}
+
+void TestProcessor::log(const char *event)
+{
+	if (m_log)
+		m_log->append(QLatin1String(event) + QLatin1Char(':') + objectName());
+}
+
+bool TestProcessor::process(QFutureInterface<ProcessResult> &future)
+{
+	log("begin");
+	if (m_started)
+		m_started->release();
+	if (m_bInvalidate)
+	{
+		m_bInvalidate = false;
+		invalidate();
+	}
+
+	int sum = 0;
+	foreach (ProcessData *data, getData(QLatin1String(INPUT_PORT)))
+		sum += valueOf(data);
+	m_received << sum;
+
+	///
+	/// 休眠而不是忙等，取消和期限的测试需要在等待期间及时返回
+	QElapsedTimer timer;
+	timer.start();
+	while (timer.elapsed() < m_iDelay)
+	{
+		if (isCanceled())
+		{
+			log("end");
+			return false;
+		}
+		QThread::msleep(1);
+	}
+	if (m_bFailing)
+	{
+		log("end");
+		return false;
+	}
+
+	if (m_iFrames > 0)
+	{
+		m_iValue = m_iOffset + m_iFrame++;
+		ProcessResult pr;
+		pr.m_bNeedLoop = m_iFrame < m_iFrames;
+		future.reportResult(pr, 0);
+	}
+	else
+		m_iValue = m_iOffset + sum;
+
+	MatPayload payload;
+	payload.create(1, 1, CV_32SC1).at<int>(0, 0) = m_iValue;
+	ProcessData pd(DATATYPE_MATRIX);
+	pd.variant.setValue(payload);
+	pd.processorID = m_id;
+	pushData(pd, QLatin1String(OUTPUT_PORT));
+	log("end");
+	return true;
+}
@@ -0,0 +1,89 @@
+#ifndef TESTPROCESSOR_H
+#define TESTPROCESSOR_H
+
+#include "designnet/designnet_engine/designnetbase/processor.h"
+#include <QList>
+#include <QMutex>
+#include <QStringList>
+
+QT_BEGIN_NAMESPACE
+class QSemaphore;
+class QThread;
+QT_END_NAMESPACE
+
+namespace DesignNet{
+class BoolProperty;
+}
+
+/*!
+ * \brief 记录处理器开始和结束执行的顺序
+ *
+ * 事件为"begin:"或"end:"加上处理器的objectName()，可以在多个工作线程中同时写入。
+ */
+class ExecutionLog
+{
+public:
+	void append(const QString &event);
+	QStringList events() const;
+	int indexOf(const QString &event) const;	//!< 不存在时返回-1
+	void clear();
+
+private:
+	mutable QMutex	m_mutex;
+	QStringList		m_events;
+};
+
+/*!
+ * \brief 行为测试使用的处理器
+ *
+ * 一个支持多输入的输入端口和一个输出端口。输出为1x1的CV_32SC1矩阵（MatPayload），
+ * 值为全部输入之和加上offset()，因此可以从最终的值检查数据是否按连接正确传递。
+ * 可以设置执行时间、失败以及作为流水线的源处理器逐帧输出。
+ */
+class TestProcessor : public DesignNet::Processor
+{
+public:
+	DECLEAR_PROCESSOR(TestProcessor)
+	explicit TestProcessor(DesignNet::DesignNetSpace *space = 0, QObject *parent = 0);
+
+	void setOffset(const int &offset);
+	int  offset() const { return m_iOffset; }
+	void setFrames(const int &frames);		//!< 大于0时作为流水线的源处理器，依次输出offset() + 0 ~ frames - 1
+	void setDelay(const int &msecs);		//!< 每次执行占用的时间，期间定期检查isCanceled()
+	void setFailing(const bool &bFailing);	//!< process()返回false
+	void setInvalidateWhileRunning(const bool &bInvalidate);	//!< 下一次执行期间调用一次invalidate()，模拟执行时的修改
+	void setCacheable(const bool &bCacheable);	//!< isCacheable()的返回值，默认false
+	void setLog(ExecutionLog *log);
+	void setStartedSemaphore(QSemaphore *semaphore);	//!< 每次开始执行时release()一次
+	DesignNet::BoolProperty* option() const { return m_option; }	//!< 不影响输出，用于修改属性
+
+	int value() const { return m_iValue; }			//!< 最近一次输出的值
+	QList<int> received() const { return m_received; }	//!< 每次执行时的输入之和
+	QThread* creationThread() const { return m_creationThread; }	//!< 构造时所在的线程，不随moveToThread()改变
+
+	virtual QString category() const;
+	virtual bool isCacheable() const;
+
+	static bool connect(DesignNet::Processor *src, DesignNet::Processor *dst);	//!< 连接两个TestProcessor
+	static int valueOf(const DesignNet::ProcessData *data);	//!< TestProcessor输出的值，没有数据时返回0
+
+protected:
+	virtual bool process(QFutureInterface<DesignNet::ProcessResult> &future);
+	void log(const char *event);
+
+	int				m_iOffset;
+	int				m_iFrames;
+	int				m_iFrame;		//!< 下一帧的序号
+	int				m_iDelay;
+	bool			m_bFailing;
+	bool			m_bInvalidate;
+	bool			m_bCacheable;
+	ExecutionLog*	m_log;
+	QSemaphore*		m_started;
+	DesignNet::BoolProperty*	m_option;
+	int				m_iValue;
+	QList<int>		m_received;
+	QThread*		m_creationThread;
+};
+
+#endif // TESTPROCESSOR_H
@@ -0,0 +1,88 @@
+#include "tiletest.h"
+#include "designnet/designnet_engine/designnetbase/processor.h"
+#include "opencv2/imgproc/imgproc.hpp"
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+/*!
+ * \brief 分块计算3x3均值滤波的处理器
+ *
+ * 每个分块只使用\e input 中的像素（BORDER_ISOLATED），分块之间的边缘依赖tileHalo()提供的像素。
+ */
+class BlurProcessor : public Processor
+{
+public:
+	DECLEAR_PROCESSOR(BlurProcessor)
+	explicit BlurProcessor(DesignNetSpace *space = 0, QObject *parent = 0)
+		: Processor(space, parent),
+		m_iHalo(1)
+	{
+	}
+
+	void setHalo(const int &halo) { m_iHalo = halo; }
+	int tiles() const { return m_tiles.load(); }	//!< 已经处理的分块数
+	bool filter(const cv::Mat &input, cv::Mat &output)
+	{
+		m_tiles.store(0);
+		output.create(input.rows, input.cols, input.type());
+		return processTiled(input, output);
+	}
+
+	virtual int tileHalo() const { return m_iHalo; }
+
+protected:
+	virtual bool process(QFutureInterface<ProcessResult> &future)
+	{
+		Q_UNUSED(future);
+		return true;
+	}
+	virtual bool processTile(const cv::Mat &input, const cv::Rect &roi, cv::Mat &output)
+	{
+		cv::Mat blurred;
+		cv::blur(input, blurred, cv::Size(3, 3), cv::Point(-1, -1), cv::BORDER_REFLECT_101 | cv::BORDER_ISOLATED);
+		blurred(roi).copyTo(output);
+		m_tiles.fetchAndAddOrdered(1);
+		return true;
+	}
+
+	int			m_iHalo;
+	QAtomicInt	m_tiles;
+};
+
+///
+/// 行数不是分块行数的整数倍，最后一块较小
+static cv::Mat testImage()
+{
+	cv::Mat image(1000, 256, CV_8UC1);
+	cv::RNG rng(12345);
+	rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+	return image;
+}
+
+void TileTest::edgesMatchUntiled()
+{
+	const cv::Mat image = testImage();
+	cv::Mat expected;
+	cv::blur(image, expected, cv::Size(3, 3));
+
+	BlurProcessor processor;
+	cv::Mat tiled;
+	QVERIFY(processor.filter(image, tiled));
+	QVERIFY(processor.tiles() > 1);
+	QCOMPARE(cv::norm(expected, tiled, cv::NORM_INF), 0.0);
+}
+
+void TileTest::notTileable()
+{
+	const cv::Mat image = testImage();
+	cv::Mat expected;
+	cv::blur(image, expected, cv::Size(3, 3));
+
+	BlurProcessor processor;
+	processor.setHalo(-1);
+	cv::Mat output;
+	QVERIFY(processor.filter(image, output));
+	QCOMPARE(processor.tiles(), 1);
+	QCOMPARE(cv::norm(expected, output, cv::NORM_INF), 0.0);
+}
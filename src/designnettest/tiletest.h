@@ -0,0 +1,17 @@
+#ifndef TILETEST_H
+#define TILETEST_H
+
+#include <QObject>
+
+/*!
+ * \brief Processor::processTiled()的分块并行处理
+ */
+class TileTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void edgesMatchUntiled();	//!< 3x3均值滤波分块处理的结果与整幅图像处理相同，包括分块的边缘
+	void notTileable();			//!< tileHalo()小于0时整幅图像作为一个分块处理
+};
+
+#endif // TILETEST_H
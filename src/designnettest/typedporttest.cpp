@@ -0,0 +1,223 @@
+#include "typedporttest.h"
+#include "designnet/designnet_engine/data/matpayload.h"
+#include "designnet/designnet_engine/designnetbase/designnetspace.h"
+#include "designnet/designnet_engine/designnetbase/typedport.h"
+#include <QPointF>
+#include <QtTest/QtTest>
+
+using namespace DesignNet;
+
+/*!
+ * \brief 输出offset()的整数
+ */
+class IntSource : public Processor
+{
+public:
+	DECLEAR_PROCESSOR(IntSource)
+	explicit IntSource(DesignNetSpace *space = 0, QObject *parent = 0)
+		: Processor(space, parent),
+		m_value(this, QLatin1String("Value")),
+		m_iOffset(0)
+	{
+	}
+	void setOffset(const int &offset) { m_iOffset = offset; }
+
+	OutputPort<int>	m_value;
+
+protected:
+	virtual bool process(QFutureInterface<ProcessResult> &future)
+	{
+		Q_UNUSED(future);
+		m_value.push(m_iOffset);
+		return true;
+	}
+
+	int m_iOffset;
+};
+
+/*!
+ * \brief 全部输入的均值，标量处理器使用静态类型端口的写法
+ */
+class MeanProcessor : public Processor
+{
+public:
+	DECLEAR_PROCESSOR(MeanProcessor)
+	explicit MeanProcessor(DesignNetSpace *space = 0, QObject *parent = 0)
+		: Processor(space, parent),
+		m_values(this, QLatin1String("Values"), true),
+		m_mean(this, QLatin1String("Mean"))
+	{
+	}
+
+	InputPort<int>		m_values;
+	OutputPort<double>	m_mean;
+
+protected:
+	virtual bool process(QFutureInterface<ProcessResult> &future)
+	{
+		Q_UNUSED(future);
+		const int count = m_values.count();
+		if (count == 0)
+			return false;
+		double sum = 0;
+		for (int i = 0; i < count; ++i)
+			sum += m_values.valueOr(0, i);
+		m_mean.push(sum / count);
+		return true;
+	}
+};
+
+/*!
+ * \brief 记录读到的double
+ */
+class DoubleSink : public Processor
+{
+public:
+	DECLEAR_PROCESSOR(DoubleSink)
+	explicit DoubleSink(DesignNetSpace *space = 0, QObject *parent = 0)
+		: Processor(space, parent),
+		m_value(this, QLatin1String("Value")),
+		m_dReceived(-1)
+	{
+	}
+	double received() const { return m_dReceived; }
+
+	InputPort<double>	m_value;
+
+protected:
+	virtual bool process(QFutureInterface<ProcessResult> &future)
+	{
+		Q_UNUSED(future);
+		m_dReceived = m_value.valueOr(-1);
+		return true;
+	}
+
+	double m_dReceived;
+};
+
+/*!
+ * \brief 没有特化PortTypeTraits的类型，端口为DATATYPE_USERTYPE
+ */
+class PointProcessor : public Processor
+{
+public:
+	DECLEAR_PROCESSOR(PointProcessor)
+	explicit PointProcessor(DesignNetSpace *space = 0, QObject *parent = 0)
+		: Processor(space, parent),
+		m_input(this, QLatin1String("Input")),
+		m_output(this, QLatin1String("Output"))
+	{
+	}
+
+	InputPort<QPointF>	m_input;
+	OutputPort<QPointF>	m_output;
+
+protected:
+	virtual bool process(QFutureInterface<ProcessResult> &future)
+	{
+		Q_UNUSED(future);
+		return true;
+	}
+};
+
+/*!
+ * \brief 未声明C++类型的端口
+ */
+class UntypedProcessor : public Processor
+{
+public:
+	DECLEAR_PROCESSOR(UntypedProcessor)
+	explicit UntypedProcessor(DesignNetSpace *space = 0, QObject *parent = 0)
+		: Processor(space, parent)
+	{
+		addPort(Port::IN_PORT, DATATYPE_USERTYPE, QLatin1String("UserIn"));
+		addPort(Port::OUT_PORT, DATATYPE_USERTYPE, QLatin1String("UserOut"));
+		addPort(Port::IN_PORT, DATATYPE_INT, QLatin1String("IntIn"));
+		addPort(Port::IN_PORT, DATATYPE_DOUBLE, QLatin1String("DoubleIn"));
+	}
+	Port* in(const char *label) { return getPort(Port::IN_PORT, QLatin1String(label)); }
+	Port* out(const char *label) { return getPort(Port::OUT_PORT, QLatin1String(label)); }
+
+protected:
+	virtual bool process(QFutureInterface<ProcessResult> &future)
+	{
+		Q_UNUSED(future);
+		return true;
+	}
+};
+
+void TypedPortTest::typedConnections()
+{
+	IntSource source;
+	MeanProcessor mean;
+	DoubleSink sink;
+	PointProcessor point;
+
+	QVERIFY(source.m_value.port()->canConnectTo(mean.m_values.port()));
+	QVERIFY(source.m_value.port()->canConnectTo(sink.m_value.port()));	//!< int可以转换为double
+	QVERIFY(mean.m_mean.port()->canConnectTo(sink.m_value.port()));
+	QVERIFY(!mean.m_mean.port()->canConnectTo(mean.m_values.port()));	//!< double不能作为int读取
+	QVERIFY(!point.m_output.port()->canConnectTo(sink.m_value.port()));
+	QVERIFY(!source.m_value.port()->canConnectTo(point.m_input.port()));
+	QVERIFY(point.m_output.port()->canConnectTo(point.m_input.port()));
+}
+
+void TypedPortTest::mixedConnections()
+{
+	IntSource source;
+	MeanProcessor mean;
+	DoubleSink sink;
+	PointProcessor point;
+	UntypedProcessor untyped;
+
+	QVERIFY(!mean.m_mean.port()->canConnectTo(untyped.in("UserIn")));
+	QVERIFY(!point.m_output.port()->canConnectTo(untyped.in("UserIn")));
+	QVERIFY(!untyped.out("UserOut")->canConnectTo(point.m_input.port()));
+	QVERIFY(!untyped.out("UserOut")->canConnectTo(sink.m_value.port()));
+
+	QVERIFY(source.m_value.port()->canConnectTo(untyped.in("IntIn")));
+	QVERIFY(mean.m_mean.port()->canConnectTo(untyped.in("DoubleIn")));
+	QVERIFY(!mean.m_mean.port()->canConnectTo(untyped.in("IntIn")));
+}
+
+void TypedPortTest::scalarNet()
+{
+	DesignNetSpace space;
+	space.setIncrementalEnabled(false);
+	IntSource *two = new IntSource(&space, &space);
+	IntSource *five = new IntSource(&space, &space);
+	MeanProcessor *mean = new MeanProcessor(&space, &space);
+	DoubleSink *meanSink = new DoubleSink(&space, &space);
+	DoubleSink *intSink = new DoubleSink(&space, &space);
+	two->setOffset(2);
+	five->setOffset(5);
+	space.addProcessor(two);
+	space.addProcessor(five);
+	space.addProcessor(mean);
+	space.addProcessor(meanSink);
+	space.addProcessor(intSink);
+	QVERIFY(two->m_value.port()->connect(mean->m_values.port()));
+	QVERIFY(five->m_value.port()->connect(mean->m_values.port()));
+	QVERIFY(mean->m_mean.port()->connect(meanSink->m_value.port()));
+	QVERIFY(five->m_value.port()->connect(intSink->m_value.port()));
+
+	QVERIFY(space.execute());
+	QCOMPARE(meanSink->received(), 3.5);
+	QCOMPARE(intSink->received(), 5.0);
+}
+
+void TypedPortTest::unconvertibleDataClears()
+{
+	IntSource source;
+	source.m_value.push(5);
+	QCOMPARE(source.m_value.value(), 5);
+
+	ProcessData data(DATATYPE_INT);
+	data.variant = QVariant::fromValue(MatPayload());
+	source.m_value.port()->addData(&data);
+	QCOMPARE(source.m_value.value(), 0);
+
+	data.variant = QVariant(7);
+	source.m_value.port()->addData(&data);
+	QCOMPARE(source.m_value.value(), 7);
+}
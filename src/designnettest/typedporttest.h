@@ -0,0 +1,19 @@
+#ifndef TYPEDPORTTEST_H
+#define TYPEDPORTTEST_H
+
+#include <QObject>
+
+/*!
+ * \brief InputPort<T>/OutputPort<T>静态类型端口
+ */
+class TypedPortTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void typedConnections();		//!< 两端都声明类型时按类型表连接
+	void mixedConnections();		//!< 只有一端声明类型时DATATYPE_USERTYPE不能连接，其它类型按DataType连接
+	void scalarNet();				//!< int经过均值处理器输出double，下游直接读取或者转换类型
+	void unconvertibleDataClears();	//!< addData()的数据不能转换为端口的类型时清空上一次的数据
+};
+
+#endif // TYPEDPORTTEST_H
@@ -114,6 +114,8 @@
 
 using namespace Aggregation;
 
+static QBasicAtomicInt s_generation = Q_BASIC_ATOMIC_INITIALIZER(0);  //!< ֻʹþ̬ʼ
+
 /*!
     \fn Aggregate *Aggregate::parentAggregate(QObject *obj)
 
@@ -141,6 +143,16 @@ QReadWriteLock &Aggregate::lock()
     return lock;
 }
 
+/*!
+    \fn int Aggregate::generation()
+
+    ÿcomponent뿪κһAggregateʱı䣬߱ȽǰεֵжϻǷڡ
+*/
+int Aggregate::generation()
+{
+    return s_generation.loadAcquire();
+}
+
 /*!
     \fn Aggregate::Aggregate(QObject *parent)
 
@@ -172,7 +184,9 @@ Aggregate::~Aggregate()
     }
     qDeleteAll(m_components);
     m_components.clear();
+    m_index.clear();
     aggregateMap().remove(this);
+    s_generation.fetchAndAddOrdered(1);
 }
 
 void Aggregate::deleteSelf(QObject *obj)
@@ -181,15 +195,37 @@ void Aggregate::deleteSelf(QObject *obj)
         QWriteLocker locker(&lock());
         aggregateMap().remove(obj);
         m_components.removeAll(obj);
+        removeFromIndex(obj);
+        s_generation.fetchAndAddOrdered(1);
     }
     delete this;
 }
 
+/*!
+    \fn void Aggregate::removeFromIndex(QObject *component)
+    \internal
+
+    m_indexƳ\a componentʱmetaObject()ѾԭͣԱȫ͡
+*/
+void Aggregate::removeFromIndex(QObject *component)
+{
+    QHash<const QMetaObject *, QList<QObject *> >::iterator it = m_index.begin();
+    while (it != m_index.end())
+    {
+        it.value().removeAll(component);
+        if (it.value().isEmpty())
+            it = m_index.erase(it);
+        else
+            ++it;
+    }
+}
+
 /*!
     \fn void Aggregate::add(QObject *component)
 
      \a component  aggregate.
     ӱAggregatecomponentҲAggregate͵Ķ
+    \a component ҪѾɣʱmetaObject()
 
     \sa Aggregate::remove()
 */
@@ -208,9 +244,14 @@ void Aggregate::add(QObject *component)
             return;
         }
         m_components.append(component);
+        ///
+        /// ͼȫཨcomponent<T>()Ҫqobject_cast
+        for (const QMetaObject *meta = component->metaObject(); meta; meta = meta->superClass())
+            m_index[meta].append(component);
         if(m_autoDelete)/// ԶɾҪź
             connect(component, SIGNAL(destroyed(QObject*)), this, SLOT(deleteSelf(QObject*)));
         aggregateMap().insert(component, this);
+        s_generation.fetchAndAddOrdered(1);
     }
     emit changed();
 }
@@ -230,6 +271,8 @@ void Aggregate::remove(QObject *component)
         QWriteLocker locker(&lock());
         aggregateMap().remove(component);
         m_components.removeAll(component);
+        removeFromIndex(component);
+        s_generation.fetchAndAddOrdered(1);
         if(m_autoDelete)
             disconnect(component, SIGNAL(destroyed(QObject*)), this, SLOT(deleteSelf(QObject*)));
     }
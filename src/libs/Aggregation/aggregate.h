@@ -13,13 +13,42 @@
 #include <QObject>
 #include <QList>
 #include <QHash>
+#include <QMetaType>
 #include <QReadWriteLock>
 #include <QReadLocker>
 
 namespace Aggregation {
+
+namespace Internal {
+///
+/// component<T>()components<T>()ʱʹõļQ_OBJECTΪT::staticMetaObject
+/// ֻQ_DECLARE_INTERFACEĽӿûstaticMetaObjectΪ0ֻqobject_cast
+/// cast()תеĶ󣬽ӿͲõ
+template <typename T, bool IsQObject = QtPrivate::IsPointerToTypeDerivedFromQObject<T *>::Value>
+struct IndexKey
+{
+    static const QMetaObject *metaObject() { return &T::staticMetaObject; }
+    static T *cast(QObject *component) { return static_cast<T *>(component); }
+};
+
+template <typename T>
+struct IndexKey<T, false>
+{
+    static const QMetaObject *metaObject() { return 0; }
+    static T *cast(QObject *component) { return qobject_cast<T *>(component); }
+};
+} // namespace Internal
+
 /*!
  * \class Aggregate
  * \brief Aggregate 󼯺൱Union
+ *
+ * add()ʱcomponentmetaObject()ȫཨcomponent<T>()components<T>()
+ * QObjectֱӲˣ
+ * - \a T ҪQ_OBJECTļ丸࣬鵽ǸĶ
+ * - componentҪڹ֮add()ڹ캯add()ʱֻʱѾĸཨ
+ * component<T>()ûҵʱqobject_castȻҵ
+ * components<T>()ֻֻQ_DECLARE_INTERFACEĽӿqobject_cast
  */
 class AGGREGATION_EXPORT Aggregate : public QObject
 {
@@ -33,11 +62,19 @@ public:
     void remove(QObject *component);//!< m_componentsƳƶQObject
 
     ///
-    /// õбеһָ͵componentqobject_castm_componentsQList)б
+    /// õбеһָ͵componentȴӰͽm_indexȡã
+    /// ûʱqobject_castӿ͡ڹ캯ӵcomponent
     /// л
     template <typename T> T *component() {
-        QReadLocker(&lock());
-        foreach (QObject *component, m_components) {
+        QReadLocker locker(&lock());
+        if (const QMetaObject *meta = Internal::IndexKey<T>::metaObject())
+        {
+            QHash<const QMetaObject *, QList<QObject *> >::const_iterator it = m_index.constFind(meta);
+            if (it != m_index.constEnd() && !it.value().isEmpty())
+                return Internal::IndexKey<T>::cast(it.value().first());
+        }
+        foreach (QObject *component, m_components)
+        {
             if (T *result = qobject_cast<T *>(component))
                 return result;
         }
@@ -45,15 +82,24 @@ public:
     }
 
     ///
-    /// бָ͵component
+    /// бָ͵component˳ӵ˳ͬ
+    /// QObjectֻӿqobject_cast
     /// л
     template <typename T> QList<T *> components() {
-        QReadLocker(&lock());
+        QReadLocker locker(&lock());
         QList<T *> results;
-        foreach (QObject *component, m_components) {
-            if (T *result = qobject_cast<T *>(component)) {
+        if (const QMetaObject *meta = Internal::IndexKey<T>::metaObject())
+        {
+            const QList<QObject *> list = m_index.value(meta);
+            results.reserve(list.size());
+            foreach (QObject *component, list)
+                results << Internal::IndexKey<T>::cast(component);
+            return results;
+        }
+        foreach (QObject *component, m_components)
+        {
+            if (T *result = qobject_cast<T *>(component))
                 results << result;
-            }
         }
         return results;
     }
@@ -65,6 +111,11 @@ public:
     /// 
     static QReadWriteLock &lock();
 
+    ///
+    /// κAggregateӡƳcomponentʱһ
+    /// Aggregate֮ⰴͻѯʱPluginManagerĶֵı󻺴Ҫ½
+    static int generation();
+
 signals:
     void changed();
 
@@ -73,8 +124,10 @@ private slots:
 
 private:
     static QHash<QObject *, Aggregate *> &aggregateMap();
+    void removeFromIndex(QObject *component);
 
     QList<QObject *> m_components;
+    QHash<const QMetaObject *, QList<QObject *> > m_index;  //!< ͣȫࣩ-> ͵components
     bool m_autoDelete;  //!< ĳһcomponentɾʱǷԶɾԸüеж
 };
 
@@ -99,8 +152,11 @@ template <typename T> T *query(QObject *obj)
         return (T *)0;
     T *result = qobject_cast<T *>(obj);
     if (!result) {
-        QReadLocker(&lock());
-        Aggregate *parentAggregation = Aggregate::parentAggregate(obj);
+        Aggregate *parentAggregation;
+        {
+            QReadLocker locker(&Aggregate::lock());
+            parentAggregation = Aggregate::parentAggregate(obj);
+        }
         result = (parentAggregation ? query<T>(parentAggregation) : 0);
     }
     return result;
@@ -124,8 +180,11 @@ template <typename T> QList<T *> query_all(QObject *obj)
 {
     if (!obj)
         return QList<T *>();
-    QReadLocker(&lock());
-    Aggregate *parentAggregation = Aggregate::parentAggregate(obj);
+    Aggregate *parentAggregation;
+    {
+        QReadLocker locker(&Aggregate::lock());
+        parentAggregation = Aggregate::parentAggregate(obj);
+    }
     QList<T *> results;
     if (parentAggregation)
         results = query_all<T>(parentAggregation);
@@ -0,0 +1,366 @@
+#include "binarydeserializer.h"
+#include "binaryformat_p.h"
+#include "xmlserializable.h"
+#include "../utilsconstants.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QSharedPointer>
+#include <QVector>
+#include <QtEndian>
+#include <string.h>
+
+namespace Utils{
+
+using namespace Internal;
+
+class BinaryDeserializerPrivate
+{
+	Q_DECLARE_TR_FUNCTIONS(Utils::BinaryDeserializer)
+public:
+	struct Collection
+	{
+		quint64	parent;			//!< 进入集合之前的节点
+		quint64	collection;
+		quint64	item;			//!< 当前元素，0表示还没有开始
+	};
+
+	BinaryDeserializerPrivate();
+	bool open(const QString &filename);
+	bool readStrings(quint64 offset);
+
+	template<class T>
+	T read(quint64 offset) const
+	{
+		return qFromLittleEndian<T>(m_data + offset);
+	}
+	bool isNode(quint64 offset, quint64 end) const;
+	quint64 nodeEnd(quint64 node) const;
+	quint64 firstChild(quint64 node) const;
+	quint64 findChild(quint64 node, quint32 key, quint64 after = 0) const;	//!< 没有时返回0
+	quint64 findAttribute(quint64 node, const QString &key, quint32 kind) const;
+	quint32 keyIndex(const QString &key) const;
+
+	QSharedPointer<QFile>	m_file;			//!< 与clone()生成的副本共享映射
+	QByteArray				m_buffer;		//!< 无法映射文件时读入内存
+	const uchar*			m_data;
+	quint64					m_size;
+	int						m_major;
+	int						m_minor;
+	QVector<QString>		m_strings;
+	QHash<QString, quint32>	m_keys;
+	quint64					m_root;
+	quint64					m_current;
+	QList<Collection>		m_collections;
+	QString					m_errorString;
+};
+
+BinaryDeserializerPrivate::BinaryDeserializerPrivate()
+	: m_data(0),
+	m_size(0),
+	m_major(0),
+	m_minor(0),
+	m_root(0),
+	m_current(0)
+{
+}
+
+bool BinaryDeserializerPrivate::open(const QString &filename)
+{
+	m_file = QSharedPointer<QFile>(new QFile(filename));
+	if (!m_file->open(QIODevice::ReadOnly))
+	{
+		m_errorString = m_file->errorString();
+		return false;
+	}
+	m_size = m_file->size();
+	m_data = m_file->map(0, m_size);
+	if (!m_data)
+	{
+		m_buffer = m_file->readAll();
+		m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+	}
+	if (m_size < BINARY_HEADER_SIZE || memcmp(m_data, Constants::BINARY_MAGIC, 8) != 0)
+	{
+		m_errorString = tr("%1 is not a binary file.").arg(filename);
+		return false;
+	}
+	m_major = read<quint16>(8);
+	m_minor = read<quint16>(10);
+	if (m_major > Constants::BINARY_VERSION_MAJOR)
+	{
+		m_errorString = tr("%1 was saved in the newer format %2.%3.").arg(filename).arg(m_major).arg(m_minor);
+		return false;
+	}
+	const quint64 rootOffset = read<quint64>(16);
+	const quint64 stringTableOffset = read<quint64>(24);
+	if (read<quint64>(40) > m_size || !isNode(rootOffset, m_size) || !readStrings(stringTableOffset))
+	{
+		m_errorString = tr("%1 is damaged.").arg(filename);
+		return false;
+	}
+	m_root = m_current = rootOffset;
+	return true;
+}
+
+bool BinaryDeserializerPrivate::readStrings(quint64 offset)
+{
+	if (offset + 8 > m_size)
+		return false;
+	const quint32 count = read<quint32>(offset);
+	if (offset + 8 + quint64(count) * 8 > m_size)
+		return false;
+	m_strings.resize(count);
+	m_keys.reserve(count);
+	for (quint32 i = 0; i < count; ++i)
+	{
+		const quint64 stringOffset = read<quint64>(offset + 8 + quint64(i) * 8);
+		if (stringOffset + 4 > m_size)
+			return false;
+		const quint32 length = read<quint32>(stringOffset);
+		if (stringOffset + 4 + length > m_size)
+			return false;
+		m_strings[i] = QString::fromUtf8(reinterpret_cast<const char*>(m_data + stringOffset + 4), length);
+		m_keys.insert(m_strings.at(i), i);
+	}
+	return true;
+}
+
+bool BinaryDeserializerPrivate::isNode(quint64 offset, quint64 end) const
+{
+	if (offset == 0 || offset + BINARY_NODE_SIZE > end)
+		return false;
+	const quint64 size = read<quint64>(offset + 16);
+	const quint64 attributes = read<quint32>(offset + 4);
+	return size >= BINARY_NODE_SIZE + attributes * BINARY_ATTRIBUTE_SIZE && offset + size <= end;
+}
+
+quint64 BinaryDeserializerPrivate::nodeEnd(quint64 node) const
+{
+	return node + read<quint64>(node + 16);
+}
+
+quint64 BinaryDeserializerPrivate::firstChild(quint64 node) const
+{
+	return node + BINARY_NODE_SIZE + quint64(read<quint32>(node + 4)) * BINARY_ATTRIBUTE_SIZE;
+}
+
+/*!
+ * \brief 查找\e node 中名为\e key 的子节点，\e after 不为0时从该子节点之后开始查找
+ */
+quint64 BinaryDeserializerPrivate::findChild(quint64 node, quint32 key, quint64 after) const
+{
+	const quint64 end = nodeEnd(node);
+	quint64 child = after ? nodeEnd(after) : firstChild(node);
+	while (isNode(child, end))
+	{
+		if (read<quint32>(child) == key)
+			return child;
+		child = nodeEnd(child);
+	}
+	return 0;
+}
+
+/*!
+ * \brief 查找属性，返回属性记录的偏移，没有或者类型不同时返回0
+ */
+quint64 BinaryDeserializerPrivate::findAttribute(quint64 node, const QString &key, quint32 kind) const
+{
+	const quint32 index = keyIndex(key);
+	if (index == BINARY_INVALID_STRING)
+		return 0;
+	const quint32 count = read<quint32>(node + 4);
+	quint64 attribute = node + BINARY_NODE_SIZE;
+	for (quint32 i = 0; i < count; ++i, attribute += BINARY_ATTRIBUTE_SIZE)
+	{
+		if (read<quint32>(attribute) == index)
+			return read<quint32>(attribute + 4) == kind ? attribute : 0;
+	}
+	return 0;
+}
+
+quint32 BinaryDeserializerPrivate::keyIndex(const QString &key) const
+{
+	return m_keys.value(key, BINARY_INVALID_STRING);
+}
+
+static double bitsToDouble(qint64 bits)
+{
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+//----------------------------------------------
+BinaryDeserializer::BinaryDeserializer( const QString &filename )
+	: XmlDeserializer(),
+	d(new BinaryDeserializerPrivate)
+{
+	m_filename = filename;
+	if (!d->open(filename))
+		d->m_root = d->m_current = 0;
+}
+
+BinaryDeserializer::~BinaryDeserializer()
+{
+	delete d;
+}
+
+bool BinaryDeserializer::isBinaryFile( const QString &filename )
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	return file.read(8) == QByteArray(Constants::BINARY_MAGIC, 8);
+}
+
+bool BinaryDeserializer::isValid() const
+{
+	return d->m_root != 0;
+}
+
+/*!
+ * \brief 副本与本对象共享文件映射和字符串表，只复制当前位置
+ */
+XmlDeserializer * BinaryDeserializer::clone() const
+{
+	BinaryDeserializer *deserializer = new BinaryDeserializer;
+	deserializer->m_filename = m_filename;
+	*deserializer->d = *d;
+	deserializer->d->m_collections.clear();
+	return deserializer;
+}
+
+QString BinaryDeserializer::errorString() const
+{
+	return d->m_errorString;
+}
+
+int BinaryDeserializer::majorVersion() const
+{
+	return d->m_major;
+}
+
+int BinaryDeserializer::minorVersion() const
+{
+	return d->m_minor;
+}
+
+void BinaryDeserializer::deserialize( const QString &key, int &data )
+{
+	if (!d->m_current)
+		return;
+	if (quint64 attribute = d->findAttribute(d->m_current, key, BinaryKind_Int))
+		data = int(d->read<qint64>(attribute + 8));
+}
+
+void BinaryDeserializer::deserialize( const QString &key, bool &data )
+{
+	if (!d->m_current)
+		return;
+	if (quint64 attribute = d->findAttribute(d->m_current, key, BinaryKind_Bool))
+		data = d->read<qint64>(attribute + 8) != 0;
+}
+
+void BinaryDeserializer::deserialize( const QString &key, double &data )
+{
+	if (!d->m_current)
+		return;
+	quint64 attribute = d->findAttribute(d->m_current, key, BinaryKind_Double);
+	if (!attribute)
+		attribute = d->findAttribute(d->m_current, key, BinaryKind_Float);
+	if (attribute)
+		data = bitsToDouble(d->read<qint64>(attribute + 8));
+}
+
+void BinaryDeserializer::deserialize( const QString &key, float &data )
+{
+	double value = data;
+	deserialize(key, value);
+	data = float(value);
+}
+
+void BinaryDeserializer::deserialize( const QString &key, QString &data )
+{
+	if (!d->m_current)
+		return;
+	if (quint64 attribute = d->findAttribute(d->m_current, key, BinaryKind_String))
+	{
+		const qint64 index = d->read<qint64>(attribute + 8);
+		if (index >= 0 && index < d->m_strings.size())
+			data = d->m_strings.at(int(index));
+	}
+}
+
+void BinaryDeserializer::deserializeBinary( const QString &key, QByteArray &data )
+{
+	if (!d->m_current)
+		return;
+	if (quint64 attribute = d->findAttribute(d->m_current, key, BinaryKind_Binary))
+	{
+		const quint64 offset = d->read<qint64>(attribute + 8);
+		const quint64 size = d->read<quint64>(attribute + 16);
+		if (offset + size <= d->m_size)
+			data = QByteArray(reinterpret_cast<const char*>(d->m_data + offset), int(size));
+	}
+}
+
+void BinaryDeserializer::deserialize( const QString &key, XmlSerializable &data )
+{
+	if (!d->m_current)
+		return;
+	const quint32 index = d->keyIndex(key);
+	const quint64 child = index == BINARY_INVALID_STRING ? 0 : d->findChild(d->m_current, index);
+	if (!child)
+		return;
+	const quint64 current = d->m_current;
+	d->m_current = child;
+	data.deserialize(*this);
+	d->m_current = current;
+}
+
+bool BinaryDeserializer::beginCollection( const QString &key )
+{
+	if (!d->m_current)
+		return false;
+	const quint32 index = d->keyIndex(key);
+	const quint64 child = index == BINARY_INVALID_STRING ? 0 : d->findChild(d->m_current, index);
+	if (!child)
+		return false;
+	BinaryDeserializerPrivate::Collection collection;
+	collection.parent = d->m_current;
+	collection.collection = child;
+	collection.item = 0;
+	d->m_collections.append(collection);
+	d->m_current = child;
+	return true;
+}
+
+bool BinaryDeserializer::nextItem( const QString &itemKey, QString *type )
+{
+	if (d->m_collections.isEmpty())
+		return false;
+	BinaryDeserializerPrivate::Collection &collection = d->m_collections.last();
+	const quint32 index = d->keyIndex(itemKey);
+	collection.item = index == BINARY_INVALID_STRING ? 0 : d->findChild(collection.collection, index, collection.item);
+	if (!collection.item)
+	{
+		d->m_current = collection.collection;
+		return false;
+	}
+	d->m_current = collection.item;
+	if (type)
+	{
+		type->clear();
+		deserialize(QLatin1String(Constants::XML_NODE_TYPE), *type);
+	}
+	return true;
+}
+
+void BinaryDeserializer::endCollection()
+{
+	if (!d->m_collections.isEmpty())
+		d->m_current = d->m_collections.takeLast().parent;
+}
+
+}
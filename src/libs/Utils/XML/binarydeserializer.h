@@ -0,0 +1,49 @@
+#ifndef BINARYDESERIALIZER_H
+#define BINARYDESERIALIZER_H
+
+#include "xmldeserializer.h"
+
+namespace Utils{
+
+class BinaryDeserializerPrivate;
+
+/*!
+ * \brief 读取BinarySerializer保存的文件
+ *
+ * 文件通过内存映射读取，只在打开时解码一次字符串表，之后按节点中记录的大小直接跳转，
+ * 不建立任何中间的文档结构。主版本号比当前程序新的文件不会被读取。
+ */
+class TOTEM_UTILS_EXPORT BinaryDeserializer : public XmlDeserializer
+{
+public:
+	BinaryDeserializer(const QString &filename = QLatin1String(""));
+	virtual ~BinaryDeserializer();
+
+	static bool isBinaryFile(const QString &filename);	//!< 根据文件头判断是否是二进制格式
+
+	virtual bool isValid() const;
+	virtual XmlDeserializer *clone() const;
+	QString errorString() const;
+	int majorVersion() const;
+	int minorVersion() const;
+
+	using XmlDeserializer::deserialize;
+	virtual void deserialize(const QString &key, int &data);
+	virtual void deserialize(const QString &key, bool &data);
+	virtual void deserialize(const QString &key, double &data);
+	virtual void deserialize(const QString &key, float &data);
+	virtual void deserialize(const QString &key, QString &data);
+	virtual void deserializeBinary(const QString &key, QByteArray &data);
+	virtual void deserialize(const QString &key, XmlSerializable &data);
+
+protected:
+	virtual bool beginCollection(const QString &key);
+	virtual bool nextItem(const QString &itemKey, QString *type = 0);
+	virtual void endCollection();
+
+	BinaryDeserializerPrivate *d;
+};
+
+}
+
+#endif // BINARYDESERIALIZER_H
@@ -0,0 +1,65 @@
+#ifndef BINARYFORMAT_P_H
+#define BINARYFORMAT_P_H
+
+#include <QtGlobal>
+
+namespace Utils{
+namespace Internal{
+
+/*
+ * BinarySerializer文件布局，全部为小端序：
+ *
+ * 文件头（48字节）
+ *     char    magic[8]             Constants::BINARY_MAGIC
+ *     quint16 major, minor         格式版本
+ *     quint32 headerSize           文件头字节数，之后的版本可以扩展文件头
+ *     quint64 rootOffset           根节点
+ *     quint64 stringTableOffset    字符串表
+ *     quint64 dataOffset           二进制数据区
+ *     quint64 fileSize
+ *
+ * 节点（24字节，之后是attributeCount个属性和childCount个子节点）
+ *     quint32 key                  节点名在字符串表中的序号
+ *     quint32 attributeCount
+ *     quint32 childCount
+ *     quint32 reserved
+ *     quint64 size                 节点的总字节数，包括属性和全部子节点，用于跳过子树
+ *
+ * 属性（24字节）
+ *     quint32 key
+ *     quint32 kind                 BinaryValueKind
+ *     qint64  value                整数、布尔值、浮点数的位、字符串序号或者二进制数据的文件偏移
+ *     quint64 extra                二进制数据的字节数
+ *
+ * 字符串表（8字节对齐）
+ *     quint32 count, quint32 reserved
+ *     quint64 offsets[count]       每个字符串的文件偏移
+ *     每个字符串：quint32 字节数 + UTF-8数据，补齐到4字节
+ *
+ * 二进制数据区：每块数据从16字节对齐的位置开始，映射文件之后可以直接访问。
+ */
+enum BinaryValueKind
+{
+	BinaryKind_Int = 1,
+	BinaryKind_Bool,
+	BinaryKind_Float,
+	BinaryKind_Double,
+	BinaryKind_String,
+	BinaryKind_Binary
+};
+
+const quint32 BINARY_HEADER_SIZE		= 48;
+const quint32 BINARY_NODE_SIZE			= 24;
+const quint32 BINARY_ATTRIBUTE_SIZE		= 24;
+const quint32 BINARY_DATA_ALIGNMENT		= 16;
+const quint32 BINARY_INVALID_STRING		= 0xffffffff;
+
+inline quint64 binaryAligned(quint64 size, quint64 alignment)
+{
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+}
+}
+
+#endif // BINARYFORMAT_P_H
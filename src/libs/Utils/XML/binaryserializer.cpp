@@ -0,0 +1,293 @@
+#include "binaryserializer.h"
+#include "binaryformat_p.h"
+#include "xmlserializable.h"
+#include "../utilsconstants.h"
+#include <QHash>
+#include <QSaveFile>
+#include <QVector>
+#include <QtEndian>
+#include <string.h>
+
+namespace Utils{
+
+using namespace Internal;
+
+struct BinaryAttribute
+{
+	quint32	key;
+	quint32	kind;
+	qint64	value;
+	int		binary;		//!< BinaryKind_Binary时在m_binaries中的序号
+};
+
+struct BinaryNode
+{
+	BinaryNode(quint32 k = 0) : key(k), size(0) { }
+	~BinaryNode() { qDeleteAll(children); }
+	quint64 layout();	//!< 计算并保存节点的总字节数
+
+	quint32						key;
+	QVector<BinaryAttribute>	attributes;
+	QList<BinaryNode*>			children;
+	quint64						size;
+};
+
+quint64 BinaryNode::layout()
+{
+	size = BINARY_NODE_SIZE + quint64(attributes.size()) * BINARY_ATTRIBUTE_SIZE;
+	foreach (BinaryNode *child, children)
+		size += child->layout();
+	return size;
+}
+
+class BinarySerializerPrivate
+{
+public:
+	BinarySerializerPrivate();
+	quint32 intern(const QString &text);
+	void setAttribute(const QString &key, quint32 kind, qint64 value, int binary = -1);
+	BinaryNode* beginNode(const QString &key);
+	void writeNode(QByteArray &buffer, const BinaryNode *node, const QVector<quint64> &binaryOffsets) const;
+
+	BinaryNode					m_root;
+	QList<BinaryNode*>			m_stack;		//!< 当前节点及其祖先
+	QHash<QString, quint32>		m_stringIndex;
+	QList<QByteArray>			m_strings;		//!< UTF-8
+	QList<QByteArray>			m_binaries;
+	QString						m_errorString;
+};
+
+template<class T>
+static void appendValue(QByteArray &buffer, T value)
+{
+	uchar bytes[sizeof(T)];
+	qToLittleEndian<T>(value, bytes);
+	buffer.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+static void appendPadding(QByteArray &buffer, quint64 alignment)
+{
+	const int padding = int(binaryAligned(buffer.size(), alignment) - buffer.size());
+	if (padding > 0)
+		buffer.append(QByteArray(padding, '\0'));
+}
+
+static qint64 doubleBits(double value)
+{
+	qint64 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+BinarySerializerPrivate::BinarySerializerPrivate()
+{
+	m_root.key = intern(QLatin1String(Constants::XML_ROOT));
+	m_stack.append(&m_root);
+}
+
+quint32 BinarySerializerPrivate::intern(const QString &text)
+{
+	QHash<QString, quint32>::const_iterator itr = m_stringIndex.constFind(text);
+	if (itr != m_stringIndex.constEnd())
+		return itr.value();
+	const quint32 index = m_strings.size();
+	m_strings.append(text.toUtf8());
+	m_stringIndex.insert(text, index);
+	return index;
+}
+
+/*!
+ * \brief 设置当前节点的属性，与QDomElement::setAttribute()一样覆盖同名的属性
+ */
+void BinarySerializerPrivate::setAttribute(const QString &key, quint32 kind, qint64 value, int binary)
+{
+	BinaryAttribute attribute;
+	attribute.key		= intern(key);
+	attribute.kind		= kind;
+	attribute.value		= value;
+	attribute.binary	= binary;
+	QVector<BinaryAttribute> &attributes = m_stack.last()->attributes;
+	for (int i = 0; i < attributes.size(); ++i)
+	{
+		if (attributes.at(i).key == attribute.key)
+		{
+			attributes[i] = attribute;
+			return;
+		}
+	}
+	attributes.append(attribute);
+}
+
+BinaryNode* BinarySerializerPrivate::beginNode(const QString &key)
+{
+	BinaryNode *node = new BinaryNode(intern(key));
+	m_stack.last()->children.append(node);
+	m_stack.append(node);
+	return node;
+}
+
+void BinarySerializerPrivate::writeNode(QByteArray &buffer, const BinaryNode *node, const QVector<quint64> &binaryOffsets) const
+{
+	appendValue<quint32>(buffer, node->key);
+	appendValue<quint32>(buffer, node->attributes.size());
+	appendValue<quint32>(buffer, node->children.size());
+	appendValue<quint32>(buffer, 0);
+	appendValue<quint64>(buffer, node->size);
+	foreach (const BinaryAttribute &attribute, node->attributes)
+	{
+		appendValue<quint32>(buffer, attribute.key);
+		appendValue<quint32>(buffer, attribute.kind);
+		if (attribute.kind == BinaryKind_Binary)
+		{
+			appendValue<qint64>(buffer, binaryOffsets.at(attribute.binary));
+			appendValue<quint64>(buffer, m_binaries.at(attribute.binary).size());
+		}
+		else
+		{
+			appendValue<qint64>(buffer, attribute.value);
+			appendValue<quint64>(buffer, 0);
+		}
+	}
+	foreach (const BinaryNode *child, node->children)
+		writeNode(buffer, child, binaryOffsets);
+}
+
+//----------------------------------------------
+BinarySerializer::BinarySerializer( const QString &filepath )
+	: XmlSerializer(filepath),
+	d(new BinarySerializerPrivate)
+{
+}
+
+BinarySerializer::~BinarySerializer()
+{
+	delete d;
+}
+
+void BinarySerializer::serialize( const QString &key, const int &data )
+{
+	d->setAttribute(key, BinaryKind_Int, data);
+}
+
+void BinarySerializer::serialize( const QString &key, const bool &data )
+{
+	d->setAttribute(key, BinaryKind_Bool, data ? 1 : 0);
+}
+
+void BinarySerializer::serialize( const QString &key, const float &data )
+{
+	d->setAttribute(key, BinaryKind_Float, doubleBits(data));
+}
+
+void BinarySerializer::serialize( const QString &key, const double &data )
+{
+	d->setAttribute(key, BinaryKind_Double, doubleBits(data));
+}
+
+void BinarySerializer::serialize( const QString &key, const QString &data )
+{
+	d->setAttribute(key, BinaryKind_String, d->intern(data));
+}
+
+void BinarySerializer::serialize( const QString &key, const XmlSerializable &data )
+{
+	d->beginNode(key);
+	data.serialize(*this);
+	if (!data.serializableType().isEmpty())
+		serialize(QLatin1String(Constants::XML_NODE_TYPE), data.serializableType());
+	d->m_stack.removeLast();
+}
+
+void BinarySerializer::serializeBinary( const QString &key, const QByteArray &data )
+{
+	d->m_binaries.append(data);
+	d->setAttribute(key, BinaryKind_Binary, 0, d->m_binaries.size() - 1);
+}
+
+void BinarySerializer::beginCollection( const QString &key )
+{
+	d->beginNode(key);
+}
+
+void BinarySerializer::endCollection()
+{
+	if (d->m_stack.size() > 1)
+		d->m_stack.removeLast();
+}
+
+bool BinarySerializer::write( const QString &filePath )
+{
+	///
+	/// 先确定每一部分的位置，节点中的二进制数据偏移是绝对位置
+	const quint64 rootOffset = BINARY_HEADER_SIZE;
+	const quint64 stringTableOffset = binaryAligned(rootOffset + d->m_root.layout(), 8);
+	quint64 stringTableSize = 8 + quint64(d->m_strings.size()) * 8;
+	foreach (const QByteArray &text, d->m_strings)
+		stringTableSize += binaryAligned(4 + text.size(), 4);
+	const quint64 dataOffset = binaryAligned(stringTableOffset + stringTableSize, BINARY_DATA_ALIGNMENT);
+	QVector<quint64> binaryOffsets;
+	binaryOffsets.reserve(d->m_binaries.size());
+	quint64 fileSize = dataOffset;
+	foreach (const QByteArray &data, d->m_binaries)
+	{
+		binaryOffsets.append(fileSize);
+		fileSize = binaryAligned(fileSize + data.size(), BINARY_DATA_ALIGNMENT);
+	}
+
+	QByteArray buffer;
+	buffer.reserve(int(dataOffset));
+	buffer.append(Constants::BINARY_MAGIC, 8);
+	appendValue<quint16>(buffer, Constants::BINARY_VERSION_MAJOR);
+	appendValue<quint16>(buffer, Constants::BINARY_VERSION_MINOR);
+	appendValue<quint32>(buffer, BINARY_HEADER_SIZE);
+	appendValue<quint64>(buffer, rootOffset);
+	appendValue<quint64>(buffer, stringTableOffset);
+	appendValue<quint64>(buffer, dataOffset);
+	appendValue<quint64>(buffer, fileSize);
+	d->writeNode(buffer, &d->m_root, binaryOffsets);
+	appendPadding(buffer, 8);
+
+	appendValue<quint32>(buffer, d->m_strings.size());
+	appendValue<quint32>(buffer, 0);
+	quint64 stringOffset = stringTableOffset + 8 + quint64(d->m_strings.size()) * 8;
+	foreach (const QByteArray &text, d->m_strings)
+	{
+		appendValue<quint64>(buffer, stringOffset);
+		stringOffset += binaryAligned(4 + text.size(), 4);
+	}
+	foreach (const QByteArray &text, d->m_strings)
+	{
+		appendValue<quint32>(buffer, text.size());
+		buffer.append(text);
+		appendPadding(buffer, 4);
+	}
+	appendPadding(buffer, BINARY_DATA_ALIGNMENT);
+
+	QSaveFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		d->m_errorString = file.errorString();
+		return false;
+	}
+	file.write(buffer);
+	foreach (const QByteArray &data, d->m_binaries)
+	{
+		file.write(data);
+		const quint64 padding = binaryAligned(data.size(), BINARY_DATA_ALIGNMENT) - data.size();
+		if (padding > 0)
+			file.write(QByteArray(int(padding), '\0'));
+	}
+	if (!file.commit())
+	{
+		d->m_errorString = file.errorString();
+		return false;
+	}
+	return true;
+}
+
+QString BinarySerializer::errorString() const
+{
+	return d->m_errorString;
+}
+
+}
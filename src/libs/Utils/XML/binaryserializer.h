@@ -0,0 +1,44 @@
+#ifndef BINARYSERIALIZER_H
+#define BINARYSERIALIZER_H
+
+#include "xmlserializer.h"
+
+namespace Utils{
+
+class BinarySerializerPrivate;
+
+/*!
+ * \brief 二进制格式的序列化
+ *
+ * 与XmlSerializer保存相同的节点结构，但数值直接以二进制保存，节点名和字符串只保存一次，
+ * serializeBinary()的数据按16字节对齐放在文件末尾，读取时不需要解析文本。
+ * 文件带有版本号，由BinaryDeserializer读取，布局见binaryformat_p.h。
+ */
+class TOTEM_UTILS_EXPORT BinarySerializer : public XmlSerializer
+{
+public:
+	BinarySerializer(const QString &filepath = QLatin1String(""));
+	virtual ~BinarySerializer();
+
+	using XmlSerializer::serialize;
+	virtual void serialize(const QString &key, const int &data);
+	virtual void serialize(const QString &key, const bool &data);
+	virtual void serialize(const QString &key, const float &data);
+	virtual void serialize(const QString &key, const double &data);
+	virtual void serialize(const QString &key, const QString &data);
+	virtual void serialize(const QString &key, const XmlSerializable &data);
+	virtual void serializeBinary(const QString &key, const QByteArray &data);
+
+	virtual bool write(const QString &filePath);
+	QString errorString() const;
+
+protected:
+	virtual void beginCollection(const QString &key);
+	virtual void endCollection();
+
+	BinarySerializerPrivate *d;
+};
+
+}
+
+#endif // BINARYSERIALIZER_H
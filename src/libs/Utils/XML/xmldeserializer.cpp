@@ -1,4 +1,5 @@
 #include "xmldeserializer.h"
+#include "xmlplaceholder.h"
 #include "xmlserializable.h"
 #include "xmlserializer.h"
 #include <QFile>
@@ -20,10 +21,36 @@ XmlDeserializer::XmlDeserializer( const QString &filename /*= QLatin1String("")*
 
 }
 
+XmlDeserializer::XmlDeserializer( const QDomDocument &doc )
+	: m_doc(doc)
+{
+	m_currentElement = m_root = m_doc.documentElement();
+}
+
 XmlDeserializer::~XmlDeserializer(void)
 {
 }
 
+bool XmlDeserializer::isValid() const
+{
+	return !m_root.isNull();
+}
+
+XmlDeserializer *XmlDeserializer::clone() const
+{
+	XmlDeserializer *deserializer = new XmlDeserializer;
+	deserializer->m_filename = m_filename;
+	deserializer->m_doc = m_doc;
+	deserializer->m_root = m_root;
+	deserializer->m_currentElement = m_currentElement;
+	return deserializer;
+}
+
+XmlPlaceholder XmlDeserializer::placeholder( const QString &key ) const
+{
+	return XmlPlaceholder(clone(), key);
+}
+
 void XmlDeserializer::deserialize(const QString &key, XmlSerializable &data) 
 {
 	QDomElement tempElement = m_currentElement;
@@ -86,6 +113,51 @@ void XmlDeserializer::deserialize( const QString &key, QString &data )
 	}
 }
 
+void XmlDeserializer::deserializeBinary( const QString &key, QByteArray &data )
+{
+	if (m_currentElement.hasAttribute(key))
+	{
+		data = QByteArray::fromBase64(m_currentElement.attribute(key).toLatin1());
+	}
+}
+
+bool XmlDeserializer::beginCollection( const QString &key )
+{
+	QDomElement element = m_currentElement.firstChildElement(key);
+	if (element.isNull())
+		return false;
+	Collection collection;
+	collection.parent = m_currentElement;
+	collection.collection = element;
+	m_collections.append(collection);
+	m_currentElement = element;
+	return true;
+}
+
+bool XmlDeserializer::nextItem( const QString &itemKey, QString *type )
+{
+	if (m_collections.isEmpty())
+		return false;
+	Collection &collection = m_collections.last();
+	collection.item = collection.item.isNull() ? collection.collection.firstChildElement(itemKey)
+		: collection.item.nextSiblingElement(itemKey);
+	if (collection.item.isNull())
+	{
+		m_currentElement = collection.collection;
+		return false;
+	}
+	m_currentElement = collection.item;
+	if (type)
+		*type = collection.item.attribute(Constants::XML_NODE_TYPE);
+	return true;
+}
+
+void XmlDeserializer::endCollection()
+{
+	if (!m_collections.isEmpty())
+		m_currentElement = m_collections.takeLast().parent;
+}
+
 
 
 
@@ -12,19 +12,32 @@
 namespace Utils{
 class XmlSerializable;
 class XmlSerializer;
+class XmlPlaceholder;
+/*!
+ * \brief лӿ
+ *
+ * ĬʵֶȡXmlSerializerɵXMLļBinaryDeserializerȡʽ
+ * ȡڵļʱݲ䡣
+ */
 class TOTEM_UTILS_EXPORT XmlDeserializer
 {
 public:
 	XmlDeserializer(const QString &filename = QLatin1String(""));
+	explicit XmlDeserializer(const QDomDocument &doc);	//!< ȡڴеĵXmlSerializer::document()
 	virtual ~XmlDeserializer(void);
 
-	void deserialize(const QString &key, int &data);
-	void deserialize(const QString &key, bool &data);
-	void deserialize(const QString &key, double &data);
-	void deserialize(const QString &key, float &data);
-	void deserialize(const QString &key, QString &data);
+	virtual bool isValid() const;		//!< ļǷɹȡ
+	virtual XmlDeserializer *clone() const;	//!< λڵǰڵĸ뱾Ѷȡ
+	XmlPlaceholder placeholder(const QString &key = QString()) const;	//!< ¼ǰڵ㣬Ժٶȡ
 
-	void deserialize(const QString &key, XmlSerializable &data);
+	virtual void deserialize(const QString &key, int &data);
+	virtual void deserialize(const QString &key, bool &data);
+	virtual void deserialize(const QString &key, double &data);
+	virtual void deserialize(const QString &key, float &data);
+	virtual void deserialize(const QString &key, QString &data);
+	virtual void deserializeBinary(const QString &key, QByteArray &data);
+
+	virtual void deserialize(const QString &key, XmlSerializable &data);
 	template<class T>
 	void deserializeCollection(const QString &key, QList<T>&data, const QString &itemKey);
 	template<class T>
@@ -34,84 +47,73 @@ public:
 
 
 protected:
+	virtual bool beginCollection(const QString &key);	//!< 뼯Ͻڵ\e keyʱfalse
+	virtual bool nextItem(const QString &itemKey, QString *type = 0);	//!< ƶеһԪأ\e type Ԫص
+	virtual void endCollection();
+
+	struct Collection
+	{
+		QDomElement	parent;		//!< 뼯֮ǰĽڵ
+		QDomElement	collection;
+		QDomElement	item;		//!< ǰԪ
+	};
+
 	QString			m_filename;
 	QDomElement		m_root;				//!< ڵ
 	QDomDocument	m_doc;				//!<	fileӦdoc
 	QDomElement		m_currentElement;	//!< ǰĽڵ
+	QList<Collection>	m_collections;
 };
 
 template<class T>
 void XmlDeserializer::deserializeCollection(const QString &key, QList<T>&data, const QString &itemKey)
 {
-	QDomElement tempElement = m_currentElement;
-	m_currentElement = m_currentElement.firstChildElement(key);
-	if (m_currentElement.isNull())
-	{
+	if (!beginCollection(key))
 		return;
-	}
-	QDomElement childElement = m_currentElement.firstChildElement(itemKey);
-	while(!childElement.isNull())
+	while (nextItem(itemKey))
 	{
-		m_currentElement = childElement;
 		T tempData;
 		tempData.deserialize(*this);
-//		deserialize(itemKey, tempData);
 		data.append(tempData);
-		childElement = childElement.nextSiblingElement(itemKey);
 	}
-	m_currentElement = tempElement;
+	endCollection();
 }
 template<class T>
 void XmlDeserializer::deserializeCollection( const QString &key, QVector<T*>&data, const QString &itemKey )
 {
-	QDomElement tempElement = m_currentElement;
-	m_currentElement = m_currentElement.firstChildElement(key);
-	if (m_currentElement.isNull())
-	{
+	if (!beginCollection(key))
 		return;
-	}
-	QDomElement childElement = m_currentElement.firstChildElement(itemKey);
-	while(!childElement.isNull())
+	QString type;
+	while (nextItem(itemKey, &type))
 	{
-		QString type = childElement.attribute(Constants::XML_NODE_TYPE);
 		if (type.isEmpty())
-		{
 			continue;
-		}
-		m_currentElement = childElement;
 		T *tempData = (T*)XmlSerializableFactory::instance()->createSerialzable(type);
-		deserialize(itemKey, *tempData);
+		if (!tempData)
+			continue;
+		tempData->deserialize(*this);
 		data.append(tempData);
-		childElement = childElement.nextSiblingElement(itemKey);
 	}
-	m_currentElement = tempElement;
+	endCollection();
 }
 template<class T>
 void XmlDeserializer::deserializeCollection( const QString &key, QList<T*>&data, const QString &itemKey )
 {
-	QDomElement tempElement = m_currentElement;
-	m_currentElement = m_currentElement.firstChildElement(key);
-	if (m_currentElement.isNull())
-	{
+	if (!beginCollection(key))
 		return;
-	}
-	QDomElement childElement = m_currentElement.firstChildElement(itemKey);
-	while(!childElement.isNull())
+	QString type;
+	while (nextItem(itemKey, &type))
 	{
-		QString type = childElement.attribute(Constants::XML_NODE_TYPE);
 		if (type.isEmpty())
-		{
 			continue;
-		}
-		m_currentElement = childElement;
 		T *tempData = (T*)XmlSerializableFactory::instance()->createSerialzable(type);
+		if (!tempData)
+			continue;
 		tempData->deserialize(*this);
 		data.append(tempData);
-		childElement = childElement.nextSiblingElement(itemKey);
 	}
-	m_currentElement = tempElement;
+	endCollection();
 }
 
-
 }
 #endif
@@ -0,0 +1,52 @@
+#include "xmlplaceholder.h"
+#include "xmldeserializer.h"
+#include "xmlserializable.h"
+
+namespace Utils{
+
+XmlPlaceholder::XmlPlaceholder()
+{
+}
+
+XmlPlaceholder::XmlPlaceholder( XmlDeserializer *deserializer, const QString &key )
+	: m_deserializer(deserializer),
+	m_key(key)
+{
+}
+
+bool XmlPlaceholder::isNull() const
+{
+	return m_deserializer.isNull();
+}
+
+void XmlPlaceholder::clear()
+{
+	m_deserializer.clear();
+	m_key.clear();
+}
+
+QString XmlPlaceholder::key() const
+{
+	return m_key;
+}
+
+XmlDeserializer * XmlPlaceholder::deserializer() const
+{
+	return m_deserializer.data();
+}
+
+void XmlPlaceholder::deserialize( XmlSerializable &data ) const
+{
+	if (m_deserializer)
+		data.deserialize(*m_deserializer);
+}
+
+QByteArray XmlPlaceholder::binary() const
+{
+	QByteArray data;
+	if (m_deserializer)
+		m_deserializer->deserializeBinary(m_key, data);
+	return data;
+}
+
+}
@@ -0,0 +1,43 @@
+#ifndef XMLPLACEHOLDER_H
+#define XMLPLACEHOLDER_H
+
+#include "../utils_global.h"
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+
+namespace Utils{
+
+class XmlDeserializer;
+class XmlSerializable;
+
+/*!
+ * \brief 延迟读取的节点或者二进制数据
+ *
+ * 由XmlDeserializer::placeholder()生成，保存定位在当前节点的XmlDeserializer副本，
+ * 副本与原反序列化对象共享已经读入的文件内容，原对象删除之后仍然可以使用。
+ * 用于打开文件时跳过暂时不需要的子节点或者大块数据，在第一次使用时再读取。
+ * 复制XmlPlaceholder只增加引用计数。
+ */
+class TOTEM_UTILS_EXPORT XmlPlaceholder
+{
+public:
+	XmlPlaceholder();
+	XmlPlaceholder(XmlDeserializer *deserializer, const QString &key = QString());	//!< 获得\e deserializer 的所有权
+
+	bool isNull() const;
+	void clear();			//!< 释放文件内容
+	QString key() const;
+
+	XmlDeserializer *deserializer() const;	//!< 定位在记录的节点上
+	void deserialize(XmlSerializable &data) const;	//!< 从记录的节点读取\e data
+	QByteArray binary() const;				//!< 读取记录的节点中以key()保存的二进制数据
+
+private:
+	QSharedPointer<XmlDeserializer>	m_deserializer;
+	QString							m_key;
+};
+
+}
+
+#endif // XMLPLACEHOLDER_H
@@ -68,14 +68,40 @@ void XmlSerializer::serialize( const QString &key, const QString &data )
 	m_currentElement.setAttribute(key, data);
 }
 
-void XmlSerializer::write(const QString &filePath)
+void XmlSerializer::serializeBinary( const QString &key, const QByteArray &data )
+{
+	m_currentElement.setAttribute(key, QString::fromLatin1(data.toBase64()));
+}
+
+bool XmlSerializer::write(const QString &filePath)
 {
 	QFile file(filePath);
 	if (file.open(QIODevice::WriteOnly))
 	{
 		file.write(m_doc.toByteArray(4));
 		file.close();
+		return true;
 	}
+	return false;
+}
+
+void XmlSerializer::beginCollection( const QString &key )
+{
+	QDomElement parentItem = m_doc.createElement(key);
+	m_currentElement.appendChild(parentItem);
+	m_collections.append(m_currentElement);
+	m_currentElement = parentItem;
+}
+
+void XmlSerializer::endCollection()
+{
+	if (!m_collections.isEmpty())
+		m_currentElement = m_collections.takeLast();
+}
+
+QDomDocument XmlSerializer::document() const
+{
+	return m_doc;
 }
 
 }
@@ -2,11 +2,19 @@
 #define XMLSERIALIZER_H
 
 #include "../utils_global.h"
+#include <QByteArray>
+#include <QList>
 #include <QString>
 #include <QtXml/QDomDocument>
 #include <QtXml/QDomNode>
 namespace Utils{
 class XmlSerializable;
+/*!
+ * \brief лӿ
+ *
+ * XmlSerializableͨдݣĬʵXMLĵBinarySerializerʵ
+ * serialize()ͼϵbeginCollection()/endCollection()ʽͬĽڵṹ
+ */
 class TOTEM_UTILS_EXPORT XmlSerializer
 {
 public:
@@ -15,12 +23,13 @@ public:
 
 	void setFilePath(const QString &filepath = QLatin1String(""));
 	QString filePath() const;
-	void serialize(const QString &key, const int &data);
-	void serialize(const QString &key, const bool &data);
-	void serialize(const QString &key, const float &data);
-	void serialize(const QString &key, const double &data);
-	void serialize(const QString &key, const QString &data);
-	void serialize(const QString &key, const XmlSerializable &data);
+	virtual void serialize(const QString &key, const int &data);
+	virtual void serialize(const QString &key, const bool &data);
+	virtual void serialize(const QString &key, const float &data);
+	virtual void serialize(const QString &key, const double &data);
+	virtual void serialize(const QString &key, const QString &data);
+	virtual void serialize(const QString &key, const XmlSerializable &data);
+	virtual void serializeBinary(const QString &key, const QByteArray &data);	//!< ݣXMLбΪbase64
 	
 	template<class T>
 	void serialize(const QString &key, const QList<T> &datas, const QString &items) ;
@@ -30,53 +39,49 @@ public:
 	template<class T>
 	void serialize(const QString &key, const QList<T*> &datas, const QString &items) ;
 
-	void write(const QString &filePath);
+	virtual bool write(const QString &filePath);
+	QDomDocument document() const;		//!< Ѿлĵ
 protected:
+	virtual void beginCollection(const QString &key);	//!< ʼϽڵ\e key֮Ԫضдڸýڵ
+	virtual void endCollection();
+
 	QString			m_filepath;			//!< ļ·
 	mutable QDomElement		m_root;				//!< ڵ
 	mutable QDomDocument	m_doc;				//!<	fileӦdoc
 	mutable QDomElement		m_currentElement;	//!< ǰĽڵ
+	QList<QDomElement>		m_collections;		//!< 뼯֮ǰĽڵ
 };
 template<class T>
 void Utils::XmlSerializer::serialize(const QString &key, const QList<T> &datas, const QString &itemKey) 
 {
-	QDomElement parentItem = m_doc.createElement(key);
-	m_currentElement.appendChild(parentItem);
-	QDomElement tempElement = m_currentElement;
-	m_currentElement = parentItem;
+	beginCollection(key);
 	foreach(const T &data, datas)
 	{
 		serialize(itemKey, data);
 	}
-	m_currentElement = tempElement;
+	endCollection();
 }
 
 template<class T>
 void Utils::XmlSerializer::serialize( const QString &key, const QVector<T*> &datas, const QString &itemKey )
 {
-	QDomElement parentItem = m_doc.createElement(key);
-	m_currentElement.appendChild(parentItem);
-	QDomElement tempElement = m_currentElement;
-	m_currentElement = parentItem;
+	beginCollection(key);
 	foreach(T* data, datas)
 	{
 		serialize(itemKey, *data);
 	}
-	m_currentElement = tempElement;
+	endCollection();
 }
 
 template<class T>
 void Utils::XmlSerializer::serialize( const QString &key, const QList<T*> &datas, const QString &itemKey )
 {
-	QDomElement parentItem = m_doc.createElement(key);
-	m_currentElement.appendChild(parentItem);
-	QDomElement tempElement = m_currentElement;
-	m_currentElement = parentItem;
+	beginCollection(key);
 	foreach(T* data, datas)
 	{
 		serialize(itemKey, *data);
 	}
-	m_currentElement = tempElement;
+	endCollection();
 }
 }
 
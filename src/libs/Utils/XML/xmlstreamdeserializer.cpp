@@ -0,0 +1,302 @@
+#include "xmlstreamdeserializer.h"
+#include "xmlserializable.h"
+#include "../utilsconstants.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <QXmlStreamReader>
+
+namespace Utils{
+
+class XmlStreamDeserializerPrivate
+{
+	Q_DECLARE_TR_FUNCTIONS(Utils::XmlStreamDeserializer)
+public:
+	struct Node
+	{
+		quint32	key;
+		int		firstAttribute;
+		int		attributeCount;
+		int		firstChild;		//!< -1表示没有
+		int		nextSibling;	//!< -1表示没有
+	};
+
+	struct Attribute
+	{
+		quint32	key;
+		int		offset;			//!< 在m_values中的位置
+		int		length;
+	};
+
+	struct Collection
+	{
+		int		parent;			//!< 进入集合之前的节点
+		int		collection;
+		int		item;			//!< 当前元素，-1表示还没有开始
+	};
+
+	XmlStreamDeserializerPrivate();
+	bool open(const QString &filename);
+	quint32 keyIndex(const QString &key, bool bInsert);
+	int findChild(int node, const QString &key, int after = -1) const;	//!< 没有时返回-1
+	bool attribute(int node, const QString &key, QString *value) const;
+
+	QVector<Node>			m_nodes;
+	QVector<Attribute>		m_attributes;
+	QString					m_values;		//!< 全部属性值
+	QHash<QString, quint32>	m_keys;
+	int						m_current;
+	QList<Collection>		m_collections;
+	QString					m_errorString;
+};
+
+XmlStreamDeserializerPrivate::XmlStreamDeserializerPrivate()
+	: m_current(-1)
+{
+}
+
+bool XmlStreamDeserializerPrivate::open(const QString &filename)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		m_errorString = file.errorString();
+		return false;
+	}
+	QXmlStreamReader reader(&file);
+	QVector<int> parents;			//!< 还没有结束的节点
+	QVector<int> lastChildren;		//!< 对应节点最后一个子节点
+	while (!reader.atEnd())
+	{
+		const QXmlStreamReader::TokenType token = reader.readNext();
+		if (token == QXmlStreamReader::StartElement)
+		{
+			if (parents.isEmpty() && !m_nodes.isEmpty())
+				break;
+			Node node;
+			node.key = keyIndex(reader.name().toString(), true);
+			node.firstAttribute = m_attributes.size();
+			node.firstChild = -1;
+			node.nextSibling = -1;
+			const QXmlStreamAttributes attributes = reader.attributes();
+			node.attributeCount = attributes.size();
+			foreach (const QXmlStreamAttribute &attribute, attributes)
+			{
+				Attribute item;
+				item.key = keyIndex(attribute.name().toString(), true);
+				item.offset = m_values.size();
+				item.length = attribute.value().size();
+				m_values.append(attribute.value());
+				m_attributes.append(item);
+			}
+			const int index = m_nodes.size();
+			m_nodes.append(node);
+			if (!parents.isEmpty())
+			{
+				int &last = lastChildren.last();
+				if (last < 0)
+					m_nodes[parents.last()].firstChild = index;
+				else
+					m_nodes[last].nextSibling = index;
+				last = index;
+			}
+			parents.append(index);
+			lastChildren.append(-1);
+		}
+		else if (token == QXmlStreamReader::EndElement)
+		{
+			parents.removeLast();
+			lastChildren.removeLast();
+		}
+	}
+	if (reader.hasError() && reader.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+	{
+		m_errorString = tr("%1, line %2: %3").arg(filename).arg(reader.lineNumber()).arg(reader.errorString());
+		return false;
+	}
+	if (m_nodes.isEmpty() || !parents.isEmpty())
+	{
+		m_errorString = tr("%1 is damaged.").arg(filename);
+		return false;
+	}
+	m_nodes.squeeze();
+	m_attributes.squeeze();
+	m_values.squeeze();
+	m_current = 0;
+	return true;
+}
+
+quint32 XmlStreamDeserializerPrivate::keyIndex(const QString &key, bool bInsert)
+{
+	QHash<QString, quint32>::const_iterator it = m_keys.constFind(key);
+	if (it != m_keys.constEnd())
+		return it.value();
+	if (!bInsert)
+		return quint32(-1);
+	const quint32 index = m_keys.size();
+	m_keys.insert(key, index);
+	return index;
+}
+
+int XmlStreamDeserializerPrivate::findChild(int node, const QString &key, int after) const
+{
+	if (node < 0)
+		return -1;
+	const quint32 keyId = m_keys.value(key, quint32(-1));
+	if (keyId == quint32(-1))
+		return -1;
+	int child = after < 0 ? m_nodes.at(node).firstChild : m_nodes.at(after).nextSibling;
+	while (child >= 0 && m_nodes.at(child).key != keyId)
+		child = m_nodes.at(child).nextSibling;
+	return child;
+}
+
+bool XmlStreamDeserializerPrivate::attribute(int node, const QString &key, QString *value) const
+{
+	if (node < 0)
+		return false;
+	const quint32 keyId = m_keys.value(key, quint32(-1));
+	if (keyId == quint32(-1))
+		return false;
+	const Node &item = m_nodes.at(node);
+	for (int i = item.firstAttribute; i < item.firstAttribute + item.attributeCount; ++i)
+	{
+		const Attribute &attribute = m_attributes.at(i);
+		if (attribute.key == keyId)
+		{
+			*value = m_values.mid(attribute.offset, attribute.length);
+			return true;
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------
+XmlStreamDeserializer::XmlStreamDeserializer( const QString &filename /*= QLatin1String("")*/ )
+	: XmlDeserializer(),
+	d(new XmlStreamDeserializerPrivate)
+{
+	m_filename = filename;
+	d->open(filename);
+}
+
+XmlStreamDeserializer::~XmlStreamDeserializer()
+{
+	delete d;
+}
+
+bool XmlStreamDeserializer::isValid() const
+{
+	return d->m_current >= 0;
+}
+
+/*!
+ * \brief 副本与本对象共享节点索引（隐式共享），只复制当前位置
+ */
+XmlDeserializer * XmlStreamDeserializer::clone() const
+{
+	XmlStreamDeserializer *deserializer = new XmlStreamDeserializer;
+	deserializer->m_filename = m_filename;
+	*deserializer->d = *d;
+	deserializer->d->m_collections.clear();
+	return deserializer;
+}
+
+QString XmlStreamDeserializer::errorString() const
+{
+	return d->m_errorString;
+}
+
+void XmlStreamDeserializer::deserialize( const QString &key, int &data )
+{
+	QString value;
+	if (d->attribute(d->m_current, key, &value))
+		data = value.toInt();
+}
+
+void XmlStreamDeserializer::deserialize( const QString &key, bool &data )
+{
+	QString value;
+	if (d->attribute(d->m_current, key, &value))
+		data = value == QLatin1String(Constants::XML_VALUE_TRUE) || value == QLatin1String("1");
+}
+
+void XmlStreamDeserializer::deserialize( const QString &key, double &data )
+{
+	QString value;
+	if (d->attribute(d->m_current, key, &value))
+		data = value.toDouble();
+}
+
+void XmlStreamDeserializer::deserialize( const QString &key, float &data )
+{
+	QString value;
+	if (d->attribute(d->m_current, key, &value))
+		data = value.toFloat();
+}
+
+void XmlStreamDeserializer::deserialize( const QString &key, QString &data )
+{
+	d->attribute(d->m_current, key, &data);
+}
+
+void XmlStreamDeserializer::deserializeBinary( const QString &key, QByteArray &data )
+{
+	QString value;
+	if (d->attribute(d->m_current, key, &value))
+		data = QByteArray::fromBase64(value.toLatin1());
+}
+
+void XmlStreamDeserializer::deserialize( const QString &key, XmlSerializable &data )
+{
+	const int child = d->findChild(d->m_current, key);
+	if (child < 0)
+		return;
+	const int current = d->m_current;
+	d->m_current = child;
+	data.deserialize(*this);
+	d->m_current = current;
+}
+
+bool XmlStreamDeserializer::beginCollection( const QString &key )
+{
+	const int child = d->findChild(d->m_current, key);
+	if (child < 0)
+		return false;
+	XmlStreamDeserializerPrivate::Collection collection;
+	collection.parent = d->m_current;
+	collection.collection = child;
+	collection.item = -1;
+	d->m_collections.append(collection);
+	d->m_current = child;
+	return true;
+}
+
+bool XmlStreamDeserializer::nextItem( const QString &itemKey, QString *type )
+{
+	if (d->m_collections.isEmpty())
+		return false;
+	XmlStreamDeserializerPrivate::Collection &collection = d->m_collections.last();
+	collection.item = d->findChild(collection.collection, itemKey, collection.item);
+	if (collection.item < 0)
+	{
+		d->m_current = collection.collection;
+		return false;
+	}
+	d->m_current = collection.item;
+	if (type)
+	{
+		type->clear();
+		d->attribute(collection.item, QLatin1String(Constants::XML_NODE_TYPE), type);
+	}
+	return true;
+}
+
+void XmlStreamDeserializer::endCollection()
+{
+	if (!d->m_collections.isEmpty())
+		d->m_current = d->m_collections.takeLast().parent;
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef XMLSTREAMDESERIALIZER_H
+#define XMLSTREAMDESERIALIZER_H
+
+#include "xmldeserializer.h"
+
+namespace Utils{
+
+class XmlStreamDeserializerPrivate;
+
+/*!
+ * \brief 不使用QDomDocument读取XML文件
+ *
+ * 用QXmlStreamReader从文件中顺序读取一遍，只记录节点的键、属性和父子关系：
+ * 键名只保存一份，所有属性值连续保存在一个字符串中，不建立DOM节点。
+ * 由于反序列化接口按键随机访问，节点的索引需要保留到析构为止，但内存占用接近文件大小。
+ * 读取的文件与XmlDeserializer相同。
+ */
+class TOTEM_UTILS_EXPORT XmlStreamDeserializer : public XmlDeserializer
+{
+public:
+	XmlStreamDeserializer(const QString &filename = QLatin1String(""));
+	virtual ~XmlStreamDeserializer();
+
+	virtual bool isValid() const;
+	virtual XmlDeserializer *clone() const;
+	QString errorString() const;
+
+	using XmlDeserializer::deserialize;
+	virtual void deserialize(const QString &key, int &data);
+	virtual void deserialize(const QString &key, bool &data);
+	virtual void deserialize(const QString &key, double &data);
+	virtual void deserialize(const QString &key, float &data);
+	virtual void deserialize(const QString &key, QString &data);
+	virtual void deserializeBinary(const QString &key, QByteArray &data);
+	virtual void deserialize(const QString &key, XmlSerializable &data);
+
+protected:
+	virtual bool beginCollection(const QString &key);
+	virtual bool nextItem(const QString &itemKey, QString *type = 0);
+	virtual void endCollection();
+
+	XmlStreamDeserializerPrivate *d;
+};
+
+}
+
+#endif // XMLSTREAMDESERIALIZER_H
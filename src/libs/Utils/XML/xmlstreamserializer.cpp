@@ -0,0 +1,170 @@
+#include "xmlstreamserializer.h"
+#include "xmlserializable.h"
+#include "../utilsconstants.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+#include <QXmlStreamWriter>
+
+namespace Utils{
+
+class XmlStreamSerializerPrivate
+{
+public:
+	struct Element
+	{
+		Element() : bHasChildren(false) { }
+		QStringList	attributes;		//!< 已经写出的属性
+		bool		bHasChildren;
+	};
+
+	void startElement(const QString &key);
+	void endElement();
+	void writeAttribute(const QString &key, const QString &value);
+
+	QSaveFile			m_file;
+	QXmlStreamWriter	m_writer;
+	QList<Element>		m_elements;		//!< 还没有结束的节点
+	QString				m_errorString;
+};
+
+void XmlStreamSerializerPrivate::startElement(const QString &key)
+{
+	if (!m_elements.isEmpty())
+		m_elements.last().bHasChildren = true;
+	m_writer.writeStartElement(key);
+	m_elements.append(Element());
+}
+
+void XmlStreamSerializerPrivate::endElement()
+{
+	if (m_elements.isEmpty())
+		return;
+	m_writer.writeEndElement();
+	m_elements.removeLast();
+}
+
+/*!
+ * \brief 写当前节点的属性
+ *
+ * 子节点已经写出或者属性重复时不能再写，这时只给出警告。
+ */
+void XmlStreamSerializerPrivate::writeAttribute(const QString &key, const QString &value)
+{
+	if (m_elements.isEmpty())
+		return;
+	Element &element = m_elements.last();
+	if (element.bHasChildren || element.attributes.contains(key))
+	{
+		qWarning() << "XmlStreamSerializer: attribute" << key << "cannot be written to" << m_file.fileName();
+		return;
+	}
+	element.attributes.append(key);
+	m_writer.writeAttribute(key, value);
+}
+
+//----------------------------------------------
+XmlStreamSerializer::XmlStreamSerializer( const QString &filepath )
+	: XmlSerializer(filepath),
+	d(new XmlStreamSerializerPrivate)
+{
+	d->m_file.setFileName(filepath);
+	if (!d->m_file.open(QIODevice::WriteOnly))
+	{
+		d->m_errorString = d->m_file.errorString();
+		return;
+	}
+	d->m_writer.setDevice(&d->m_file);
+	d->m_writer.setAutoFormatting(true);
+	d->m_writer.setAutoFormattingIndent(4);
+	d->m_writer.writeStartDocument();
+	d->startElement(QLatin1String(Constants::XML_ROOT));
+	d->writeAttribute(QLatin1String(Constants::XML_VERSION_ATRRIBUTE), QLatin1String(Constants::XML_VERSION));
+}
+
+XmlStreamSerializer::~XmlStreamSerializer()
+{
+	delete d;
+}
+
+void XmlStreamSerializer::serialize( const QString &key, const int &data )
+{
+	d->writeAttribute(key, QString::number(data));
+}
+
+void XmlStreamSerializer::serialize( const QString &key, const bool &data )
+{
+	d->writeAttribute(key, QLatin1String(data ? Constants::XML_VALUE_TRUE : Constants::XML_VALUE_FALSE));
+}
+
+void XmlStreamSerializer::serialize( const QString &key, const float &data )
+{
+	d->writeAttribute(key, QString::number(data, 'g', 9));
+}
+
+void XmlStreamSerializer::serialize( const QString &key, const double &data )
+{
+	d->writeAttribute(key, QString::number(data, 'g', 17));
+}
+
+void XmlStreamSerializer::serialize( const QString &key, const QString &data )
+{
+	d->writeAttribute(key, data);
+}
+
+void XmlStreamSerializer::serialize( const QString &key, const XmlSerializable &data )
+{
+	d->startElement(key);
+	///
+	/// 类型必须在子节点之前写出，XmlSerializer中是在最后添加的
+	if (!data.serializableType().isEmpty())
+		d->writeAttribute(QLatin1String(Constants::XML_NODE_TYPE), data.serializableType());
+	data.serialize(*this);
+	d->endElement();
+}
+
+void XmlStreamSerializer::serializeBinary( const QString &key, const QByteArray &data )
+{
+	d->writeAttribute(key, QString::fromLatin1(data.toBase64()));
+}
+
+void XmlStreamSerializer::beginCollection( const QString &key )
+{
+	d->startElement(key);
+}
+
+void XmlStreamSerializer::endCollection()
+{
+	///
+	/// 根节点由write()结束
+	if (d->m_elements.size() > 1)
+		d->endElement();
+}
+
+bool XmlStreamSerializer::write( const QString &filePath )
+{
+	if (!filePath.isEmpty() && QFileInfo(filePath).absoluteFilePath() != QFileInfo(m_filepath).absoluteFilePath())
+	{
+		d->m_errorString = QLatin1String("XmlStreamSerializer can only write to the file given to the constructor.");
+		return false;
+	}
+	if (!d->m_file.isOpen())
+		return false;
+	while (!d->m_elements.isEmpty())
+		d->endElement();
+	d->m_writer.writeEndDocument();
+	if (d->m_writer.hasError() || !d->m_file.commit())
+	{
+		d->m_errorString = d->m_file.errorString();
+		return false;
+	}
+	return true;
+}
+
+QString XmlStreamSerializer::errorString() const
+{
+	return d->m_errorString;
+}
+
+}
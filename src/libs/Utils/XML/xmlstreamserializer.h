@@ -0,0 +1,45 @@
+#ifndef XMLSTREAMSERIALIZER_H
+#define XMLSTREAMSERIALIZER_H
+
+#include "xmlserializer.h"
+
+namespace Utils{
+
+class XmlStreamSerializerPrivate;
+
+/*!
+ * \brief 直接写文件的XML序列化
+ *
+ * 生成与XmlSerializer相同的XML，但是通过QXmlStreamWriter边序列化边写到构造时指定的文件，
+ * 不在内存中建立QDomDocument。由于开始标签写出之后就不能再添加属性，
+ * XmlSerializable::serialize()中的数值和字符串需要在子节点之前写出（现有的实现都是如此）。
+ * write()结束文档并替换目标文件，没有调用write()时目标文件保持不变。
+ */
+class TOTEM_UTILS_EXPORT XmlStreamSerializer : public XmlSerializer
+{
+public:
+	XmlStreamSerializer(const QString &filepath);
+	virtual ~XmlStreamSerializer();
+
+	using XmlSerializer::serialize;
+	virtual void serialize(const QString &key, const int &data);
+	virtual void serialize(const QString &key, const bool &data);
+	virtual void serialize(const QString &key, const float &data);
+	virtual void serialize(const QString &key, const double &data);
+	virtual void serialize(const QString &key, const QString &data);
+	virtual void serialize(const QString &key, const XmlSerializable &data);
+	virtual void serializeBinary(const QString &key, const QByteArray &data);
+
+	virtual bool write(const QString &filePath = QString());	//!< \e filePath 为空或者与构造时相同
+	QString errorString() const;
+
+protected:
+	virtual void beginCollection(const QString &key);
+	virtual void endCollection();
+
+	XmlStreamSerializerPrivate *d;
+};
+
+}
+
+#endif // XMLSTREAMSERIALIZER_H
@@ -11,6 +11,10 @@ const char XML_ROOT[]				= "XML";
 const char XML_VALUE_TRUE[]			= "true";
 const char XML_VALUE_FALSE[]		= "false";
 const char XML_NODE_TYPE[]				= "type";
+
+const char BINARY_MAGIC[]			= "TOTEMBIN";	//!< 二进制文件开头的8个字节
+const int  BINARY_VERSION_MAJOR		= 1;			//!< 不兼容的格式修改时增加
+const int  BINARY_VERSION_MINOR		= 0;			//!< 兼容的扩展时增加
 }/// namespace Constants
 }/// namespace Utils
 #endif
\ No newline at end of file
@@ -26,6 +26,16 @@ PluginManager::~PluginManager()
     }
 }
 
+void PluginManager::setHeadless(bool bHeadless)
+{
+    d->m_bHeadless = bHeadless;
+}
+
+bool PluginManager::isHeadless() const
+{
+    return d->m_bHeadless;
+}
+
 void PluginManager::setSettings(QSettings *settings)
 {
     d->setSettings(settings);
@@ -68,6 +78,13 @@ QList<QObject *> PluginManager::getAllObjects() const
     return d->allObjects;
 }
 
+//对象池中可以转换为type的对象，以及属于某个Aggregate的对象（由query_all()在其中查找）
+//结果按类型缓存在d->objectIndex中，addObject()和removeObject()时逐个更新
+QList<QObject *> PluginManager::objectsOfType(const QMetaObject *type) const
+{
+    return d->objectsOfType(type);
+}
+
 QObject *PluginManager::getObjectByName(const QString &name) const
 {
     QReadLocker lock(&m_lock);
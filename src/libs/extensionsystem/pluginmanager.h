@@ -43,29 +43,22 @@ public:
     void removeObject(QObject *obj);
     QList<QObject*> getAllObjects()const;
 
+    //getObjects<T>()和getObject<T>()按T::staticMetaObject查找缓存的对象列表，T需要有Q_OBJECT，
+    //否则按其父类查找；只用Q_DECLARE_INTERFACE声明的接口没有staticMetaObject，遍历全部对象
     template <typename T> QList<T*> getObjects() const
     {
         QReadLocker lock(&m_lock);
         QList<T*> results;
-        QList<QObject*> all = getAllObjects();
-        QList<T*> result;
-        foreach(QObject *obj, all)
-        {
-            result = Aggregation::query_all<T>(obj);
-            if (!result.isEmpty())
-            {
-                results += result;
-            }
-        }
+        foreach (QObject *obj, objectsOfType(Aggregation::Internal::IndexKey<T>::metaObject()))
+            results += Aggregation::query_all<T>(obj);
         return results;
     }
 
     template <typename T> T *getObject() const
     {
         QReadLocker lock(&m_lock);
-        QList<QObject *> all = getAllObjects();
         T *result = 0;
-        foreach (QObject *obj, all)
+        foreach (QObject *obj, objectsOfType(Aggregation::Internal::IndexKey<T>::metaObject()))
         {
             if ((result = Aggregation::query<T>(obj)) != 0)
                 break;
@@ -92,6 +85,10 @@ public:
     void setFileExtension(const QString &extension);
     QString fileExtension() const;
     bool hasError() const;
+
+    //无界面模式，命令行工具使用，插件不应该创建窗口
+    void setHeadless(bool bHeadless);
+    bool isHeadless() const;
     Internal::PluginManagerPrivate *d;
 
 signals:
@@ -104,6 +101,8 @@ public slots:
     void remoteArguments(const QString &serializedArguments);
     void shutdown();
 private:
+    QList<QObject *> objectsOfType(const QMetaObject *type) const;//调用者持有m_lock，type为0时返回全部对象
+
     static PluginManager *m_instance;
 
     mutable QReadWriteLock m_lock;
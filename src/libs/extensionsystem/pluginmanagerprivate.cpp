@@ -5,12 +5,16 @@
 #include "iplugin.h"
 #include "plugincollection.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QEventLoop>
 #include <QDateTime>
 #include <QDir>
 #include <QMetaProperty>
+#include <QSaveFile>
 #include <QSettings>
 #include <QTextStream>
+#include <QThreadPool>
 #include <QTime>
 #include <QWriteLocker>
 #include <QtDebug>
@@ -22,9 +26,27 @@ static const char C_DEFAULT_EXTENSION[] = "xml";
 static const char C_IGNORED_PLUGINS[] = "Plugins/Ignored";
 static const char C_FORCEENABLED_PLUGINS[] = "Plugins/ForceEnabled";
 static const int DELAYED_INITIALIZE_INTERVAL = 20; // ms
+static const quint32 PLUGIN_CACHE_MAGIC = 0x54504c43; // "TPLC"
+static const quint32 PLUGIN_CACHE_VERSION = 1;
 
 typedef QList<ExtensionSystem::PluginSpec *> PluginSpecSet;
 
+namespace {
+
+//在线程池中读取一个插件描述文件
+class SpecReader : public QRunnable
+{
+public:
+    SpecReader(PluginSpecPrivate *spec, const QString &fileName)
+        : m_spec(spec), m_fileName(fileName) {}
+    void run() { m_spec->read(m_fileName); }
+private:
+    PluginSpecPrivate *m_spec;
+    QString m_fileName;
+};
+
+}
+
 static bool lessThanByPluginName(const PluginSpec *one, const PluginSpec *two)
 {
     return one->name() < two->name();
@@ -36,10 +58,12 @@ PluginManagerPrivate::PluginManagerPrivate(PluginManager *pMgr):
     m_extension(QLatin1String(C_DEFAULT_EXTENSION)),
     m_settings(0),
     m_globalSettings(0),
+    objectIndexGeneration(Aggregation::Aggregate::generation()),
     q(pMgr),
     m_shutdownEventLoop(0),
     m_profileElapsedMS(0),
     m_profilingVerbosity(0),
+    m_bHeadless(false),
     m_delayedInitializeTimer(0)
 {
 }
@@ -275,26 +299,39 @@ void PluginManagerPrivate::readPluginPaths()
     m_pluginSpecs.clear();
     m_pluginCategories.clear();
 
-    QStringList specFiles;
-    QStringList searchPaths = m_pluginPaths;
-    while (!searchPaths.isEmpty())
-    {
-        const QDir dir(searchPaths.takeFirst());
-        const QString pattern = QLatin1String("*.") + m_extension;
-        const QFileInfoList files = dir.entryInfoList(QStringList(pattern), QDir::Files);
-        foreach (const QFileInfo &file, files)
-            specFiles << file.absoluteFilePath();
-        const QFileInfoList dirs = dir.entryInfoList(QDir::Dirs|QDir::NoDotAndDotDot);
-        foreach (const QFileInfo &subdir, dirs)
-            searchPaths << subdir.absoluteFilePath();
-    }
     defaultCollection = new PluginCollection(QString());
     m_pluginCategories.insert("", defaultCollection);
 
-    foreach (const QString &specFile, specFiles)
+    //插件缓存有效时不再遍历插件文件夹和解析插件描述文件
+    QList<PluginSpec *> specs;
+    QFileInfoList dirs;
+    QFileInfoList specFiles;
+    const bool bCached = readPluginCache(specs);
+    if (!bCached)
+    {
+        foreach (const QString &path, m_pluginPaths)
+            dirs << QFileInfo(path);
+        for (int i = 0; i < dirs.size(); ++i)
+        {
+            const QDir dir(dirs.at(i).absoluteFilePath());
+            const QString pattern = QLatin1String("*.") + m_extension;
+            specFiles << dir.entryInfoList(QStringList(pattern), QDir::Files);
+            dirs << dir.entryInfoList(QDir::Dirs|QDir::NoDotAndDotDot);
+        }
+
+        //插件描述文件互不相关，在线程池中同时读取
+        QThreadPool pool;
+        foreach (const QFileInfo &specFile, specFiles)
+        {
+            PluginSpec *spec = new PluginSpec;
+            specs.append(spec);
+            pool.start(new SpecReader(spec->d, specFile.absoluteFilePath()));
+        }
+        pool.waitForDone();
+    }
+
+    foreach (PluginSpec *spec, specs)
     {
-        PluginSpec *spec = new PluginSpec;
-        spec->d->read(specFile);
 
         PluginCollection *collection = 0;
         //查找插件分类，没有就添加一个分类
@@ -319,11 +356,167 @@ void PluginManagerPrivate::readPluginPaths()
         collection->addPlugin(spec);
         m_pluginSpecs.append(spec);
     }
-    resolveDependencies();
+    if (bCached)
+    {
+        updateDisabledIndirectly();//依赖关系已经从缓存恢复
+    }
+    else
+    {
+        resolveDependencies();
+        writePluginCache(dirs, specFiles);
+    }
     qSort(m_pluginSpecs.begin(), m_pluginSpecs.end(), lessThanByPluginName);
     emit q->pluginsChanged();
 }
 
+/*!
+  \fn pluginCacheFileName()
+  \brief 插件缓存文件，与用户设置放在同一个文件夹中
+
+  文件名中包含插件路径和扩展名的散列值，插件路径不同的程序使用不同的缓存。
+  没有设置m_settings时不使用缓存。
+*/
+QString PluginManagerPrivate::pluginCacheFileName() const
+{
+    if (!m_settings || m_pluginPaths.isEmpty())
+        return QString();
+    const QByteArray key = (m_pluginPaths.join(QLatin1String("\n")) + QLatin1Char('\n') + m_extension).toUtf8();
+    const QByteArray hash = QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex().left(12);
+    return QFileInfo(m_settings->fileName()).absolutePath()
+            + QLatin1String("/plugincache-") + QLatin1String(hash) + QLatin1String(".dat");
+}
+
+/*!
+  \fn readPluginCache()
+  \brief 从缓存中恢复插件描述和依赖关系
+
+  缓存中记录了遍历过的每一个文件夹和插件描述文件的修改时间，
+  文件夹的修改时间在增删文件时改变，插件描述文件还要比较大小。
+  只需要对这些路径各取一次文件信息，不需要列出文件夹或打开文件。
+  任何一项不一致都返回false，由调用者重新读取并重建缓存。
+*/
+bool PluginManagerPrivate::readPluginCache(QList<PluginSpec *> &specs)
+{
+    const QString fileName = pluginCacheFileName();
+    if (fileName.isEmpty())
+        return false;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QStringList pluginPaths;
+    QString extension;
+    in >> magic >> version;
+    if (magic != PLUGIN_CACHE_MAGIC || version != PLUGIN_CACHE_VERSION)
+        return false;
+    in >> pluginPaths >> extension;
+    if (pluginPaths != m_pluginPaths || extension != m_extension)
+        return false;
+
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count; ++i)
+    {
+        QString path;
+        qint64 modified = 0;
+        in >> path >> modified;
+        const QFileInfo info(path);
+        const qint64 current = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+        if (in.status() != QDataStream::Ok || current != modified)
+            return false;
+    }
+
+    in >> count;
+    bool bValid = in.status() == QDataStream::Ok;
+    for (quint32 i = 0; bValid && i < count; ++i)
+    {
+        QString path;
+        qint64 modified = 0;
+        qint64 size = 0;
+        in >> path >> modified >> size;
+        const QFileInfo info(path);
+        PluginSpec *spec = new PluginSpec;
+        specs.append(spec);
+        bValid = in.status() == QDataStream::Ok
+                && info.isFile()
+                && info.lastModified().toMSecsSinceEpoch() == modified
+                && info.size() == size
+                && spec->d->readCache(in);
+    }
+    //已经解决的依赖关系：依赖项序号 -> 插件序号
+    for (int i = 0; bValid && i < specs.size(); ++i)
+    {
+        PluginSpecPrivate *spec = specs.at(i)->d;
+        in >> count;
+        for (quint32 j = 0; bValid && j < count; ++j)
+        {
+            qint32 dependency = -1;
+            qint32 target = -1;
+            in >> dependency >> target;
+            bValid = in.status() == QDataStream::Ok
+                    && dependency >= 0 && dependency < spec->dependencies.size()
+                    && target >= 0 && target < specs.size();
+            if (bValid)
+                spec->dependencySpecs.insert(spec->dependencies.at(dependency), specs.at(target));
+        }
+    }
+    if (!bValid)
+    {
+        qDeleteAll(specs);
+        specs.clear();
+    }
+    return bValid;
+}
+
+/*!
+  \fn writePluginCache()
+  \brief 把readPluginPaths()和resolveDependencies()的结果写入缓存
+*/
+void PluginManagerPrivate::writePluginCache(const QFileInfoList &dirs, const QFileInfoList &specFiles)
+{
+    const QString fileName = pluginCacheFileName();
+    if (fileName.isEmpty())
+        return;
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << PLUGIN_CACHE_MAGIC << PLUGIN_CACHE_VERSION << m_pluginPaths << m_extension;
+
+    out << quint32(dirs.size());
+    foreach (const QFileInfo &dir, dirs)
+        out << dir.absoluteFilePath() << (dir.exists() ? dir.lastModified().toMSecsSinceEpoch() : qint64(-1));
+
+    //m_pluginSpecs还没有排序，与specFiles的顺序一致
+    Q_ASSERT(specFiles.size() == m_pluginSpecs.size());
+    out << quint32(specFiles.size());
+    for (int i = 0; i < specFiles.size(); ++i)
+    {
+        const QFileInfo &info = specFiles.at(i);
+        out << info.absoluteFilePath() << info.lastModified().toMSecsSinceEpoch() << info.size();
+        m_pluginSpecs.at(i)->d->writeCache(out);
+    }
+    foreach (PluginSpec *spec, m_pluginSpecs)
+    {
+        const PluginSpecPrivate *d = spec->d;
+        out << quint32(d->dependencySpecs.size());
+        for (int i = 0; i < d->dependencies.size(); ++i)
+        {
+            const PluginDependency &dependency = d->dependencies.at(i);
+            if (!d->dependencySpecs.contains(dependency) || d->dependencies.indexOf(dependency) != i)
+                continue;
+            out << qint32(i) << qint32(m_pluginSpecs.indexOf(d->dependencySpecs.value(dependency)));
+        }
+    }
+    if (out.status() == QDataStream::Ok)
+        file.commit();
+}
+
 /*!
   \fn resolveDependencies()
   \brief 解决依赖关系
@@ -336,6 +529,11 @@ void PluginManagerPrivate::resolveDependencies()
     {
         spec->d->resolveDependencies(m_pluginSpecs);
     }
+    updateDisabledIndirectly();
+}
+
+void PluginManagerPrivate::updateDisabledIndirectly()
+{
     //先loadQueue()排一下载入的顺序，然后每个插件根据自己所依赖的插件的状态，
     //修改自己的状态，如果所依赖的插件不可用，那么自己也不可用
     foreach(PluginSpec *spec, loadQueue())
@@ -471,6 +669,13 @@ void PluginManagerPrivate::addObject(QObject *obj)
             qDebug("  %-43s %8dms", obj->metaObject()->className(), absoluteElapsedMS);
         }
         allObjects.append(obj);
+        QMutexLocker indexLock(&objectIndexMutex);
+        QHash<const QMetaObject *, QList<QObject *> >::iterator it = objectIndex.begin();
+        for (; it != objectIndex.end(); ++it)
+        {
+            if (isCandidate(obj, it.key()))
+                it.value().append(obj);
+        }
     }
     emit q->objectAdded(obj);
 }
@@ -497,6 +702,47 @@ void PluginManagerPrivate::removeObject(QObject *obj)
     emit q->aboutToRemoveObject(obj);
     QWriteLocker lock(&(q->m_lock));
     allObjects.removeAll(obj);
+    QMutexLocker indexLock(&objectIndexMutex);
+    QHash<const QMetaObject *, QList<QObject *> >::iterator it = objectIndex.begin();
+    for (; it != objectIndex.end(); ++it)
+        it.value().removeAll(obj);
+}
+
+//第一次查询某个类型时遍历一次对象池，之后直接返回缓存的结果
+//对象加入或离开Aggregate之后isCandidate()的结果会改变，此时丢弃全部缓存
+QList<QObject *> PluginManagerPrivate::objectsOfType(const QMetaObject *type)
+{
+    if (!type)
+        return allObjects;
+    QMutexLocker indexLock(&objectIndexMutex);
+    const int generation = Aggregation::Aggregate::generation();
+    if (generation != objectIndexGeneration)
+    {
+        objectIndex.clear();
+        objectIndexGeneration = generation;
+    }
+    QHash<const QMetaObject *, QList<QObject *> >::const_iterator it = objectIndex.constFind(type);
+    if (it != objectIndex.constEnd())
+        return it.value();
+    QList<QObject *> objects;
+    foreach (QObject *obj, allObjects)
+    {
+        if (isCandidate(obj, type))
+            objects.append(obj);
+    }
+    objectIndex.insert(type, objects);
+    return objects;
+}
+
+//对象本身可以转换为type，或者属于某个Aggregate
+//Aggregate中的components可能改变，所以总是保留，由query_all()在查询时判断；
+//不属于Aggregate的对象之后加入Aggregate时由objectsOfType()中的generation检查重建索引
+bool PluginManagerPrivate::isCandidate(QObject *obj, const QMetaObject *type) const
+{
+    if (type->cast(obj))
+        return true;
+    QReadLocker lock(&Aggregation::Aggregate::lock());
+    return Aggregation::Aggregate::parentAggregate(obj) != 0;
 }
 
 PluginSpec *PluginManagerPrivate::pluginForOption(const QString &option, bool *requiresArgument) const
@@ -3,6 +3,9 @@
 
 #include "pluginspec.h"
 
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
 #include <QObject>
 #include <QStringList>
 #include <QScopedPointer>
@@ -47,6 +50,7 @@ public:
 
     void shutdown();
     void resolveDependencies();//解决依赖关系
+    void updateDisabledIndirectly();//根据所依赖插件的状态设置间接禁用
     QList<PluginSpec *> loadQueue();//根据依赖关系排一下载入的顺序
 
     void initProfiling();
@@ -56,6 +60,8 @@ public:
     //对象池
     void addObject(QObject *obj);
     void removeObject(QObject *obj);
+    QList<QObject *> objectsOfType(const QMetaObject *type);//调用者持有q->m_lock，type为0时返回全部对象
+    bool isCandidate(QObject *obj, const QMetaObject *type) const;
 
 
     QString m_extension;//插件文件扩展名,默认为XML格式
@@ -66,6 +72,9 @@ public:
     QStringList m_disabledPlugins;
     QStringList m_forceEnabledPlugins;
     QList<QObject *> allObjects;//所有对象
+    QHash<const QMetaObject *, QList<QObject *> > objectIndex;//类型-->可能包含该类型的对象，按照allObjects中的顺序
+    QMutex objectIndexMutex;//读锁之下填充objectIndex
+    int objectIndexGeneration;//建立objectIndex时的Aggregate::generation()，改变后objectIndex全部重建
     QHash<QString, PluginCollection *> m_pluginCategories;
     QList<PluginSpec *> m_pluginSpecs;
 
@@ -83,6 +92,7 @@ public:
     QScopedPointer<QTime> m_profileTimer;
     int m_profileElapsedMS;
     unsigned m_profilingVerbosity;
+    bool m_bHeadless;//无界面模式
 
     //访问选项说明的参数描述
     PluginSpec *pluginForOption(const QString &option, bool *requiresArgument) const;
@@ -103,6 +113,9 @@ private:
     PluginCollection *defaultCollection;
     PluginManager *q;
     void readPluginPaths();
+    QString pluginCacheFileName() const;
+    bool readPluginCache(QList<PluginSpec *> &specs);
+    void writePluginCache(const QFileInfoList &dirs, const QFileInfoList &specFiles);
     bool loadQueue(PluginSpec *spec,
             QList<PluginSpec *> &queue,
             QList<PluginSpec *> &circularityCheckQueue);
@@ -2,6 +2,7 @@
 #include "ipluginprivate.h"
 #include "pluginspecprivate.h"
 
+#include <QDataStream>
 #include <QFile>
 #include <QDir>
 #include <QFileInfo>
@@ -91,6 +92,57 @@ bool PluginSpecPrivate::read(const QString &fileName)
     return true;
 }
 
+void PluginSpecPrivate::writeCache(QDataStream &out) const
+{
+    out << name << version << compatVersion << experimental
+        << creator << copyright << license << description << url << category
+        << location << filePath;
+    out << quint32(dependencies.size());
+    foreach (const PluginDependency &dependency, dependencies)
+        out << dependency.name << dependency.version << qint32(dependency.type);
+    out << quint32(argumentDescriptions.size());
+    foreach (const PluginArgumentDescription &argument, argumentDescriptions)
+        out << argument.name << argument.parameter << argument.description;
+    out << qint32(state) << hasError << errorString;
+}
+
+bool PluginSpecPrivate::readCache(QDataStream &in)
+{
+    in >> name >> version >> compatVersion >> experimental
+       >> creator >> copyright >> license >> description >> url >> category
+       >> location >> filePath;
+    quint32 count = 0;
+    in >> count;
+    dependencies.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        PluginDependency dependency;
+        qint32 type = 0;
+        in >> dependency.name >> dependency.version >> type;
+        dependency.type = type == PluginDependency::Optional ? PluginDependency::Optional : PluginDependency::Required;
+        dependencies.append(dependency);
+    }
+    in >> count;
+    argumentDescriptions.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        PluginArgumentDescription argument;
+        in >> argument.name >> argument.parameter >> argument.description;
+        argumentDescriptions.append(argument);
+    }
+    qint32 cachedState = 0;
+    in >> cachedState >> hasError >> errorString;
+    if (cachedState != PluginSpec::Invalid && cachedState != PluginSpec::Read && cachedState != PluginSpec::Resolved)
+        return false;
+    state = PluginSpec::State(cachedState);
+    //与readPluginSpec()一致，设置中的禁用状态由PluginManagerPrivate另外处理
+    disabledByDefault = experimental;
+    enabled = !experimental;
+    disabledIndirectly = false;
+    dependencySpecs.clear();
+    return in.status() == QDataStream::Ok;
+}
+
 static inline QString msgAttributeMissing(const char *elt, const char *attribute)
 {
     return QCoreApplication::translate("PluginSpec", "'%1' misses attribute '%2'").arg(QLatin1String(elt), QLatin1String(attribute));
@@ -130,7 +182,9 @@ bool PluginSpecPrivate::provides(const QString &pluginName, const QString &plugi
 
 bool PluginSpecPrivate::isValidVersion(const QString &version)
 {
-    return versionRegExp().exactMatch(version);
+    //QRegExp匹配时会修改自身，插件描述文件在多个线程中同时读取，每次使用新的实例
+    QRegExp reg = versionRegExp();
+    return reg.exactMatch(version);
 }
 
 int PluginSpecPrivate::versionCompare(const QString &version1, const QString &version2)
@@ -154,12 +208,11 @@ int PluginSpecPrivate::versionCompare(const QString &version1, const QString &ve
     return 0;
 }
 
-QRegExp &PluginSpecPrivate::versionRegExp()
+QRegExp PluginSpecPrivate::versionRegExp()
 {
     //开头一个数，紧跟0个或者1个".数",紧跟0个或者1个".数",紧跟0个或者1个"_数"
-
-    static QRegExp reg("([0-9]+)(?:[.]([0-9]+))?(?:[.]([0-9]+))?(?:_([0-9]+))?");
-    return reg;
+    //复制静态的QRegExp会修改被复制的对象，这里每次构造新的实例，编译结果由Qt缓存
+    return QRegExp(QLatin1String("([0-9]+)(?:[.]([0-9]+))?(?:[.]([0-9]+))?(?:_([0-9]+))?"));
 }
 
 void PluginSpecPrivate::disableIndirectlyIfDependencyDisabled()
@@ -240,40 +293,45 @@ bool PluginSpecPrivate::resolveDependencies(const QList<PluginSpec *> &specs)
     return true;
 }
 
-bool PluginSpecPrivate::loadLibrary()
+QString PluginSpecPrivate::libraryPath() const
 {
-    if(hasError)
-        return false;
-    if(state != PluginSpec::Resolved)
-    {
-        if(state == PluginSpec::Loaded)
-            return true;
-        //没有解决依赖关系
-        errorString = QCoreApplication::translate("PluginSpec", "Loading the library failed because state != Resolved");
-        hasError = true;
-        return false;
-    }
 #ifdef QT_NO_DEBUG
 
 #ifdef Q_OS_WIN
-    QString libName = QString("%1/%2.dll").arg(location).arg(name);
+    return QString("%1/%2.dll").arg(location).arg(name);
 #elif defined(Q_OS_MAC)
-    QString libName = QString("%1/lib%2.dylib").arg(location).arg(name);
+    return QString("%1/lib%2.dylib").arg(location).arg(name);
 #else
-    QString libName = QString("%1/lib%2.so").arg(location).arg(name);
+    return QString("%1/lib%2.so").arg(location).arg(name);
 #endif
 
 #else //Q_NO_DEBUG
 
 #ifdef Q_OS_WIN
-    QString libName = QString("%1/%2d.dll").arg(location).arg(name);
+    return QString("%1/%2d.dll").arg(location).arg(name);
 #elif defined(Q_OS_MAC)
-    QString libName = QString("%1/lib%2_debug.dylib").arg(location).arg(name);
+    return QString("%1/lib%2_debug.dylib").arg(location).arg(name);
 #else
-    QString libName = QString("%1/lib%2.so").arg(location).arg(name);
+    return QString("%1/lib%2.so").arg(location).arg(name);
 #endif
 
 #endif
+}
+
+bool PluginSpecPrivate::loadLibrary()
+{
+    if(hasError)
+        return false;
+    if(state != PluginSpec::Resolved)
+    {
+        if(state == PluginSpec::Loaded)
+            return true;
+        //没有解决依赖关系
+        errorString = QCoreApplication::translate("PluginSpec", "Loading the library failed because state != Resolved");
+        hasError = true;
+        return false;
+    }
+    const QString libName = libraryPath();
     PluginLoader loader(libName);
     if(!loader.load())
     {
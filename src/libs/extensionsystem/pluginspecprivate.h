@@ -8,6 +8,10 @@
 #include <QStringList>
 #include <QXmlStreamReader>
 
+QT_BEGIN_NAMESPACE
+class QDataStream;
+QT_END_NAMESPACE
+
 namespace ExtensionSystem
 {
 class IPlugin;
@@ -22,9 +26,12 @@ class PluginSpecPrivate : public QObject
 public:
     PluginSpecPrivate(PluginSpec *spec);
     bool read(const QString &fileName);
+    void writeCache(QDataStream &out) const;//写入插件缓存，不包括dependencySpecs
+    bool readCache(QDataStream &in);//从插件缓存恢复read()和resolveDependencies()的结果
     //校验插件是否兼容
     bool provides(const QString &pluginName, const QString &pluginVersion) const;
     bool resolveDependencies(const QList<PluginSpec *> &specs);
+    QString libraryPath() const;
     bool loadLibrary();
     bool initializePlugin();
     bool initializeExtensions();
@@ -73,7 +80,8 @@ private:
     void readArgumentDescriptions(QXmlStreamReader &reader);
     void readArgumentDescription(QXmlStreamReader &reader);
 
-    static QRegExp &versionRegExp();
+public:
+    static QRegExp versionRegExp();//每次返回新的实例，可以在多个线程中同时使用
 };
 
 }
@@ -1,79 +1,180 @@
 ﻿#include "stdafx.h"
 #include "id.h"
 #include "utils/totemassert.h"
-#include <QHash>
+#include <stdlib.h>
+#include <string.h>
 
 namespace Core{
 /*!
     \class Core::Id
     \brief 将字符串压缩成一个int型的身份变量m_id
+
+    字符串表可以在多个线程中同时使用，不使用锁：
+    字符串到Id的查找使用开放寻址的散列表，空槽通过比较交换写入，写入之后不再改变，
+    一张表中的探测窗口写满时转到下一张两倍大小的表；Id到字符串使用分段数组，段在第一次使用时分配。
+    已经存在的字符串查找和name()只读取原子变量，不会等待其它线程。
+    两个线程同时加入同一个字符串时，较慢的一方得到的Id不会被使用，只是浪费一个编号。
 */
-class StringHolder
+namespace {
+
+const int ProbeWindow		= 16;	//!< 一张表中一个字符串最多探测的槽数
+const int FirstTableBits	= 10;
+const int SegmentBase		= 256;	//!< 第k段有SegmentBase * 2^k个Id
+const int MaxSegments		= 20;
+
+struct IdEntry
 {
-public:
+    uint	hash;
+    int		id;
+    int		length;
+    char	str[1];
+};
 
-    explicit StringHolder(const char *s)
-        : str(s)
+struct IdTable
+{
+    explicit IdTable(int b)
+        : bits(b),
+        mask((1u << b) - 1),
+        slots(new QAtomicPointer<IdEntry>[size_t(1) << b])
     {
-        n = strlen(s);
-        int m = n;
-        h = 0;
-        while (m--)
-        {
-            h = (h << 4) + *s++;
-            h ^= (h & 0xf0000000) >> 23;
-            h &= 0x0fffffff;
-        }
+        next.store(0);
     }
-	~StringHolder() {}
+    ~IdTable() { delete [] slots; }
 
-    int n;
-    const char *str;
-    uint h;
+    int							bits;
+    uint						mask;
+    QAtomicPointer<IdEntry>*	slots;
+    QAtomicPointer<IdTable>		next;
 };
 
-static bool operator==(const StringHolder &sh1, const StringHolder &sh2)
+///
+/// 只使用静态初始化的变量，其它文件的静态对象在构造时就可以创建Id
+QBasicAtomicInt						g_lastUid = Q_BASIC_ATOMIC_INITIALIZER(0);
+///
+/// 字符串表有意不在退出时释放：其它静态对象的析构函数（包括其它插件中CORE_ID缓存的Id）
+/// 可能在本文件的静态对象之后仍然调用name()或toString()，释放后会访问已释放的内存。
+/// 进程退出时由操作系统回收。
+QBasicAtomicPointer<IdTable>		g_firstTable = Q_BASIC_ATOMIC_INITIALIZER(0);
+QBasicAtomicPointer<QAtomicPointer<IdEntry> >	g_segments[MaxSegments];
+
+uint hashString(const char *s, int n)
 {
-    return sh1.h == sh2.h && strcmp(sh1.str, sh1.str) == 0;
+    uint h = 0;
+    while (n--)
+        h = Id::hashStep(h, uchar(*s++));
+    return h;
 }
 
-static uint qHash(const StringHolder &sh)
+IdTable *createOnce(QBasicAtomicPointer<IdTable> &pointer, IdTable *created)
 {
-    return sh.h;
+    if (pointer.testAndSetOrdered(0, created))
+        return created;
+    delete created;
+    return pointer.loadAcquire();
 }
 
-class IdCache : public QHash<StringHolder, int>
+IdTable *firstTable()
 {
-public:
+    IdTable *table = g_firstTable.loadAcquire();
+    return table ? table : createOnce(g_firstTable, new IdTable(FirstTableBits));
+}
 
-	~IdCache()
+IdTable *nextTable(IdTable *table)
+{
+    IdTable *next = table->next.loadAcquire();
+    return next ? next : createOnce(table->next, new IdTable(table->bits + 1));
+}
+
+/*!
+ * \brief Id所在的段和段内的位置
+ */
+bool locate(int id, int *segment, int *offset)
+{
+    int index = id;
+    int size = SegmentBase;
+    for (int i = 0; i < MaxSegments; ++i, size *= 2)
     {
-        for (IdCache::iterator it = begin(); it != end(); ++it)
-            free(const_cast<char *>(it.key().str));
+        if (index < size)
+        {
+            *segment = i;
+            *offset = index;
+            return true;
+        }
+        index -= size;
     }
-};
+    return false;
+}
 
-static int		g_lastUid = 0;
-static QVector<QByteArray> stringFromId;
-static IdCache	g_idFromString;
+IdEntry *entryOf(int id)
+{
+    int segment, offset;
+    if (id <= 0 || !locate(id, &segment, &offset))
+        return 0;
+    QAtomicPointer<IdEntry> *entries = g_segments[segment].loadAcquire();
+    return entries ? entries[offset].loadAcquire() : 0;
+}
 
-static int genId(const char *str)
+IdEntry *createEntry(const char *str, int n, uint h)
 {
-    TOTEM_ASSERT(str && *str, return 0);
-    
-	StringHolder sh(str);
-    int res = g_idFromString.value(sh, 0);
-    if (res == 0)
+    IdEntry *entry = static_cast<IdEntry*>(malloc(sizeof(IdEntry) + n));
+    entry->hash = h;
+    entry->length = n;
+    memcpy(entry->str, str, n);
+    entry->str[n] = 0;
+    entry->id = g_lastUid.fetchAndAddOrdered(1) + 1;
+    int segment, offset;
+    if (!locate(entry->id, &segment, &offset))
+        qFatal("Core::Id: too many ids");
+    QAtomicPointer<IdEntry> *entries = g_segments[segment].loadAcquire();
+    if (!entries)
     {
-        if (g_lastUid == 0)
-            stringFromId.append(QByteArray());
-        res = ++g_lastUid;
+        QAtomicPointer<IdEntry> *created = new QAtomicPointer<IdEntry>[size_t(SegmentBase) << segment];
+        if (g_segments[segment].testAndSetOrdered(0, created))
+            entries = created;
+        else
+        {
+            delete [] created;
+            entries = g_segments[segment].loadAcquire();
+        }
+    }
+    ///
+    /// 先写入分段数组再放入散列表，得到Id的线程一定可以取得字符串
+    entries[offset].storeRelease(entry);
+    return entry;
+}
+
+int genId(const char *str, int n, uint h)
+{
+    TOTEM_ASSERT(str && n > 0, return 0);
 
-        sh.str = strdup(sh.str);//这里由调用者负责管理内存
-        g_idFromString[sh] = res;
-        stringFromId.append(QByteArray::fromRawData(sh.str, sh.n));
+    IdEntry *created = 0;
+    for (IdTable *table = firstTable(); ; table = nextTable(table))
+    {
+        for (int i = 0; i < ProbeWindow; ++i)
+        {
+            QAtomicPointer<IdEntry> &slot = table->slots[(h + i) & table->mask];
+            IdEntry *entry = slot.loadAcquire();
+            if (!entry)
+            {
+                if (!created)
+                    created = createEntry(str, n, h);
+                if (slot.testAndSetOrdered(0, created))
+                    return created->id;
+                entry = slot.loadAcquire();
+            }
+            if (entry->hash == h && entry->length == n && memcmp(entry->str, str, n) == 0)
+                return entry->id;
+        }
     }
-    return res;
+}
+
+int genId(const char *str)
+{
+    TOTEM_ASSERT(str && *str, return 0);
+    const int n = int(strlen(str));
+    return genId(str, n, hashString(str, n));
+}
+
 }
 
 Id::Id(const char *name)
@@ -84,14 +185,27 @@ Id::Id(const QString &name)
    : m_id(genId(name.toLatin1()))
 {}
 
+Id Id::fromLiteral(const char *name, int length, uint hash, QBasicAtomicInt &cache)
+{
+    int id = cache.loadAcquire();
+    if (!id)
+    {
+        id = genId(name, length, hash);
+        cache.storeRelease(id);
+    }
+    return Id(id);
+}
+
 QByteArray Id::name() const
 {
-    return stringFromId.at(m_id);
+    const IdEntry *entry = entryOf(m_id);
+    return entry ? QByteArray::fromRawData(entry->str, entry->length) : QByteArray();
 }
 
 QString Id::toString() const
 {
-    return QString::fromLatin1(stringFromId[m_id]);
+    const IdEntry *entry = entryOf(m_id);
+    return entry ? QString::fromLatin1(entry->str, entry->length) : QString();
 }
 
 }
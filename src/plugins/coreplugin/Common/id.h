@@ -1,4 +1,5 @@
 #pragma once
+#include <QAtomicInt>
 #include <QMetaType>
 #include "../core_global.h"
 
@@ -24,6 +25,12 @@ public:
     int uniqueIdentifier() const { return m_id; }
     static Id fromUniqueIdentifier(int uid) { return Id(uid); }
 
+    static Id fromLiteral(const char *name, int length, uint hash, QBasicAtomicInt &cache);
+    static Q_DECL_CONSTEXPR uint hashLiteral(const char *name, uint h = 0)
+    { return *name ? hashLiteral(name + 1, hashStep(h, uchar(*name))) : h; }
+    static Q_DECL_CONSTEXPR uint hashStep(uint h, uint c)
+    { return (((h << 4) + c) ^ ((((h << 4) + c) & 0xf0000000) >> 23)) & 0x0fffffff; }
+
 private:
 
     Id(int uid) : m_id(uid) {}
@@ -36,3 +43,10 @@ inline uint qHash(const Id &id) { return id.uniqueIdentifier(); }
 
 }
 Q_DECLARE_METATYPE(Core::Id)
+
+//! 字符串常量对应的Id，每处调用只在第一次执行时查表，之后只读取一个原子变量
+#define CORE_ID(literal) \
+    ([]() -> Core::Id { \
+        static QBasicAtomicInt cache = Q_BASIC_ATOMIC_INITIALIZER(0); \
+        return Core::Id::fromLiteral(literal, sizeof(literal) - 1, Core::Id::hashLiteral(literal), cache); \
+    }())
@@ -1,14 +1,17 @@
 #include "stdafx.h"
 #include "settingsdatabase.h"
+#include <QBasicTimer>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QTimerEvent>
 
 
 using namespace Core;
 using namespace Core::Internal;
 
 enum { debug_settings = 0 };
+enum { FlushDelay = 2000 }; // msһ޸֮󾭹ʱдݿ
 
 namespace Core {
 namespace Internal {
@@ -25,6 +28,10 @@ public:
 	}
 	~SettingsDatabasePrivate()
 	{
+		m_insertQuery = QSqlQuery();
+		m_deleteQuery = QSqlQuery();
+		m_db.close();
+		m_db = QSqlDatabase();
 		QSqlDatabase::removeDatabase(QLatin1String("settings"));
 	}
 
@@ -42,14 +49,66 @@ public:
         return g;
     }
 
+    static bool isInGroup(const QString &key, const QString &prefix)
+    {
+        return key.startsWith(prefix)
+            && (key.length() == prefix.length() || key.at(prefix.length()) == QLatin1Char('/'));
+    }
+
+    void flush();
+
     SettingsMap m_settings;
 
     QStringList m_groups;
-    QStringList m_dirtyKeys;
+    SettingsMap m_dirtyValues;      // ûдݿֵ
+    QStringList m_removedPrefixes;  // ûдݿɾkeym_dirtyValues֮ǰִ
+    QBasicTimer m_flushTimer;
 
     QSqlDatabase m_db;
+    QSqlQuery m_insertQuery;        // Ԥ䣬ÿflush()ظʹ
+    QSqlQuery m_deleteQuery;
 };
 
+void SettingsDatabasePrivate::flush()
+{
+    m_flushTimer.stop();
+    if (m_dirtyValues.isEmpty() && m_removedPrefixes.isEmpty())
+        return;
+    if (!m_db.isOpen())
+    {
+        m_dirtyValues.clear();
+        m_removedPrefixes.clear();
+        return;
+    }
+
+    // ޸ķһУֻύһ
+    m_db.transaction();
+    foreach (const QString &prefix, m_removedPrefixes)
+    {
+        m_deleteQuery.addBindValue(prefix);
+        m_deleteQuery.addBindValue(QString(prefix + QLatin1String("/%")));
+        m_deleteQuery.exec();
+    }
+    SettingsMap::const_iterator i = m_dirtyValues.constBegin();
+    for (; i != m_dirtyValues.constEnd(); ++i)
+    {
+        m_insertQuery.addBindValue(i.key());
+        m_insertQuery.addBindValue(i.value());
+        m_insertQuery.exec();
+
+        if (debug_settings)
+            qDebug() << "Stored:" << i.key() << "=" << i.value();
+    }
+    if (!m_db.commit())
+    {
+        qWarning().nospace() << "Warning: Failed to write settings database! ("
+                             << m_db.lastError().driverText() << ")";
+        m_db.rollback();
+    }
+    m_dirtyValues.clear();
+    m_removedPrefixes.clear();
+}
+
 } // namespace Internal
 } // namespace Core
 
@@ -90,8 +149,12 @@ SettingsDatabase::SettingsDatabase(const QString &path, const QString &applicati
             while (query.next())
                 d->m_settings.insert(query.value(0).toString(), QVariant());
         }
+
+        d->m_insertQuery = QSqlQuery(d->m_db);
+        d->m_insertQuery.prepare(QLatin1String("INSERT INTO settings VALUES (?, ?)"));
+        d->m_deleteQuery = QSqlQuery(d->m_db);
+        d->m_deleteQuery.prepare(QLatin1String("DELETE FROM settings WHERE key = ? OR key LIKE ?"));
     }
-	d->m_db.close();
 }
 
 SettingsDatabase::~SettingsDatabase()
@@ -111,14 +174,10 @@ void SettingsDatabase::setValue(const QString &key,
     if (!d->m_db.isOpen())
         return;
 
-    QSqlQuery query(d->m_db);
-    query.prepare(QLatin1String("INSERT INTO settings VALUES (?, ?)"));
-    query.addBindValue(effectiveKey);
-    query.addBindValue(value);
-    query.exec();
-
-    if (debug_settings)
-        qDebug() << "Stored:" << effectiveKey << "=" << value;
+    // ȼ¼ڴУflush()һд
+    d->m_dirtyValues.insert(effectiveKey, value);
+    if (!d->m_flushTimer.isActive())
+        d->m_flushTimer.start(FlushDelay, this);
 }
 
 QVariant SettingsDatabase::value(const QString &key,
@@ -127,8 +186,14 @@ QVariant SettingsDatabase::value(const QString &key,
     const QString effectiveKey = d->effectiveKey(key);
     QVariant value = defaultValue;
 
+    // m_settingsаݿеkeyеkeyòѯݿ⣬
+    // ûдݿremove()Ҳֵ
     SettingsMap::const_iterator i = d->m_settings.constFind(effectiveKey);
-    if (i != d->m_settings.constEnd() && i.value().isValid())
+    if (i == d->m_settings.constEnd())
+    {
+        return value;
+    }
+    else if (i.value().isValid())
     {
         value = i.value();
     }
@@ -165,23 +230,21 @@ void SettingsDatabase::remove(const QString &key)
     // cacheƳkey
     foreach (const QString &k, d->m_settings.keys()) {
         // Ҫôȫƥ䣬Ҫôƥ䵽'/'
-        if (k.startsWith(effectiveKey)
-            && (k.length() == effectiveKey.length()
-                || k.at(effectiveKey.length()) == QLatin1Char('/')))
-        {
+        if (SettingsDatabasePrivate::isInGroup(k, effectiveKey))
             d->m_settings.remove(k);
-        }
     }
 
     if (!d->m_db.isOpen())
         return;
 
-
-    QSqlQuery query(d->m_db);
-    query.prepare(QLatin1String("DELETE FROM settings WHERE key = ? OR key LIKE ?"));
-    query.addBindValue(effectiveKey);
-    query.addBindValue(QString(effectiveKey + QLatin1String("/%")));
-    query.exec();
+    // ûдֱֵӶɾflush()
+    foreach (const QString &k, d->m_dirtyValues.keys()) {
+        if (SettingsDatabasePrivate::isInGroup(k, effectiveKey))
+            d->m_dirtyValues.remove(k);
+    }
+    d->m_removedPrefixes.append(effectiveKey);
+    if (!d->m_flushTimer.isActive())
+        d->m_flushTimer.start(FlushDelay, this);
 }
 
 void SettingsDatabase::beginGroup(const QString &prefix)
@@ -219,5 +282,13 @@ QStringList SettingsDatabase::childKeys() const
 
 void SettingsDatabase::sync()
 {
-    // TODO: Delay writing of dirty keys and save them here
+    d->flush();
+}
+
+void SettingsDatabase::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == d->m_flushTimer.timerId())
+        d->flush();
+    else
+        QObject::timerEvent(event);
 }
@@ -1,7 +1,7 @@
 #ifndef SETTINGSDATABASE_H
 #define SETTINGSDATABASE_H
 
-#include "core_global.h"
+#include "../core_global.h"
 
 #include <QObject>
 #include <QString>
@@ -31,7 +31,10 @@ public:
     QString group() const;
     QStringList childKeys() const;
 
-    void sync();
+    void sync();//立即写入还没有保存的修改
+
+protected:
+    void timerEvent(QTimerEvent *event);
 
 private:
     Internal::SettingsDatabasePrivate *d;
@@ -1,15 +1,23 @@
 #include "stdafx.h"
 #include "documentmanager.h"
 #include <QApplication>
+#include <QCryptographicHash>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QDir>
 #include <QFile>
 #include <QFileDialog>
 #include <QFileSystemWatcher>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QMainWindow>
 #include <QMessageBox>
+#include <QRunnable>
 #include <QSet>
 #include <QSettings>
+#include <QThreadPool>
 #include <QTimer>
 #include "../dialogs/saveitemsdialog.h"
 #include "../constants.h"
@@ -26,6 +34,15 @@ static const char settingsGroupC[]	= "RecentFiles";
 static const char filesKeyC[]		= "Files";
 static const char editorsKeyC[]		= "EditorIds";
 
+// Change notifications are collected until no new one arrived for
+// changeSettleInterval, but for at most changeMaxDelay after the first one.
+static const int changeSettleInterval	= 200; // ms
+static const int changeMaxDelay			= 1000; // ms
+// Files the watcher refuses (watch limit reached) are polled instead.
+static const int pollInterval			= 2000; // ms
+// Larger files are not hashed and always count as changed.
+static const qint64 maxHashedFileSize	= 64 * 1024 * 1024;
+
 //static const char directoryGroupC[] = "Directories";
 
 namespace Core{
@@ -40,8 +57,12 @@ struct OpenWithEntry
 
 struct FileStateItem
 {
+    FileStateItem() : exists(false) {}
     QDateTime modifiedTime;
     QFile::Permissions permissions;
+    bool exists;
+    QByteArray contentHash; // empty if unknown
+    QFuture<QByteArray> pendingHash; // contentHash still being computed off the GUI thread
 };
 
 struct FileState
@@ -57,9 +78,25 @@ public:
 
     explicit DocumentManagerPrivate(QMainWindow *mw);
     QFileSystemWatcher *fileWatcher();
+    void watchFile(const QString &fileName);
+    void unwatchFile(const QString &fileName);
+    void updateWatches();
 
     QMap<QString, FileState> m_states;
     QSet<QString> m_changedFiles;
+    QTimer *m_changeTimer;
+    QElapsedTimer m_firstChange;
+
+    // Watcher changes are queued and applied in one addPaths()/removePaths()
+    // call by updateWatches().
+    QSet<QString> m_watchedFiles;
+    QSet<QString> m_filesToWatch;
+    QSet<QString> m_filesToUnwatch;
+    QHash<QString, FileStateItem> m_polledFiles;
+    QTimer *m_pollTimer;
+    // Changed files whose new content is hashed off the GUI thread; checkForReload()
+    // leaves them in m_changedFiles until the hash is ready.
+    QHash<QString, FileStateItem> m_hashingFiles;
     QList<IDocument *> m_documentsWithoutWatch;
     QMap<IDocument *, QStringList> m_documentsWithWatch;
     QSet<QString> m_expectedFileNames;
@@ -100,33 +137,130 @@ static void removeFileInfo(IDocument *document)
         d->m_states[fileName].lastUpdatedStates.remove(document);
         if (d->m_states.value(fileName).lastUpdatedStates.isEmpty())
         {
-            if (d->m_fileWatcher && d->m_fileWatcher->files().contains(fileName))
-                d->m_fileWatcher->removePath(fileName);
+            d->unwatchFile(fileName);
             d->m_states.remove(fileName);
+            d->m_hashingFiles.remove(fileName);
         }
     }
     d->m_documentsWithWatch.remove(document);
 }
 
-static void addFileInfo(const QString &fileName, IDocument *document)
+static QByteArray contentHash(const QString &fileName, const QFileInfo &fi)
+{
+    if (!fi.isFile() || fi.size() > maxHashedFileSize)
+        return QByteArray();
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return QByteArray();
+    return hash.result();
+}
+
+// Hashes a file on the global thread pool. The result is empty if the file
+// no longer has the modification time its state was taken at.
+class ContentHashTask : public QRunnable
+{
+public:
+    ContentHashTask(const QString &fileName, const QDateTime &modifiedTime)
+        : m_fileName(fileName), m_modifiedTime(modifiedTime)
+    {
+        m_result.reportStarted();
+    }
+
+    QFuture<QByteArray> future() { return m_result.future(); }
+
+    void run()
+    {
+        QByteArray hash;
+        const QFileInfo fi(m_fileName);
+        if (fi.lastModified() == m_modifiedTime)
+        {
+            hash = contentHash(m_fileName, fi);
+            if (QFileInfo(m_fileName).lastModified() != m_modifiedTime)
+                hash.clear();
+        }
+        m_result.reportResult(hash);
+        m_result.reportFinished();
+    }
+
+private:
+    QString m_fileName;
+    QDateTime m_modifiedTime;
+    QFutureInterface<QByteArray> m_result;
+};
+
+// A hash that is not ready yet counts as unknown; checkForReload() must not block on it.
+static QByteArray knownContentHash(const FileStateItem &state)
+{
+    if (state.contentHash.isEmpty() && state.pendingHash.isFinished()
+            && state.pendingHash.resultCount() > 0)
+        return state.pendingHash.result();
+    return state.contentHash;
+}
+
+// True if a document knows the hash of the content it last saw and the file has
+// been rewritten since, so comparing hashes may show that nothing needs reloading.
+static bool needsContentHash(const FileState &fileState, const FileStateItem &current)
+{
+    if (!current.exists)
+        return false;
+    foreach (const FileStateItem &last, fileState.lastUpdatedStates)
+    {
+        if (last.modifiedTime != current.modifiedTime && !knownContentHash(last).isEmpty())
+            return true;
+    }
+    return false;
+}
+
+static FileStateItem currentFileState(const QString &fileName)
 {
     FileStateItem state;
-    if (!fileName.isEmpty())
+    const QFileInfo fi(fileName);
+    state.exists = fi.exists();
+    if (state.exists)
     {
-        const QFileInfo fi(fileName);
         state.modifiedTime = fi.lastModified();
         state.permissions = fi.permissions();
+    }
+    return state;
+}
+
+static void addFileInfo(const QString &fileName, IDocument *document)
+{
+    if (!fileName.isEmpty())
+    {
+        FileStateItem state = currentFileState(fileName);
 
         if (!d->m_states.contains(fileName))
         {
             d->m_states.insert(fileName, FileState());
         }
-        QFileSystemWatcher *watcher = 0;
-        watcher = d->fileWatcher();
-        if (!watcher->files().contains(fileName))
-            watcher->addPath(fileName);
+        // Reuse the hash of another document of the same, unchanged file
+        FileState &fileState = d->m_states[fileName];
+        bool hashed = false;
+        foreach (const FileStateItem &other, fileState.lastUpdatedStates)
+        {
+            if (other.modifiedTime == state.modifiedTime
+                    && (!other.contentHash.isEmpty() || !other.pendingHash.isCanceled()))
+            {
+                state.contentHash = other.contentHash;
+                state.pendingHash = other.pendingHash;
+                hashed = true;
+                break;
+            }
+        }
+        // Hashing a large file would stall the GUI thread, so it runs in the background
+        if (!hashed && state.exists)
+        {
+            ContentHashTask *task = new ContentHashTask(fileName, state.modifiedTime);
+            state.pendingHash = task->future();
+            QThreadPool::globalInstance()->start(task);
+        }
+        d->watchFile(fileName);
 
-        d->m_states[fileName].lastUpdatedStates.insert(document, state);
+        fileState.lastUpdatedStates.insert(document, state);
     }
     d->m_documentsWithWatch[document].append(fileName);
 }
@@ -211,7 +345,9 @@ static QList<IDocument *> saveModifiedFilesHelper(const QList<IDocument *> &docu
     return notSaved;
 }
 DocumentManagerPrivate::DocumentManagerPrivate(QMainWindow *mw)
-    : m_mainWindow(mw),
+    : m_changeTimer(0),
+      m_pollTimer(0),
+      m_mainWindow(mw),
       m_fileWatcher(0),
       m_blockActivated(false),
       m_lastVisitedDirectory(QDir::currentPath()),
@@ -230,6 +366,74 @@ QFileSystemWatcher *DocumentManagerPrivate::fileWatcher()
     return m_fileWatcher;
 }
 
+// Unwatching and watching a file again in one batch re-adds the watch,
+// which is lost when a file is replaced.
+void DocumentManagerPrivate::watchFile(const QString &fileName)
+{
+    m_filesToWatch.insert(fileName);
+}
+
+void DocumentManagerPrivate::unwatchFile(const QString &fileName)
+{
+    m_filesToWatch.remove(fileName);
+    m_filesToUnwatch.insert(fileName);
+}
+
+void DocumentManagerPrivate::updateWatches()
+{
+    if (m_filesToWatch.isEmpty() && m_filesToUnwatch.isEmpty())
+        return;
+
+    QStringList toRemove;
+    foreach (const QString &fileName, m_filesToUnwatch)
+    {
+        if (m_watchedFiles.remove(fileName))
+            toRemove << fileName;
+        m_polledFiles.remove(fileName);
+    }
+    m_filesToUnwatch.clear();
+
+    QStringList toAdd;
+    foreach (const QString &fileName, m_filesToWatch)
+    {
+        if (m_states.contains(fileName)
+                && !m_watchedFiles.contains(fileName) && !m_polledFiles.contains(fileName))
+            toAdd << fileName;
+    }
+    m_filesToWatch.clear();
+
+    if (!toRemove.isEmpty())
+        fileWatcher()->removePaths(toRemove);
+    if (!toAdd.isEmpty())
+    {
+        const QStringList failed = fileWatcher()->addPaths(toAdd);
+        foreach (const QString &fileName, toAdd)
+            m_watchedFiles.insert(fileName);
+        foreach (const QString &fileName, failed)
+        {
+            m_watchedFiles.remove(fileName);
+            m_polledFiles.insert(fileName, currentFileState(fileName));
+        }
+    }
+
+    if (m_polledFiles.isEmpty())
+    {
+        if (m_pollTimer)
+            m_pollTimer->stop();
+    }
+    else
+    {
+        if (!m_pollTimer)
+        {
+            m_pollTimer = new QTimer(m_instance);
+            m_pollTimer->setInterval(pollInterval);
+            QObject::connect(m_pollTimer, SIGNAL(timeout()), m_instance, SLOT(pollFiles()));
+        }
+        if (!m_pollTimer->isActive())
+            m_pollTimer->start();
+    }
+}
+
 
 }//namespace Internal;
 }//namespace Core;
@@ -243,6 +447,9 @@ DocumentManager::DocumentManager(QMainWindow *mw)
 {
     d = new DocumentManagerPrivate(mw);
     m_instance = this;
+    d->m_changeTimer = new QTimer(this);
+    d->m_changeTimer->setSingleShot(true);
+    connect(d->m_changeTimer, SIGNAL(timeout()), this, SLOT(checkForReload()));
     connect(d->m_mainWindow, SIGNAL(windowActivated()),
             this, SLOT(mainWindowActivated()));
     connect(ICore::instance(), SIGNAL(contextChanged(Core::IContext*,Core::Context)),
@@ -271,6 +478,7 @@ void DocumentManager::checkForReload()
         return ;
 
     d->m_blockActivated = true;
+    d->m_changeTimer->stop();
 
     IDocument::ReloadSetting defaultBehavior = EditorManager::instance()->reloadSetting();
     Utils::ReloadPromptAnswer previousAnswer = Utils::ReloadCurrent;
@@ -282,30 +490,60 @@ void DocumentManager::checkForReload()
     QMap<QString, IDocument::ChangeType> changeTypes;
     QSet<IDocument *> changedIDocuments;
 
+    // Every changed file is examined once, however many documents share it.
+    // A rewritten file is hashed on the thread pool first; it stays in
+    // m_changedFiles and is examined again once contentHashFinished() fires.
+    QSet<QString> deferredFiles;
     foreach (const QString &fileName, d->m_changedFiles)
     {
         IDocument::ChangeType type = IDocument::TypeContents;
-        FileStateItem state;
-        QFileInfo fi(fileName);
-        if(!fi.exists())
-        {
+        FileStateItem state = currentFileState(fileName);
+        if(!state.exists)
             type = IDocument::TypeRemoved;
-        }
-        else
+        FileState fileState = d->m_states.value(fileName);
+        if (needsContentHash(fileState, state))
         {
-            state.modifiedTime  = fi.lastModified();
-            state.permissions   = fi.permissions();
+            QHash<QString, FileStateItem>::iterator hashing = d->m_hashingFiles.find(fileName);
+            if (hashing == d->m_hashingFiles.end() || hashing->modifiedTime != state.modifiedTime)
+            {
+                FileStateItem pending = state;
+                ContentHashTask *task = new ContentHashTask(fileName, state.modifiedTime);
+                pending.pendingHash = task->future();
+                d->m_hashingFiles.insert(fileName, pending);
+                QFutureWatcher<QByteArray> *watcher = new QFutureWatcher<QByteArray>(this);
+                connect(watcher, SIGNAL(finished()), this, SLOT(contentHashFinished()));
+                watcher->setFuture(pending.pendingHash);
+                QThreadPool::globalInstance()->start(task);
+                deferredFiles.insert(fileName);
+                continue;
+            }
+            if (!hashing->pendingHash.isFinished())
+            {
+                deferredFiles.insert(fileName);
+                continue;
+            }
+            // Empty if the file changed again while it was hashed; it then counts as changed
+            state.contentHash = knownContentHash(*hashing);
+            d->m_hashingFiles.erase(hashing);
         }
         currentStates.insert(fileName, state);
         changeTypes.insert(fileName, type);
-        FileState fileState = d->m_states.value(fileName);
         foreach(IDocument *document, fileState.lastUpdatedStates.keys())
         {
             changedIDocuments.insert(document);
         }
     }
 
-    d->m_changedFiles.clear();
+    // A replaced file may have lost its watch
+    foreach (const QString &fileName, d->m_changedFiles)
+    {
+        if (d->m_states.contains(fileName))
+        {
+            d->unwatchFile(fileName);
+            d->watchFile(fileName);
+        }
+    }
+    d->m_changedFiles = deferredFiles;
 
     QSet<QString> expectedFileNames;
     foreach(const QString &fileName, d->m_expectedFileNames)
@@ -338,6 +576,20 @@ void DocumentManager::checkForReload()
             if (lastState.modifiedTime == currentState.modifiedTime
                     && lastState.permissions == currentState.permissions)
                 continue;
+
+            // Rewritten with the same content: remember the new time, don't reload
+            const QByteArray lastHash = knownContentHash(lastState);
+            if (lastState.modifiedTime != currentState.modifiedTime
+                    && currentState.exists && !lastHash.isEmpty())
+            {
+                if (currentState.contentHash == lastHash)
+                {
+                    d->m_states[fileName].lastUpdatedStates.insert(document, currentState);
+                    if (lastState.permissions != currentState.permissions)
+                        changed = true;
+                    continue;
+                }
+            }
             changed = true;
             
             if(lastState.modifiedTime == currentState.modifiedTime)
@@ -474,6 +726,7 @@ void DocumentManager::checkForReload()
         it.key()->checkPermissions();
     }
 
+    d->updateWatches();
     d->m_blockActivated = false;
 }
 
@@ -489,13 +742,17 @@ void DocumentManager::checkForNewFileName()
 
     removeFileInfo(document);
     addFileInfo(document);
+    d->updateWatches();
 }
 
 void DocumentManager::documentDestroyed(QObject *obj)
 {
     IDocument *document = static_cast<IDocument*>(obj);
     if (!d->m_documentsWithoutWatch.removeOne(document))
+    {
         removeFileInfo(document);
+        d->updateWatches();
+    }
 }
 
 void DocumentManager::fileNameChanged(const QString &oldName, const QString &newName)
@@ -510,14 +767,36 @@ void DocumentManager::fileNameChanged(const QString &oldName, const QString &new
 
 void DocumentManager::changedFile(const QString &fileName)
 {
-    const bool bEmpty = d->m_changedFiles.isEmpty();
+    if (!d->m_states.contains(fileName))
+        return;
 
-    if (d->m_states.contains(fileName))
-        d->m_changedFiles.insert(fileName);
+    // Debounce: wait until the burst settles, but not longer than changeMaxDelay
+    if (d->m_changedFiles.isEmpty())
+        d->m_firstChange.start();
+    d->m_changedFiles.insert(fileName);
+    const qint64 remaining = changeMaxDelay - d->m_firstChange.elapsed();
+    d->m_changeTimer->start(int(qBound(qint64(0), remaining, qint64(changeSettleInterval))));
+}
 
-    if (bEmpty && !d->m_changedFiles.isEmpty())
+void DocumentManager::contentHashFinished()
+{
+    sender()->deleteLater();
+    d->m_changeTimer->start(0);
+}
+
+void DocumentManager::pollFiles()
+{
+    QHash<QString, FileStateItem>::iterator it = d->m_polledFiles.begin();
+    for (; it != d->m_polledFiles.end(); ++it)
     {
-        QTimer::singleShot(200, this, SLOT(checkForReload()));
+        const FileStateItem state = currentFileState(it.key());
+        if (state.exists != it.value().exists
+                || state.modifiedTime != it.value().modifiedTime
+                || state.permissions != it.value().permissions)
+        {
+            it.value() = state;
+            changedFile(it.key());
+        }
     }
 }
 
@@ -730,6 +1009,7 @@ bool DocumentManager::removeDocument(IDocument *document)
     {
         addWatcher = true;
         removeFileInfo(document);
+        d->updateWatches();
         disconnect(document, SIGNAL(changed()), m_instance, SLOT(checkForNewFileName()));
     }
     disconnect(document, SIGNAL(destroyed(QObject*)), m_instance, SLOT(documentDestroyed(QObject*)));
@@ -776,6 +1056,7 @@ void DocumentManager::renamedFile(const QString &from, const QString &to)
         addFileInfo(document);
         d->m_blockedIDocument = 0;
     }
+    d->updateWatches();
     emit m_instance->allDocumentsRenamed(from, to);
 }
 
@@ -940,6 +1221,7 @@ void DocumentManager::addDocuments(const QList<IDocument *> &documents, bool add
             addFileInfo(document);
         }
     }
+    d->updateWatches();
 }
 
 void DocumentManager::addDocument(IDocument *document, bool addWatcher)
@@ -138,6 +138,10 @@ public slots:
     void changedFile(const QString &fileName);
     void syncWithEditor(Core::IContext *context);
 
+private slots:
+    void pollFiles();
+    void contentHashFinished();
+
 private:
 //    Internal::DocumentManagerPrivate *d;
 
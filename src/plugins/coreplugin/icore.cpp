@@ -15,6 +15,9 @@ void ICore::initialize()
 {
 	Core::ActionManager::instance();
 	connect(this, SIGNAL(quit()), qApp, SLOT(quit()));
+	// ޽ģʽйߣ
+	if (ExtensionSystem::PluginManager::instance()->isHeadless())
+		return;
 	MainWindow* pMain = createMainWindow();
 	pMain->show();
 }
@@ -44,7 +47,8 @@ void ICore::onMainWindowClosed()
 
 void ICore::insertCenterWidget(QWidget* pWidget)
 {
-	m_pFirstMainWindow->insertCenterWidget(pWidget);
+	if (m_pFirstMainWindow)
+		m_pFirstMainWindow->insertCenterWidget(pWidget);
 }
 
 QString ICore::resourcePath()
@@ -95,6 +99,8 @@ void ICore::saveSettings()
 {
 	ICore::settings(QSettings::SystemScope)->sync();
 	ICore::settings(QSettings::UserScope)->sync();
+	if (m_pSettingsDatabase)
+		m_pSettingsDatabase->sync();
 }
 
 ICore::ICore() : m_pFirstMainWindow(0)
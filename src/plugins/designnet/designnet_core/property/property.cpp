@@ -6,7 +6,8 @@
 DesignNet::Property::Property(const QString &id, const QString &name, QObject *parent) :
 	QObject(parent),
 	m_id(id),
-	m_name(name)
+	m_name(name),
+	m_owner(0)
 {
 }
 
@@ -27,7 +28,12 @@ QString DesignNet::Property::id() const
 
 void DesignNet::Property::setId(const QString &id)
 {
+	if (m_id == id)
+		return;
+	const QString oldId = m_id;
 	m_id = id;
+	if (m_owner)
+		m_owner->propertyIdChanged(this, oldId);
 }
 
 
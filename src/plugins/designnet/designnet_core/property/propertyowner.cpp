@@ -25,13 +25,7 @@ PropertyOwner::~PropertyOwner()
 
 Property* PropertyOwner::getProperty(const QString& id) const
 {
-	foreach (Property* property, m_aggregate->components<Property>())
-	{
-		if (property->id() == id)
-			return property;
-	}
-
-	return 0;
+	return m_properties.value(id, 0);
 }
 
 QList<Property*> PropertyOwner::getProperties() const
@@ -64,6 +58,7 @@ void PropertyOwner::addProperty(Property* prop)
 	}
 
 	m_aggregate->add(prop);
+	m_properties.insert(prop->id(), prop);
 	prop->setOwner(this);
 	propertyAdded(prop);
 }
@@ -80,9 +75,19 @@ void PropertyOwner::removeProperty(Property* prop)
 	propertyRemoving(prop);
 	prop->setOwner(0);
 	m_aggregate->remove(prop);
+	m_properties.remove(prop->id());
 	propertyRemoved(prop);
 }
 
+void PropertyOwner::propertyIdChanged(Property* prop, const QString& oldId)
+{
+	if (m_properties.value(oldId) == prop)
+		m_properties.remove(oldId);
+	if (m_properties.contains(prop->id()))
+		qWarning() << "The id of this property has been added";
+	m_properties.insert(prop->id(), prop);
+}
+
 void PropertyOwner::propertyRemoving(Property* prop)
 {
 
@@ -47,6 +47,7 @@ public:
 	 */
 	virtual void		propertyRemoved(Property* prop);
 	virtual void		propertyAdded(Property* prop);
+	void				propertyIdChanged(Property* prop, const QString &oldId);	//!< 由Property::setId()调用，更新m_properties
 
 	/*!
 	 * \fn	void PropertyOwner::serialize(Utils::XmlSerializer& s) const override;
@@ -66,6 +67,7 @@ public:
 protected:
 
 	Aggregation::Aggregate* m_aggregate; //!< 所有属性为一个整体，不可以删除
+	QHash<QString, Property*> m_properties;	//!< 属性id-->属性，getProperty()不需要遍历
 	QHash<QString, QString> m_propertyGroupIDLabelMap;//!< group id-->group在gui中的名称
 	QString m_name;
 };
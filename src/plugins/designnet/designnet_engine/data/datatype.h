@@ -0,0 +1,30 @@
+#ifndef DATATYPE_H
+#define DATATYPE_H
+
+namespace DesignNet{
+
+/*!
+ * \brief 端口的数据类型
+ *
+ * DATATYPE_MATRIX与END_DATATYPE_MATRIX之间的类型都以cv::Mat（MatPayload）传递。
+ * DATATYPE_USERTYPE不区分具体的类型，只在两端都没有声明C++类型时使用。
+ */
+enum DataType
+{
+	DATATYPE_INT,
+	DATATYPE_MATRIX,
+	DATATYPE_HISTOGRAM,
+	DATATYPE_GRAYIMAGE,
+	DATATYPE_8UC3IMAGE,
+	DATATYPE_BINARYIMAGE,
+	END_DATATYPE_MATRIX,
+
+	DATATYPE_STRING,
+	DATATYPE_DOUBLE,
+	DATATYPE_USERTYPE,
+	DATATYPE_INVALID
+};
+
+}
+
+#endif // DATATYPE_H
@@ -0,0 +1,31 @@
+#include "idata.h"
+
+namespace DesignNet{
+
+IData::IData(QObject *parent)
+	: QObject(parent),
+	  m_index(-1),
+	  m_bPermanent(false)
+{
+}
+
+bool IData::copy(IData* data)
+{
+	if (!data)
+		return false;
+	m_index = data->index();
+	m_bPermanent = data->isPermanent();
+	return true;
+}
+
+void IData::setPermanent(const bool &p)
+{
+	m_bPermanent = p;
+}
+
+bool IData::isPermanent() const
+{
+	return m_bPermanent;
+}
+
+}
@@ -1,7 +1,7 @@
 #ifndef IDATATYPE_H
 #define IDATATYPE_H
 
-#include "coreplugin/id.h"
+#include "coreplugin/Common/id.h"
 #include "../designnet_core_global.h"
 #include <QObject>
 #include <QImage>
@@ -37,21 +37,41 @@ Core::Id ImageData::id()
 
 void ImageData::setImageData(const cv::Mat &mat)
 {
-	QWriteLocker lock(&m_lock);
-    m_imageMat = mat;
+	{
+		QWriteLocker lock(&m_lock);
+		m_imageMat.assign(mat);
+	}
     emit dataChanged();
 }
 
 cv::Mat ImageData::imageData() const
 {
 	QReadLocker lock(&m_lock);
-    return m_imageMat;
+    return m_imageMat.mat();
+}
+
+MatPayload ImageData::payload() const
+{
+	QReadLocker lock(&m_lock);
+	return m_imageMat;
+}
+
+void ImageData::setPayload( const MatPayload &payload )
+{
+	{
+		QWriteLocker lock(&m_lock);
+		m_imageMat = payload;
+	}
+	emit dataChanged();
 }
 
 IData* ImageData::clone(QObject *parent /*= 0 */)
 {
+	///
+	/// 共享缓冲区，任何一方请求可写数据时才从MatBufferPool申请缓冲区并复制
 	ImageData *imageData = new ImageData(this->imageType(), parent);
-	imageData->setImageData(this->imageData().clone());
+	QWriteLocker lock(&imageData->m_lock);
+	imageData->m_imageMat = payload();
 	return imageData;
 }
 
@@ -62,13 +82,17 @@ bool ImageData::copy(IData* data)
 	if(!imageData)
 		return false;
 
-	imageData->imageData().copyTo(m_imageMat);
+	{
+		QWriteLocker lock(&m_lock);
+		m_imageMat = imageData->payload();
+	}
 	return IData::copy(data);
 }
 
 bool ImageData::isValid() const
 {
-	if (m_imageMat.empty())
+	QReadLocker lock(&m_lock);
+	if (m_imageMat.isEmpty())
 	{
 		return false;
 	}
@@ -79,4 +103,25 @@ QImage ImageData::image()
 {
 	return m_image;
 }
+
+ImageDataWriter::ImageDataWriter( ImageData *data )
+	: m_data(data)
+{
+	m_data->m_lock.lockForWrite();
+	m_mat = &m_data->m_imageMat.mutableMat();
+}
+
+ImageDataWriter::ImageDataWriter( ImageData *data, int rows, int cols, int cvType )
+	: m_data(data)
+{
+	m_data->m_lock.lockForWrite();
+	m_mat = &m_data->m_imageMat.create(rows, cols, cvType);
+}
+
+ImageDataWriter::~ImageDataWriter()
+{
+	m_data->m_lock.unlock();
+	emit m_data->dataChanged();
+}
+
 }
@@ -0,0 +1,76 @@
+#ifndef IMAGEDATA_H
+#define IMAGEDATA_H
+
+#include "opencv2/core/core.hpp"
+#include "idata.h"
+#include "matpayload.h"
+#include <QReadWriteLock>
+
+
+namespace DesignNet {
+class ImageDataWidget;
+class DESIGNNET_CORE_EXPORT ImageData : public IData
+{
+    Q_OBJECT
+    friend class ImageDataWidget;
+public:
+	enum{
+		IMAGE_GRAY,
+		IMAGE_BINARY,
+		IMAGE_BGR,
+		IMAGE_BGRA
+	};
+
+	explicit ImageData(int type = IMAGE_BGR, QObject *parent = 0);//!< type可以是IMAGE_GRAY,IMAGE_BINARY,IMAGE_BGR,IMAGE_BGRA
+	~ImageData(){}
+
+	virtual Core::Id id();
+    void setImageData(const cv::Mat& mat);		//!< 复制\e mat 的数据，之后修改\e mat 不影响本对象
+    cv::Mat imageData() const;					//!< 只读数据，不复制缓冲区，需要保留时使用payload()
+	MatPayload payload() const;
+	void setPayload(const MatPayload &payload);	//!< 共享\e payload 的缓冲区，写入时复制
+	IData* clone(QObject *parent = 0 );
+	virtual bool copy(IData* data);
+	virtual bool isValid() const;
+	virtual QImage image();//!< 类型图片
+	int imageType() const { return m_type; }
+
+signals:
+
+public slots:
+protected:
+
+	friend class ImageDataWriter;
+	mutable QReadWriteLock m_lock;
+    MatPayload m_imageMat;//!< opencv Image图像
+	int m_type;
+};
+
+/*!
+ * \brief ImageData的可写图像
+ *
+ * 在作用域中持有ImageData的写锁，mat()在锁内返回可写数据（写时复制，缓冲区来自MatBufferPool），
+ * 析构时释放写锁并发出ImageData::dataChanged()。例如：
+ * \code
+ * ImageDataWriter writer(imageData, rows, cols, CV_8UC3);
+ * cv::cvtColor(src, writer.mat(), CV_GRAY2BGR);
+ * \endcode
+ */
+class DESIGNNET_CORE_EXPORT ImageDataWriter
+{
+public:
+	explicit ImageDataWriter(ImageData *data);						//!< 修改已有的图像
+	ImageDataWriter(ImageData *data, int rows, int cols, int cvType);	//!< 大小或类型不同时重新申请
+	~ImageDataWriter();
+
+	cv::Mat& mat() { return *m_mat; }
+
+private:
+	Q_DISABLE_COPY(ImageDataWriter)
+	ImageData*	m_data;
+	cv::Mat*	m_mat;
+};
+
+}
+
+#endif // IMAGEDATA_H
@@ -0,0 +1,273 @@
+#include "matbufferpool.h"
+#include <QMutexLocker>
+#include <QThreadStorage>
+
+namespace DesignNet{
+
+static void* const POOLED_BUFFER = reinterpret_cast<void*>(1);	//!< UMatData::userdata，标记缓冲区可以回到池中
+
+struct ThreadUsage
+{
+	ThreadUsage() : depth(0), current(0), peak(0) {}
+	int		depth;		//!< beginThreadTracking()嵌套的层数
+	qint64	current;	//!< 开始统计之后申请减去释放的字节数
+	qint64	peak;
+};
+static QThreadStorage<ThreadUsage> s_threadUsage;
+
+MatBufferPool::Statistics::Statistics()
+	: hits(0), misses(0), recycled(0), pooledBytes(0), usedBytes(0), peakUsedBytes(0)
+{
+}
+
+double MatBufferPool::Statistics::hitRate() const
+{
+	const qint64 total = hits + misses;
+	return total == 0 ? 0.0 : double(hits) / double(total);
+}
+
+MatBufferPool *MatBufferPool::m_instance = 0;
+
+MatBufferPool::MatBufferPool()
+	: m_iCapacity(256 * 1024 * 1024),
+	m_iMinimumSize(16 * 1024),
+	m_bEnabled(true)
+{
+}
+
+MatBufferPool::~MatBufferPool()
+{
+	trim();
+}
+
+MatBufferPool* MatBufferPool::instance()
+{
+	if (!m_instance)
+		m_instance = new MatBufferPool;
+	return m_instance;
+}
+
+void MatBufferPool::Release()
+{
+	if (!m_instance)
+		return;
+	///
+	/// 还有cv::Mat在使用池中的缓冲区时不能删除分配器，只关闭缓存，
+	/// 之后释放的缓冲区直接还给系统
+	{
+		QMutexLocker locker(&m_instance->m_mutex);
+		m_instance->m_bEnabled = false;
+	}
+	m_instance->trim();
+	if (m_instance->statistics().usedBytes == 0)
+		delete m_instance;
+	m_instance = 0;
+}
+
+cv::Mat MatBufferPool::create( int rows, int cols, int type )
+{
+	cv::Mat mat;
+	mat.allocator = this;
+	mat.create(rows, cols, type);
+	return mat;
+}
+
+cv::Mat MatBufferPool::create( int dims, const int *sizes, int type )
+{
+	cv::Mat mat;
+	mat.allocator = this;
+	mat.create(dims, sizes, type);
+	return mat;
+}
+
+void MatBufferPool::setCapacity( qint64 bytes )
+{
+	{
+		QMutexLocker locker(&m_mutex);
+		m_iCapacity = bytes;
+		if (m_statistics.pooledBytes <= m_iCapacity)
+			return;
+	}
+	trim();
+}
+
+qint64 MatBufferPool::capacity() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_iCapacity;
+}
+
+void MatBufferPool::setMinimumSize( size_t bytes )
+{
+	QMutexLocker locker(&m_mutex);
+	m_iMinimumSize = bytes;
+}
+
+size_t MatBufferPool::minimumSize() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_iMinimumSize;
+}
+
+MatBufferPool::Statistics MatBufferPool::statistics() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_statistics;
+}
+
+void MatBufferPool::resetStatistics()
+{
+	QMutexLocker locker(&m_mutex);
+	m_statistics.hits		= 0;
+	m_statistics.misses		= 0;
+	m_statistics.recycled	= 0;
+	m_statistics.peakUsedBytes = m_statistics.usedBytes;
+}
+
+void MatBufferPool::beginThreadTracking()
+{
+	ThreadUsage &usage = s_threadUsage.localData();
+	if (usage.depth++ == 0)
+	{
+		usage.current	= 0;
+		usage.peak		= 0;
+	}
+}
+
+qint64 MatBufferPool::endThreadTracking()
+{
+	if (!s_threadUsage.hasLocalData())
+		return 0;
+	ThreadUsage &usage = s_threadUsage.localData();
+	if (usage.depth > 0)
+		usage.depth--;
+	return usage.peak;
+}
+
+void MatBufferPool::trackThreadUsage( qint64 bytes )
+{
+	if (!s_threadUsage.hasLocalData())
+		return;
+	ThreadUsage &usage = s_threadUsage.localData();
+	if (usage.depth == 0)
+		return;
+	usage.current += bytes;
+	usage.peak = qMax(usage.peak, usage.current);
+}
+
+void MatBufferPool::trim()
+{
+	QHash<size_t, QList<uchar*> > buckets;
+	{
+		QMutexLocker locker(&m_mutex);
+		buckets.swap(m_buckets);
+		m_statistics.pooledBytes = 0;
+	}
+	QHash<size_t, QList<uchar*> >::const_iterator itr = buckets.constBegin();
+	for (; itr != buckets.constEnd(); itr++)
+	{
+		foreach (uchar* buffer, itr.value())
+			cv::fastFree(buffer);
+	}
+}
+
+cv::UMatData* MatBufferPool::allocate( int dims, const int* sizes, int type,
+	void* data0, size_t* step, int /*flags*/, cv::UMatUsageFlags /*usageFlags*/ ) const
+{
+	///
+	/// 与cv::Mat默认分配器相同的连续内存布局
+	size_t total = CV_ELEM_SIZE(type);
+	for (int i = dims - 1; i >= 0; i--)
+	{
+		if (step)
+		{
+			if (data0 && step[i] != CV_AUTOSTEP)
+			{
+				CV_Assert(total <= step[i]);
+				total = step[i];
+			}
+			else
+				step[i] = total;
+		}
+		total *= sizes[i];
+	}
+
+	cv::UMatData* u = new cv::UMatData(this);
+	u->size = total;
+	if (data0)
+	{
+		u->data = u->origdata = (uchar*)data0;
+		u->flags |= cv::UMatData::USER_ALLOCATED;
+		return u;
+	}
+	trackThreadUsage(qint64(total));
+	uchar* buffer = takeBuffer(total);
+	if (buffer)
+		u->userdata = POOLED_BUFFER;
+	else
+		buffer = (uchar*)cv::fastMalloc(total);
+	u->data = u->origdata = buffer;
+	return u;
+}
+
+bool MatBufferPool::allocate( cv::UMatData* data, int /*accessflags*/, cv::UMatUsageFlags /*usageFlags*/ ) const
+{
+	return data != 0;
+}
+
+void MatBufferPool::deallocate( cv::UMatData* u ) const
+{
+	if (!u)
+		return;
+	CV_Assert(u->urefcount >= 0);
+	CV_Assert(u->refcount >= 0);
+	if (u->refcount != 0)
+		return;
+	if (!(u->flags & cv::UMatData::USER_ALLOCATED))
+	{
+		trackThreadUsage(-qint64(u->size));
+		if (u->userdata == POOLED_BUFFER)
+			recycleBuffer(u->origdata, u->size);
+		else
+			cv::fastFree(u->origdata);
+		u->origdata = 0;
+	}
+	delete u;
+}
+
+uchar* MatBufferPool::takeBuffer( size_t bytes ) const
+{
+	QMutexLocker locker(&m_mutex);
+	if (!m_bEnabled || bytes < m_iMinimumSize)
+		return 0;
+
+	m_statistics.usedBytes += bytes;
+	m_statistics.peakUsedBytes = qMax(m_statistics.peakUsedBytes, m_statistics.usedBytes);
+	QHash<size_t, QList<uchar*> >::iterator itr = m_buckets.find(bytes);
+	if (itr != m_buckets.end() && !itr.value().isEmpty())
+	{
+		m_statistics.hits++;
+		m_statistics.pooledBytes -= bytes;
+		return itr.value().takeLast();
+	}
+	m_statistics.misses++;
+	locker.unlock();
+	return (uchar*)cv::fastMalloc(bytes);
+}
+
+void MatBufferPool::recycleBuffer( uchar* buffer, size_t bytes ) const
+{
+	QMutexLocker locker(&m_mutex);
+	m_statistics.usedBytes -= bytes;
+	if (m_bEnabled && m_statistics.pooledBytes + qint64(bytes) <= m_iCapacity)
+	{
+		m_buckets[bytes].append(buffer);
+		m_statistics.pooledBytes += bytes;
+		m_statistics.recycled++;
+		return;
+	}
+	locker.unlock();
+	cv::fastFree(buffer);
+}
+
+}
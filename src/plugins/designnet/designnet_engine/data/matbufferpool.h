@@ -0,0 +1,80 @@
+#ifndef MATBUFFERPOOL_H
+#define MATBUFFERPOOL_H
+
+#include "../designnet_core_global.h"
+#include "opencv2/core/core.hpp"
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+namespace DesignNet{
+
+/*!
+ * \brief cv::Mat缓冲区池
+ *
+ * 按缓冲区字节数分桶，cv::Mat释放时缓冲区回到对应的桶中，之后申请相同大小的cv::Mat时直接复用，
+ * 批量处理和流水线执行时每一帧的图像大小相同，因此几乎不再向系统申请内存。
+ * 小于minimumSize()的缓冲区直接使用cv::fastMalloc，池中缓存的总字节数不超过capacity()。
+ *
+ * 使用create()或者设置cv::Mat::allocator为instance()使cv::Mat从池中申请缓冲区。
+ */
+class DESIGNNET_CORE_EXPORT MatBufferPool : public cv::MatAllocator
+{
+public:
+	struct Statistics
+	{
+		Statistics();
+		qint64	hits;			//!< 从池中复用的次数
+		qint64	misses;			//!< 向系统申请的次数
+		qint64	recycled;		//!< 回到池中的次数
+		qint64	pooledBytes;	//!< 当前缓存在池中的字节数
+		qint64	usedBytes;		//!< 当前被cv::Mat使用的字节数
+		qint64	peakUsedBytes;	//!< usedBytes的最大值，resetStatistics()之后重新统计
+		double	hitRate() const;
+	};
+
+	static MatBufferPool* instance();
+	static void Release();
+
+	cv::Mat create(int rows, int cols, int type);	//!< 从池中申请cv::Mat
+	cv::Mat create(int dims, const int *sizes, int type);
+
+	void setCapacity(qint64 bytes);
+	qint64 capacity() const;
+	void setMinimumSize(size_t bytes);
+	size_t minimumSize() const;
+
+	Statistics statistics() const;
+	void resetStatistics();
+	void trim();									//!< 释放池中缓存的全部缓冲区
+
+	static void beginThreadTracking();	//!< 开始统计当前线程通过本分配器申请的缓冲区，可以嵌套
+	static qint64 endThreadTracking();	//!< 结束统计，返回期间当前线程同时持有的最大字节数
+
+	// cv::MatAllocator
+	cv::UMatData* allocate(int dims, const int* sizes, int type,
+		void* data, size_t* step, int flags, cv::UMatUsageFlags usageFlags) const;
+	bool allocate(cv::UMatData* data, int accessflags, cv::UMatUsageFlags usageFlags) const;
+	void deallocate(cv::UMatData* data) const;
+
+protected:
+	MatBufferPool();
+	~MatBufferPool();
+
+	uchar* takeBuffer(size_t bytes) const;
+	void recycleBuffer(uchar* buffer, size_t bytes) const;
+	static void trackThreadUsage(qint64 bytes);
+
+	static MatBufferPool*	m_instance;
+
+	mutable QMutex							m_mutex;
+	mutable QHash<size_t, QList<uchar*> >	m_buckets;	//!< 字节数 -> 空闲缓冲区
+	mutable Statistics						m_statistics;
+	qint64	m_iCapacity;
+	size_t	m_iMinimumSize;
+	bool	m_bEnabled;
+};
+
+}
+
+#endif // MATBUFFERPOOL_H
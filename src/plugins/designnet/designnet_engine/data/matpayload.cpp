@@ -0,0 +1,92 @@
+#include "matpayload.h"
+#include "matbufferpool.h"
+
+namespace DesignNet{
+
+static const cv::Mat s_emptyMat;
+
+MatPayload::MatPayload()
+{
+}
+
+MatPayload::MatPayload( const cv::Mat &mat )
+	: d(new MatPayloadData)
+{
+	d->mat = mat;
+	d->bAdopted = !mat.empty();
+}
+
+const cv::Mat& MatPayload::mat() const
+{
+	return d ? d->mat : s_emptyMat;
+}
+
+cv::Mat& MatPayload::mutableMat()
+{
+	if (!d)
+	{
+		d = new MatPayloadData;
+	}
+	else if (isShared())
+	{
+		MatPayloadData *x = new MatPayloadData;
+		x->mat.allocator = MatBufferPool::instance();
+		d->mat.copyTo(x->mat);
+		d = x;
+	}
+	return d->mat;
+}
+
+cv::Mat& MatPayload::create( int rows, int cols, int type )
+{
+	if (d && !isShared() && d->mat.rows == rows && d->mat.cols == cols
+		&& d->mat.type() == type && d->mat.dims == 2)
+	{
+		return d->mat;
+	}
+	///
+	/// 不修改其它对象仍在使用的缓冲区
+	d = new MatPayloadData;
+	d->mat = MatBufferPool::instance()->create(rows, cols, type);
+	return d->mat;
+}
+
+void MatPayload::assign( const cv::Mat &mat )
+{
+	if (mat.empty())
+	{
+		d.reset();
+		return;
+	}
+	if (mat.dims <= 2)
+	{
+		cv::Mat &dst = create(mat.rows, mat.cols, mat.type());
+		mat.copyTo(dst);
+		return;
+	}
+	MatPayloadData *x = new MatPayloadData;
+	x->mat = MatBufferPool::instance()->create(mat.dims, mat.size.p, mat.type());
+	mat.copyTo(x->mat);
+	d = x;
+}
+
+bool MatPayload::isEmpty() const
+{
+	return !d || d->mat.empty();
+}
+
+bool MatPayload::isShared() const
+{
+	if (!d)
+		return false;
+	///
+	/// 不检查cv::Mat的引用计数，mat()返回的临时cv::Mat不应该导致每次写入都复制
+	return d->ref.load() > 1 || d->bAdopted;
+}
+
+size_t MatPayload::byteSize() const
+{
+	return d ? d->mat.total() * d->mat.elemSize() : 0;
+}
+
+}
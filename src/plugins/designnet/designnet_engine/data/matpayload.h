@@ -0,0 +1,50 @@
+#ifndef MATPAYLOAD_H
+#define MATPAYLOAD_H
+
+#include "../designnet_core_global.h"
+#include "opencv2/core/core.hpp"
+#include <QMetaType>
+#include <QSharedData>
+
+namespace DesignNet{
+
+class MatPayloadData : public QSharedData
+{
+public:
+	MatPayloadData() : bAdopted(false) {}
+	cv::Mat mat;
+	bool	bAdopted;	//!< 缓冲区来自MatPayload(const cv::Mat&)，外部可能还持有
+};
+
+/*!
+ * \brief 在端口之间传递的cv::Mat数据
+ *
+ * 不可变、引用计数的数据，复制MatPayload只增加引用计数，不复制图像缓冲区。
+ * 只有通过mutableMat()请求可写数据，并且缓冲区同时被其它MatPayload使用时才会复制（写时复制）。
+ * mat()返回的cv::Mat不计入引用，之后的写入会改变它的内容，需要保留数据时复制MatPayload。
+ */
+class DESIGNNET_CORE_EXPORT MatPayload
+{
+public:
+	MatPayload();
+	MatPayload(const cv::Mat &mat);		//!< 共享\e mat 的缓冲区，不复制数据，第一次写入时复制
+
+	const cv::Mat& mat() const;			//!< 只读数据
+	cv::Mat& mutableMat();				//!< 可写数据，必要时复制缓冲区
+	cv::Mat& create(int rows, int cols, int type);	//!< 可写数据，大小或类型不同或者缓冲区被共享时从MatBufferPool重新申请
+	void assign(const cv::Mat &mat);	//!< 复制\e mat 的数据，缓冲区的申请与create()相同
+
+	bool isEmpty() const;
+	bool isShared() const;				//!< 缓冲区是否同时被其它MatPayload或者外部的cv::Mat使用
+	size_t byteSize() const;			//!< 缓冲区大小
+
+protected:
+	QExplicitlySharedDataPointer<MatPayloadData> d;
+};
+
+}
+
+Q_DECLARE_TYPEINFO(DesignNet::MatPayload, Q_MOVABLE_TYPE);
+Q_DECLARE_METATYPE(DesignNet::MatPayload)
+
+#endif // MATPAYLOAD_H
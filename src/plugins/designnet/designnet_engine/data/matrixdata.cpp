@@ -0,0 +1,158 @@
+#include "designnetconstants.h"
+#include "matrixdata.h"
+#include "Utils/XML/xmldeserializer.h"
+#include "Utils/XML/xmlserializer.h"
+
+namespace DesignNet{
+
+MatrixData::MatrixData(QObject *parent)
+	: IData(parent),
+	m_pendingRows(0),
+	m_pendingCols(0),
+	m_pendingType(CV_8UC1)
+{
+//	m_image.load(QLatin1String(Constants::DATA_IMAGE_MATRIX));
+}
+
+MatrixData::~MatrixData()
+{
+
+}
+
+Core::Id MatrixData::id()
+{
+	return Constants::DATA_TYPE_MATRIX;
+}
+
+IData* MatrixData::clone( QObject *parent /*= 0*/ )
+{
+	MatrixData *data = new MatrixData(parent);
+	data->copy(this);
+	return data;
+}
+
+bool MatrixData::copy( IData* data )
+{
+	if(data->id() != this->id())
+		return false;
+	MatrixData *matrix = qobject_cast<MatrixData*>(data);
+	matrix->load();
+	QMutexLocker locker(&m_loadMutex);
+	m_pending.clear();
+	m_matrix = matrix->m_matrix;
+	return IData::copy(data);
+}
+
+void MatrixData::setMatrix(const cv::Mat &matrix )
+{
+	QMutexLocker locker(&m_loadMutex);
+	m_pending.clear();
+	m_matrix.assign(matrix);
+}
+
+cv::Mat & MatrixData::getMatrix()
+{
+	load();
+	return m_matrix.mutableMat();
+}
+
+cv::Mat & MatrixData::createMatrix( int rows, int cols, int cvType )
+{
+	QMutexLocker locker(&m_loadMutex);
+	m_pending.clear();
+	return m_matrix.create(rows, cols, cvType);
+}
+
+const cv::Mat & MatrixData::matrix() const
+{
+	load();
+	return m_matrix.mat();
+}
+
+/*!
+ * \brief 保存矩阵
+ *
+ * 数据以serializeBinary()保存，二进制格式中不经过文本转换，XML中为base64。
+ */
+void MatrixData::serialize( Utils::XmlSerializer &s, const QString &key ) const
+{
+	const cv::Mat &mat = matrix();
+	s.serialize(key + QLatin1String(".rows"), mat.rows);
+	s.serialize(key + QLatin1String(".cols"), mat.cols);
+	s.serialize(key + QLatin1String(".type"), mat.type());
+	if (mat.empty())
+		return;
+	const cv::Mat continuous = mat.isContinuous() ? mat : mat.clone();
+	s.serializeBinary(key, QByteArray(reinterpret_cast<const char*>(continuous.data),
+		int(continuous.total() * continuous.elemSize())));
+}
+
+void MatrixData::deserialize( Utils::XmlDeserializer &s, const QString &key )
+{
+	int rows = 0;
+	int cols = 0;
+	int type = CV_8UC1;
+	s.deserialize(key + QLatin1String(".rows"), rows);
+	s.deserialize(key + QLatin1String(".cols"), cols);
+	s.deserialize(key + QLatin1String(".type"), type);
+	QMutexLocker locker(&m_loadMutex);
+	m_matrix = MatPayload();
+	m_pending.clear();
+	if (rows <= 0 || cols <= 0)
+		return;
+	m_pendingRows = rows;
+	m_pendingCols = cols;
+	m_pendingType = type;
+	m_pending = s.placeholder(key);
+}
+
+bool MatrixData::isLoaded() const
+{
+	QMutexLocker locker(&m_loadMutex);
+	return m_pending.isNull();
+}
+
+void MatrixData::load() const
+{
+	QMutexLocker locker(&m_loadMutex);
+	if (m_pending.isNull())
+		return;
+	const QByteArray data = m_pending.binary();
+	m_pending.clear();
+	cv::Mat &mat = m_matrix.create(m_pendingRows, m_pendingCols, m_pendingType);
+	if (size_t(data.size()) == mat.total() * mat.elemSize())
+		memcpy(mat.data, data.constData(), data.size());
+	else
+		mat.setTo(cv::Scalar::all(0));
+}
+
+MatPayload MatrixData::payload() const
+{
+	load();
+	return m_matrix;
+}
+
+void MatrixData::setPayload( const MatPayload &payload )
+{
+	QMutexLocker locker(&m_loadMutex);
+	m_pending.clear();
+	m_matrix = payload;
+}
+
+bool MatrixData::isValid() const
+{
+	if (!isLoaded())
+		return true;
+	if (m_matrix.isEmpty())
+	{
+		return false;
+	}
+	return true;
+}
+
+QImage MatrixData::image()
+{
+	return m_image;
+}
+
+}
@@ -0,0 +1,55 @@
+#ifndef MATRIXDATA_H
+#define MATRIXDATA_H
+
+#include "opencv2/core/core.hpp"
+#include "idata.h"
+#include "matpayload.h"
+#include "Utils/XML/xmlplaceholder.h"
+#include <QMutex>
+
+namespace Utils{
+class XmlDeserializer;
+class XmlSerializer;
+}
+
+namespace DesignNet{
+
+class DESIGNNET_CORE_EXPORT MatrixData : public IData
+{
+	Q_OBJECT
+public:
+	explicit MatrixData(QObject *parent = 0);
+	~MatrixData();
+
+	virtual Core::Id id();
+	IData* clone(QObject *parent = 0);
+	virtual bool copy(IData* data);			//!< 共享\e data 的缓冲区
+
+	void setMatrix(const cv::Mat &matrix);	//!< 复制\e matrix 的数据，之后修改\e matrix 不影响本对象
+	cv::Mat &getMatrix();					//!< 可写数据，写时复制
+	cv::Mat &createMatrix(int rows, int cols, int cvType);	//!< 可写数据，缓冲区来自MatBufferPool
+	const cv::Mat &matrix() const;			//!< 只读数据
+	MatPayload payload() const;
+	void setPayload(const MatPayload &payload);	//!< 共享\e payload 的缓冲区，写入时复制
+	virtual bool isValid() const;
+	virtual QImage image();
+
+	void serialize(Utils::XmlSerializer &s, const QString &key) const;	//!< 以\e key 为前缀保存矩阵的大小、类型和数据
+	void deserialize(Utils::XmlDeserializer &s, const QString &key);	//!< 只读取大小和类型，数据在第一次访问时读取
+	bool isLoaded() const;
+
+protected:
+	void load() const;					//!< 读取延迟载入的数据
+
+	mutable MatPayload	m_matrix;
+	QImage				m_image;
+	mutable QMutex		m_loadMutex;
+	mutable Utils::XmlPlaceholder	m_pending;	//!< 还没有读取的数据
+	int					m_pendingRows;
+	int					m_pendingCols;
+	int					m_pendingType;
+};
+
+}
+
+#endif // MATRIXDATA_H
@@ -0,0 +1,629 @@
+#include "designnetspace.h"
+#include "resultcache.h"
+#include "utils/totemassert.h"
+#include "Utils/XML/xmlserializer.h"
+#include "Utils/XML/xmldeserializer.h"
+#include "utils/runextensions.h"
+#include <QDebug>
+#include <QFutureSynchronizer>
+#include <QThread>
+#include <QThreadStorage>
+using namespace Utils;
+namespace DesignNet{
+
+///
+/// 当前线程中正在读取的DesignNetSpace层数，大于0时嵌套的DesignNetSpace延迟载入
+static QThreadStorage<int> s_deserializeDepth;
+
+void Connection::serialize( XmlSerializer& s ) const
+{
+	if (m_srcProcessor == -1 || -1 == m_targetProcessor)
+		return;
+
+	s.serialize("src_processor", m_srcProcessor);
+	s.serialize("src_port", m_srcPort);
+
+	s.serialize("target_processor", m_targetProcessor);
+	s.serialize("target_port", m_targetPort);
+}
+
+void Connection::deserialize( XmlDeserializer& s )
+{
+	s.deserialize("src_processor", m_srcProcessor);
+	s.deserialize("src_port", m_srcPort);
+
+	s.deserialize("target_processor", m_targetProcessor);
+	s.deserialize("target_port", m_targetPort);
+}
+
+Connection::Connection( const Connection &c )
+{
+	m_srcProcessor	= c.m_srcProcessor;
+	m_srcPort		= c.m_srcPort;
+	m_targetProcessor	= c.m_targetProcessor;
+	m_targetPort	= c.m_targetPort;
+}
+
+
+DesignNetSpace::DesignNetSpace(DesignNetSpace *space, QObject *parent) :
+    Processor(space, parent, ProcessorType_Permanent),
+	m_scheduler(new NetScheduler),
+	m_bPlanValid(false),
+	m_iProcessTimeout(0),
+	m_bStreaming(false),
+	m_iStreamCapacity(4),
+	m_bIncremental(false),
+	m_loadMutex(QMutex::Recursive)
+{
+}
+
+DesignNetSpace::~DesignNetSpace()
+{
+	delete m_scheduler;
+}
+
+void DesignNetSpace::addProcessor(Processor *processor, bool bNotifyModify)
+{
+    TOTEM_ASSERT(processor != 0, return);
+	load();
+    bool bret = contains(processor);
+    if(bret)
+    {
+        emit logout(tr("can't add the exist processor to the space"));
+        return;
+    }
+	processor->setSpace(this);
+	invalidatePlan();
+	if (processor->id() == -1)
+	{
+		int iUID = generateUID();
+		processor->setID(iUID);
+	}
+    m_processors.push_back(processor);
+	
+	QObject::connect(processor, SIGNAL(connected(Processor*, Processor*)), this, SIGNAL(connectionAdded(Processor*, Processor*)));
+	QObject::connect(processor, SIGNAL(disconnected(Processor*, Processor*)), this, SIGNAL(connectionRemoved(Processor*, Processor*)));
+	QObject::connect(processor, SIGNAL(processorModified()), this, SIGNAL(modified()));
+
+	emit processorAdded(processor);
+	if (bNotifyModify)
+		emit modified();
+}
+
+void DesignNetSpace::removeProcessor(Processor *processor, bool bNotifyModify)
+{
+	if (processor == 0)
+	{
+		foreach (Processor* p, m_processors)
+			removeProcessor(processor, bNotifyModify);
+		return ;
+	}
+	load();
+	processor->detach();
+	QList<Processor*>::const_iterator itr = (qFind(m_processors, processor));
+	TOTEM_ASSERT(itr != m_processors.end(), qDebug()<< "can't remove the processor");
+	m_processors.removeOne(processor);
+	invalidatePlan();
+	emit processorRemoved(processor);
+	delete processor;
+
+	if (bNotifyModify)
+		emit modified();
+}
+
+bool DesignNetSpace::contains(Processor *processor)
+{
+	load();
+    return (qFind(m_processors, processor) != m_processors.constEnd());
+}
+
+Processor *DesignNetSpace::create(DesignNetSpace *space) const
+{
+    DesignNetSpace *s = new DesignNetSpace(space, parent());
+    return s;
+}
+
+QString DesignNetSpace::name() const
+{
+    return QString("DesignNetSpace");
+}
+
+int DesignNetSpace::generateUID()
+{
+	load();
+	int maxID = 0;
+	foreach(Processor *processor, m_processors)
+	{
+		maxID = qMax(processor->id(), maxID);
+		maxID++;
+	}
+    return maxID; 
+}
+
+void DesignNetSpace::propertyRemoving(Property *prop)
+{
+}
+
+void DesignNetSpace::propertyRemoved(Property *prop)
+{
+}
+
+/*!
+ * \brief 准备执行
+ *
+ * 按拓扑序调用每个处理器的prepareProcess()，处理器可以在其中用inputSlot()查找输入槽。
+ * 之后建立执行计划，处理器在prepareProcess()中增删端口时计划也是最新的。
+ * 必须在DesignNetSpace所在的线程中调用：延迟载入的处理器在这里读取，
+ * 嵌套的DesignNetSpace由其prepareProcess()递归读取，执行时工作线程不再修改m_processors。
+ */
+bool DesignNetSpace::prepareProcess()
+{
+	Q_ASSERT(QThread::currentThread() == thread());
+	load();
+	QList<Processor*> sorted;
+
+	if(!sortProcessors(sorted))
+	{
+		emit logout(tr("The designnet space can't be processed. Maybe there are some circle relationships in the space."));
+		return false;
+	}
+	foreach(Processor* processor, sorted)
+	{
+		if (!processor->prepareProcess())
+			return false;
+	}
+	return buildPlan();
+}
+
+void DesignNetSpace::invalidatePlan()
+{
+	m_bPlanValid = false;
+}
+
+bool DesignNetSpace::buildPlan()
+{
+	QList<Processor*> sorted;
+	if (!sortProcessors(sorted))
+	{
+		emit logout(tr("The designnet space can't be processed. Maybe there are some circle relationships in the space."));
+		return false;
+	}
+	///
+	/// 没有调用prepareProcess()就执行时，嵌套的DesignNetSpace也在这里载入并建立计划，
+	/// 而不是在执行它的工作线程中
+	foreach (Processor *processor, sorted)
+	{
+		DesignNetSpace *space = qobject_cast<DesignNetSpace*>(processor);
+		if (space && !space->m_bPlanValid && !space->buildPlan())
+			return false;
+	}
+	m_plan.build(sorted);
+	m_bPlanValid = true;
+	return true;
+}
+
+bool DesignNetSpace::isCacheable() const
+{
+	return false;
+}
+
+bool DesignNetSpace::process(QFutureInterface<ProcessResult> &future)
+{	
+    ///
+    /// \brief 图结构没有变化时直接使用prepareProcess()建立的执行计划
+    ///
+	if (!m_bPlanValid && !buildPlan())
+		return false;
+	///
+	/// 流水线方式：源处理器根据m_bNeedLoop逐帧产生数据，各级处理器同时处理不同的帧
+	if (m_bStreaming)
+	{
+		if (!m_scheduler->runStream(m_plan, m_iStreamCapacity))
+		{
+			if (m_scheduler->wasCanceled())
+			{
+				m_canceled.store(1);
+				emit logout(tr("The designnet space was stopped at frame %1 because it was canceled or exceeded the deadline.")
+					.arg(m_scheduler->framesProcessed()));
+			}
+			else
+				emit logout(tr("The designnet space failed to process frame %1.").arg(m_scheduler->framesProcessed()));
+			return false;
+		}
+		emit logout(tr("The designnet space has processed %1 frames.").arg(m_scheduler->framesProcessed()));
+		return true;
+	}
+	///
+	/// 由调度器按照依赖关系并行执行，父处理器全部完成后子处理器立即被派发
+	if (!m_scheduler->run(m_plan, m_bIncremental))
+	{
+		///
+		/// 调度器已经结束，标记自身被取消，Processor::run()据此设置ProcessResult::m_bCanceled
+		if (m_scheduler->wasCanceled())
+		{
+			m_canceled.store(1);
+			emit logout(tr("The designnet space was stopped because it was canceled or exceeded the deadline."));
+		}
+		else
+			emit logout(tr("The designnet space failed to process."));
+		return false;
+	}
+	
+	if (m_scheduler->processorsSkipped() > 0)
+		emit logout(tr("The designnet space has been processed, %1 of %2 processors reused the previous results.")
+			.arg(m_scheduler->processorsSkipped()).arg(m_plan.size()));
+	else
+		emit logout(tr("The designnet space has been processed."));
+	return true;
+}
+
+bool DesignNetSpace::finishProcess()
+{
+	emit processFinished();
+	return true;
+}
+
+Core::Id DesignNetSpace::typeID() const
+{
+    return CORE_ID("DesignNetSpace/DesignNetSpace");
+}
+
+QString DesignNetSpace::category() const
+{
+    return tr("DesignNetSpace");
+}
+
+void DesignNetSpace::onShowMessage(QString log)
+{
+    emit logout(log);
+}
+
+void DesignNetSpace::onPropertyChanged_internal()
+{
+	Property *prop = qobject_cast<Property*>(sender());
+	if(prop)
+		propertyChanged(prop);
+}
+
+void DesignNetSpace::propertyChanged(Property *prop)
+{
+	
+}
+
+void DesignNetSpace::propertyAdded(Property* prop)
+{
+	QObject::connect(prop, SIGNAL(changed()), this, SLOT(onPropertyChanged_internal()));	
+}
+
+void DesignNetSpace::serialize(Utils::XmlSerializer& s) const
+{
+	load();
+	Processor::serialize(s);
+	s.serialize("processors", m_processors, "processor");
+	QList<Connection> vecConn;
+	for (QList<Processor*>::const_iterator itr = m_processors.begin(); itr != m_processors.end(); itr++)
+	{
+		const QList<Port*> ports = (*itr)->getPorts(Port::OUT_PORT);
+		for (QList<Port*>::const_iterator itrPort = ports.begin(); itrPort != ports.end(); itrPort++)
+		{
+			const QList<Port*> portsConnected = (*itrPort)->connectedPorts();
+			for (QList<Port*>::const_iterator i = portsConnected.begin(); i != portsConnected.end(); i++)
+			{
+				Connection cnn;
+				cnn.m_srcProcessor	= (*itr)->id();
+				cnn.m_srcPort		= (*itrPort)->getIndex();
+				cnn.m_targetProcessor	= (*i)->processor()->id();
+				cnn.m_targetPort	= (*i)->getIndex();
+				vecConn.push_back(cnn);
+			}
+		}
+	}
+	s.serialize("Connections", vecConn, "Connection");
+}
+
+/*!
+ * \brief 读取DesignNetSpace
+ *
+ * 嵌套在其它DesignNetSpace中的DesignNetSpace只读取自身的属性，处理器和连接记录在m_pending中，
+ * 第一次执行、访问处理器或者保存时由load()读取。
+ */
+void DesignNetSpace::deserialize(Utils::XmlDeserializer& s)
+{
+	Processor::deserialize(s);
+	if (s_deserializeDepth.localData() > 0)
+	{
+		QMutexLocker locker(&m_loadMutex);
+		m_pending = s.placeholder();
+		return;
+	}
+	deserializeChildren(s);
+}
+
+void DesignNetSpace::load() const
+{
+	QMutexLocker locker(&m_loadMutex);
+	if (m_pending.isNull())
+		return;
+	const Utils::XmlPlaceholder pending = m_pending;
+	m_pending.clear();
+	DesignNetSpace *space = const_cast<DesignNetSpace*>(this);
+	space->deserializeChildren(*pending.deserializer());
+	///
+	/// prepareProcess()和buildPlan()保证执行前已经在所在线程中载入，这里只处理直接在其它线程中访问的情况，
+	/// 处理器需要移到DesignNetSpace所在的线程
+	if (QThread::currentThread() != thread())
+	{
+		foreach (Processor *processor, m_processors)
+		{
+			if (!processor->parent())
+				processor->moveToThread(thread());
+		}
+	}
+}
+
+bool DesignNetSpace::isLoaded() const
+{
+	QMutexLocker locker(&m_loadMutex);
+	return m_pending.isNull();
+}
+
+void DesignNetSpace::deserializeChildren(Utils::XmlDeserializer& s)
+{
+	s_deserializeDepth.localData()++;
+	QList<Processor*> processors;
+	s.deserializeCollection("processors", processors, "processor");
+	foreach(Processor* p, processors)
+	{
+		p->init();
+		addProcessor(p);
+	}
+	QList<Connection> connections;
+	s.deserializeCollection("Connections", connections, "Connection");
+	foreach(Connection c, connections)
+	{
+		Processor *srcProcessor = findProcessor(c.m_srcProcessor);
+		Processor *targetProcessor = findProcessor(c.m_targetProcessor);
+		if (!srcProcessor || !targetProcessor)
+		{
+			emit logout(tr("Cannot add the connection from processor %1 to processor %2").arg(c.m_srcProcessor).arg(c.m_targetProcessor));
+			continue;
+		}
+		else
+		{
+			Port *srcPort = srcProcessor->getPort(c.m_srcPort);
+			Port *targetPort = targetProcessor->getPort(c.m_targetPort);
+			if (!srcPort)
+			{
+				emit logout(tr("Cannot add the connection from port [%1] to port [%2] because source port is empty.")
+					.arg(c.m_srcPort).arg(c.m_targetPort));
+				continue;
+			}
+			if (!targetPort)
+			{
+				emit logout(tr("Cannot add the connection from port [%1] to port [%2]  because target port is empty")
+					.arg(c.m_srcPort).arg(c.m_targetPort));
+				continue;
+			}
+			if(!srcPort->connect(targetPort))
+			{
+				emit logout(tr("Cannot add the connection from port [%1] to port [%2] ")
+					.arg(c.m_srcPort).arg(c.m_targetPort));
+				continue;
+			}
+		}
+	}
+	s_deserializeDepth.localData()--;
+}
+
+QList<Processor*> DesignNetSpace::processors()
+{
+	load();
+	return m_processors;
+}
+
+Processor* DesignNetSpace::findProcessor(const int &id) const
+{
+	load();
+	foreach (Processor *p, m_processors)
+	{
+		if (p->id() == id)
+			return p;
+	}
+	return 0;
+}
+
+Processor* DesignNetSpace::findProcessor(const int &id)
+{
+	QList<Processor*> processorList = processors();
+	foreach(Processor* p, processorList)
+	{
+		if(p->id() == id)
+			return p;
+	}
+	return 0;
+}
+
+/*!
+ * \brief 创建副本
+ *
+ * 通过序列化在内存中复制一份DesignNetSpace：处理器由Processor::create()创建，
+ * 属性和连接与本对象相同，端口数据是独立的，因此多个副本可以同时处理不同的输入。
+ * 之后每个处理器通过shareResources()共享原处理器已经载入的只读资源。
+ * 执行方式（流水线、增量执行、ResultCache和期限）也一并复制。
+ */
+DesignNetSpace *DesignNetSpace::createReplica(QObject *parent) const
+{
+	load();
+	Utils::XmlSerializer s;
+	s.serialize("DesignNetSpace", *this);
+	Utils::XmlDeserializer ds(s.document());
+	DesignNetSpace *replica = new DesignNetSpace(0, parent);
+	replica->setObjectName(objectName());
+	ds.deserialize("DesignNetSpace", *replica);
+	replica->shareResources(this);
+	replica->setStreamingEnabled(m_bStreaming);
+	replica->setStreamQueueCapacity(m_iStreamCapacity);
+	replica->setIncrementalEnabled(m_bIncremental);
+	replica->setResultCacheEnabled(isResultCacheEnabled());
+	replica->setRunDeadline(runDeadline());
+	replica->setProcessTimeout(m_iProcessTimeout);
+	return replica;
+}
+
+/*!
+ * \brief 按ID把副本中的处理器与\e prototype 中的处理器对应起来，逐个共享资源
+ */
+void DesignNetSpace::shareResources(const Processor *prototype)
+{
+	const DesignNetSpace *space = qobject_cast<const DesignNetSpace*>(prototype);
+	if (!space)
+		return;
+	foreach (Processor *processor, processors())
+	{
+		if (const Processor *original = space->findProcessor(processor->id()))
+			processor->shareResources(original);
+	}
+}
+
+void DesignNetSpace::setModified()
+{
+	emit modified();
+}
+
+void DesignNetSpace::detachProcessor(Processor* processor)
+{
+	load();
+	QList<Processor*>::const_iterator itr = (qFind(m_processors, processor));
+	TOTEM_ASSERT(itr != m_processors.end(), qDebug()<< "can't not detach the processor");
+	processor->detach();
+}
+
+bool DesignNetSpace::isScheduling() const
+{
+	return m_scheduler->isRunning();
+}
+
+void DesignNetSpace::setStreamingEnabled( const bool &bEnabled )
+{
+	m_bStreaming = bEnabled;
+}
+
+bool DesignNetSpace::isStreamingEnabled() const
+{
+	return m_bStreaming;
+}
+
+void DesignNetSpace::setStreamQueueCapacity( const int &capacity )
+{
+	m_iStreamCapacity = qMax(capacity, 1);
+}
+
+int DesignNetSpace::streamQueueCapacity() const
+{
+	return m_iStreamCapacity;
+}
+
+void DesignNetSpace::setIncrementalEnabled( const bool &bEnabled )
+{
+	m_bIncremental = bEnabled;
+}
+
+bool DesignNetSpace::isIncrementalEnabled() const
+{
+	return m_bIncremental;
+}
+
+void DesignNetSpace::invalidateAll()
+{
+	load();
+	foreach (Processor* processor, m_processors)
+		processor->invalidate();
+	invalidate();
+}
+
+void DesignNetSpace::setResultCacheEnabled( const bool &bEnabled )
+{
+	m_scheduler->setResultCache(bEnabled ? ResultCache::instance() : 0);
+}
+
+bool DesignNetSpace::isResultCacheEnabled() const
+{
+	return m_scheduler->resultCache() != 0;
+}
+
+/*!
+ * \brief 取消执行
+ *
+ * 可以在任意线程中调用。尚未开始的处理器不再执行，正在执行的处理器在下一次检查
+ * Processor::isCanceled()时得知，嵌套的DesignNetSpace通过所在的DesignNetSpace得知。
+ * 被中断的处理器保持数据过期，下一次增量执行时重新执行。
+ */
+void DesignNetSpace::cancel()
+{
+	m_scheduler->cancel();
+	Processor::cancel();
+}
+
+bool DesignNetSpace::isCanceled() const
+{
+	return m_scheduler->isCanceled() || Processor::isCanceled();
+}
+
+void DesignNetSpace::setRunDeadline( const int &msecs )
+{
+	m_scheduler->setDeadline(msecs);
+}
+
+int DesignNetSpace::runDeadline() const
+{
+	return m_scheduler->deadline();
+}
+
+void DesignNetSpace::setProcessTimeout( const int &msecs )
+{
+	m_iProcessTimeout = qMax(msecs, 0);
+}
+
+int DesignNetSpace::processTimeout() const
+{
+	return m_iProcessTimeout;
+}
+
+bool DesignNetSpace::sortProcessors(QList<Processor*> &processors)
+{
+	Q_ASSERT(processors.size() == 0);
+	load();
+
+	///
+	/// Kahn算法，每个处理器的入度只计算一次
+	QHash<Processor*, int> degrees;
+	degrees.reserve(m_processors.size());
+	foreach (Processor* processor, m_processors)
+		degrees.insert(processor, 0);
+	foreach (Processor* processor, m_processors)
+	{
+		foreach (Processor* child, processor->getOutputProcessor())
+		{
+			QHash<Processor*, int>::iterator itr = degrees.find(child);
+			if (itr != degrees.end())
+				itr.value()++;
+		}
+	}
+	foreach (Processor* processor, m_processors)
+	{
+		if (degrees.value(processor) == 0)
+			processors.append(processor);
+	}
+	for (int i = 0; i < processors.size(); i++)
+	{
+		foreach (Processor* child, processors.at(i)->getOutputProcessor())
+		{
+			QHash<Processor*, int>::iterator itr = degrees.find(child);
+			if (itr != degrees.end() && --itr.value() == 0)
+				processors.append(child);
+		}
+	}
+	return processors.size() == m_processors.size();
+}
+
+}
\ No newline at end of file
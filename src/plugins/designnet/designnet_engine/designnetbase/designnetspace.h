@@ -0,0 +1,137 @@
+#ifndef DESIGNNETSPACE_H
+#define DESIGNNETSPACE_H
+
+#include <QObject>
+#include "processor.h"
+#include "executionplan.h"
+#include "netscheduler.h"
+#include "Utils/XML/xmlplaceholder.h"
+#include "Utils/XML/xmlserializable.h"
+
+#include <QList>
+#include <QHash>
+#include <QFutureWatcher>
+#include <QMutex>
+namespace DesignNet{
+
+class DESIGNNET_CORE_EXPORT Connection : public Utils::XmlSerializable
+{
+public:
+	
+	DECLARE_SERIALIZABLE_NOTYPE(Connection)
+
+	Connection(){ m_srcProcessor = -1; m_targetProcessor = -1; }
+	Connection(const Connection &c);
+	virtual void serialize(Utils::XmlSerializer& s) const;
+	virtual void deserialize(Utils::XmlDeserializer& s);
+	int			m_srcProcessor;
+	int			m_srcPort;
+	int			m_targetProcessor;
+	int			m_targetPort;
+};
+
+class DESIGNNET_CORE_EXPORT DesignNetSpace : public Processor
+{
+    Q_OBJECT
+public:
+
+	DECLARE_SERIALIZABLE(DesignNetSpace, DesignNetSpace)
+    
+	explicit DesignNetSpace(DesignNetSpace *space = 0, QObject *parent = 0);
+	~DesignNetSpace();
+
+    void addProcessor(Processor* processor, bool bNotifyModify = false);    //!< 添加处理器
+    void removeProcessor(Processor* processor, bool bNotifyModify = false); //!< 移除处理器,并delete
+	void detachProcessor(Processor* processor); //!< 取消该处理器所关联的Space
+
+    bool contains(Processor* processor);        //!< 是否包含该Processor
+    virtual Processor* create(DesignNetSpace *space = 0) const;          //!< 创建
+    virtual QString name() const;               //!< DesignNetSpace名称
+
+    int generateUID();
+    virtual void propertyRemoving(Property* prop);//!< 属性移除前调用
+    virtual void propertyRemoved(Property* prop); //!< 属性移除完成
+	virtual void propertyAdded(Property* prop);
+
+	virtual bool prepareProcess();		//!< 准备全部处理器并建立执行计划，在所在线程中调用，同时载入延迟载入的处理器
+	void invalidatePlan();				//!< 图结构有变化，下一次执行前重新建立执行计划
+	virtual bool isCacheable() const;	//!< 结果由内部的处理器决定，不能整体缓存
+	virtual void shareResources(const Processor *prototype);
+	virtual void cancel();				//!< 取消正在进行的执行，尚未开始的处理器不再执行，嵌套的DesignNetSpace一并停止
+	virtual bool isCanceled() const;
+	DesignNetSpace *createReplica(QObject *parent = 0) const;	//!< 创建用于数据并行执行的副本
+    virtual bool process(QFutureInterface<ProcessResult> &future);                     //!< 处理函数
+    virtual bool finishProcess();
+
+	virtual Core::Id typeID() const;            //!<
+    virtual QString category() const;//!< 返回种类
+	QList<Processor*> processors();
+	Processor* findProcessor(const int &id);
+	Processor* findProcessor(const int &id) const;
+	
+	void setModified();
+	bool isScheduling() const;		//!< 是否正在由调度器执行
+
+	void setStreamingEnabled(const bool &bEnabled = true);	//!< 以流水线方式处理图像序列
+	bool isStreamingEnabled() const;
+	void setStreamQueueCapacity(const int &capacity);		//!< 每条连接上最多缓存的帧数
+	int  streamQueueCapacity() const;
+
+	void setIncrementalEnabled(const bool &bEnabled = true);	//!< 只重新执行数据已过期的处理器，默认关闭，每次执行全部处理器
+	bool isIncrementalEnabled() const;
+	void invalidateAll();					//!< 下一次执行时重新执行全部处理器
+
+	void setResultCacheEnabled(const bool &bEnabled = true);	//!< 使用ResultCache复用相同输入的结果
+	bool isResultCacheEnabled() const;
+
+	void setRunDeadline(const int &msecs);		//!< 每次执行的时间上限，毫秒，超过后与cancel()相同，0表示不限制
+	int  runDeadline() const;
+	void setProcessTimeout(const int &msecs);	//!< 每个处理器单次执行的时间上限，毫秒，从该处理器开始执行时计时，不是一帧流过整个网络的期限；0表示不限制
+	int  processTimeout() const;
+	
+	virtual void serialize(Utils::XmlSerializer& s) const;
+	virtual void deserialize(Utils::XmlDeserializer& s) ;
+	void load() const;				//!< 读取延迟载入的处理器和连接，应在所在线程中调用
+	bool isLoaded() const;
+
+
+signals:
+
+    void processorAdded(Processor* processor);
+    void processorRemoved(Processor* processor);
+
+    void connectionAdded(Processor* father, Processor* pChild);
+    void connectionRemoved(Processor* father, Processor* pChild);
+	void connectionRemoved(Port* src, Port* target);
+	void modified();
+	void loadFinished();//!< 载入完成
+
+public slots:
+
+	void onPropertyChanged_internal();
+	void onShowMessage(QString log);
+
+protected:
+
+	virtual QList<ProcessData> dataProvided() { return QList<ProcessData>(); }
+	
+	virtual void propertyChanged(Property *prop);
+	bool sortProcessors(QList<Processor*> &processors);// 拓扑排序
+	bool buildPlan();				//!< 拓扑排序后建立m_plan，有环时返回false
+	void deserializeChildren(Utils::XmlDeserializer& s);	//!< 读取处理器和连接
+
+    QList<Processor*> m_processors;
+	QHash<Processor*, QFutureWatcher<bool>* > m_processorWatchers;//!< 监控着所有正在执行的Processor。
+	NetScheduler*	m_scheduler;		//!< DAG调度器
+	ExecutionPlan	m_plan;				//!< prepareProcess()建立的执行计划
+	bool			m_bPlanValid;		//!< 连接、端口或处理器有变化后为false
+	int				m_iProcessTimeout;	//!< 毫秒
+	bool			m_bStreaming;		//!< 是否以流水线方式执行
+	int				m_iStreamCapacity;
+	bool			m_bIncremental;		//!< 是否增量执行
+	mutable QMutex	m_loadMutex;
+	mutable Utils::XmlPlaceholder	m_pending;	//!< 嵌套的DesignNetSpace打开时只记录位置，第一次使用时读取
+};
+}
+
+#endif // DESIGNNETSPACE_H
@@ -0,0 +1,94 @@
+#include "executionplan.h"
+#include "port.h"
+#include "processor.h"
+#include <QHash>
+#include <QtAlgorithms>
+
+namespace DesignNet{
+
+ExecutionPlan::ExecutionPlan()
+	: m_iRevision(0)
+{
+}
+
+void ExecutionPlan::build( const QList<Processor*> &sortedProcessors )
+{
+	clear();
+	const int count = sortedProcessors.size();
+	m_processors = sortedProcessors.toVector();
+	m_parentCounts.fill(0, count);
+	m_childOffsets.reserve(count + 1);
+	m_outEdgeOffsets.reserve(count + 1);
+
+	QHash<Processor*, int> indexes;
+	indexes.reserve(count);
+	for (int i = 0; i < count; i++)
+		indexes.insert(m_processors[i], i);
+
+	for (int i = 0; i < count; i++)
+	{
+		Processor *processor = m_processors[i];
+		processor->freezePorts();
+		m_childOffsets << m_children.size();
+		m_outEdgeOffsets << m_edges.size();
+		const int firstChild = m_children.size();
+		foreach (Port* srcPort, processor->getPorts(Port::OUT_PORT))
+		{
+			foreach (Port* dstPort, srcPort->connectedPorts())
+			{
+				///
+				/// 只统计同一个Space中的连接
+				const int dst = indexes.value(dstPort->processor(), -1);
+				if (dst == -1)
+					continue;
+				Edge edge = { i, dst, srcPort, dstPort };
+				m_edges << edge;
+				if (qFind(m_children.constBegin() + firstChild, m_children.constEnd(), dst) == m_children.constEnd())
+				{
+					m_children << dst;
+					m_parentCounts[dst]++;
+				}
+			}
+		}
+	}
+	m_childOffsets << m_children.size();
+	m_outEdgeOffsets << m_edges.size();
+
+	///
+	/// 计数排序得到按目标处理器排列的边
+	m_inEdgeOffsets.fill(0, count + 1);
+	for (int i = 0; i < m_edges.size(); i++)
+		m_inEdgeOffsets[m_edges[i].dst + 1]++;
+	for (int i = 0; i < count; i++)
+		m_inEdgeOffsets[i + 1] += m_inEdgeOffsets[i];
+	QVector<int> next = m_inEdgeOffsets;
+	m_inEdges.resize(m_edges.size());
+	for (int i = 0; i < m_edges.size(); i++)
+		m_inEdges[next[m_edges[i].dst]++] = i;
+
+	m_iRevision++;
+}
+
+void ExecutionPlan::clear()
+{
+	m_processors.clear();
+	m_parentCounts.clear();
+	m_childOffsets.clear();
+	m_children.clear();
+	m_edges.clear();
+	m_outEdgeOffsets.clear();
+	m_inEdges.clear();
+	m_inEdgeOffsets.clear();
+}
+
+const int* ExecutionPlan::inEdgeBegin( int index ) const
+{
+	return m_inEdges.constData() + m_inEdgeOffsets.at(index);
+}
+
+const int* ExecutionPlan::inEdgeEnd( int index ) const
+{
+	return m_inEdges.constData() + m_inEdgeOffsets.at(index + 1);
+}
+
+}
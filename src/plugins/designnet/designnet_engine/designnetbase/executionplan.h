@@ -0,0 +1,71 @@
+#ifndef EXECUTIONPLAN_H
+#define EXECUTIONPLAN_H
+
+#include "../designnet_core_global.h"
+#include <QList>
+#include <QVector>
+
+namespace DesignNet{
+
+class Port;
+class Processor;
+
+/*!
+ * \brief 冻结的执行计划
+ *
+ * 由DesignNetSpace::prepareProcess()根据拓扑排序的结果建立，连接、端口或者处理器有变化之后失效，
+ * 下一次执行前重新建立。处理器按拓扑序编号，图结构保存为CSR（压缩行）数组：
+ * 第i个处理器的子处理器为children[childOffsets[i]] ~ children[childOffsets[i + 1] - 1]，
+ * 端口连接（边）按源处理器排列，另有按目标处理器排列的下标。
+ * 同一对处理器之间的多条连接只算一个父子关系。
+ *
+ * 建立时每个处理器的输入端口也被冻结为按下标访问的槽（Processor::inputData()）。
+ * 执行时只读取这些数组，不再查询端口名称或者重新计算父子处理器列表。
+ */
+class DESIGNNET_CORE_EXPORT ExecutionPlan
+{
+public:
+	struct Edge
+	{
+		int		src;		//!< 源处理器的序号
+		int		dst;		//!< 目标处理器的序号
+		Port*	srcPort;
+		Port*	dstPort;
+	};
+
+	ExecutionPlan();
+
+	void build(const QList<Processor*> &sortedProcessors);	//!< \e sortedProcessors 必须是拓扑序
+	void clear();
+	int revision() const { return m_iRevision; }	//!< 每次build()加一，用于判断计划是否变化
+
+	int size() const { return m_processors.size(); }
+	Processor* processor(int index) const { return m_processors.at(index); }
+	int parentCount(int index) const { return m_parentCounts.at(index); }	//!< 同一个Space中父处理器的个数
+
+	int childCount(int index) const { return m_childOffsets.at(index + 1) - m_childOffsets.at(index); }
+	const int* childBegin(int index) const { return m_children.constData() + m_childOffsets.at(index); }
+	const int* childEnd(int index) const { return m_children.constData() + m_childOffsets.at(index + 1); }
+
+	int edgeCount() const { return m_edges.size(); }
+	const Edge& edge(int index) const { return m_edges.at(index); }
+	int outEdgeBegin(int index) const { return m_outEdgeOffsets.at(index); }	//!< 第\e index 个处理器的输出边为edge(outEdgeBegin()) ~ edge(outEdgeEnd() - 1)
+	int outEdgeEnd(int index) const { return m_outEdgeOffsets.at(index + 1); }
+	const int* inEdgeBegin(int index) const;	//!< 第\e index 个处理器的输入边，元素为edge()的下标
+	const int* inEdgeEnd(int index) const;
+
+protected:
+	QVector<Processor*>	m_processors;		//!< 拓扑序
+	QVector<int>		m_parentCounts;
+	QVector<int>		m_childOffsets;		//!< size() + 1个元素
+	QVector<int>		m_children;
+	QVector<Edge>		m_edges;			//!< 按源处理器排列
+	QVector<int>		m_outEdgeOffsets;
+	QVector<int>		m_inEdges;			//!< 按目标处理器排列的边下标
+	QVector<int>		m_inEdgeOffsets;
+	int					m_iRevision;
+};
+
+}
+
+#endif // EXECUTIONPLAN_H
@@ -0,0 +1,484 @@
+#include "netscheduler.h"
+#include "executionplan.h"
+#include "processor.h"
+#include "processorexecutor.h"
+#include "processorprofiler.h"
+#include "resultcache.h"
+#include <QMutexLocker>
+#include <QRunnable>
+
+namespace DesignNet{
+
+class NetSchedulerTask : public QRunnable
+{
+public:
+	NetSchedulerTask(NetScheduler *scheduler, int index)
+		: m_scheduler(scheduler), m_index(index)
+	{
+		setAutoDelete(true);
+	}
+	void run()
+	{
+		m_scheduler->execute(m_index);
+	}
+protected:
+	NetScheduler*	m_scheduler;
+	int				m_index;
+};
+
+class NetStreamTask : public QRunnable
+{
+public:
+	NetStreamTask(NetScheduler *scheduler, int index)
+		: m_scheduler(scheduler), m_index(index)
+	{
+		setAutoDelete(true);
+	}
+	void run()
+	{
+		m_scheduler->executeStream(m_index);
+	}
+protected:
+	NetScheduler*	m_scheduler;
+	int				m_index;
+};
+
+NetScheduler::NetScheduler()
+	: m_plan(0), m_iRevision(-1), m_iDeadline(0), m_bCanceled(false), m_iCapacity(4), m_iFrames(0), m_cache(0)
+{
+}
+
+NetScheduler::~NetScheduler()
+{
+	qDeleteAll(m_nodes);
+	qDeleteAll(m_streamNodes);
+	qDeleteAll(m_streamEdges);
+}
+
+bool NetScheduler::run( const ExecutionPlan &plan, bool bIncremental )
+{
+	if (!m_running.testAndSetOrdered(0, 1))
+		return false;
+
+	m_canceled.store(0);
+	m_timer.start();
+	build(plan);
+	foreach (Node* node, m_nodes)
+	{
+		const bool bOutdated = !bIncremental || node->processor->isDataDirty()
+			|| node->processor->result().m_bNeedLoop;
+		node->outdated.store(bOutdated ? 1 : 0);
+	}
+	m_skipped.store(0);
+	m_failed.store(0);
+	m_remaining.store(m_nodes.size());
+
+	///
+	/// 派发之后计数会被其它线程修改，入度为0的处理器按计划中不变的父处理器个数判断
+	for (int i = 0; i < m_nodes.size(); i++)
+	{
+		if (plan.parentCount(i) == 0)
+			dispatch(i);
+	}
+
+	waitForFinished();
+	m_bCanceled = isCanceled();
+	m_running.store(0);
+	return m_failed.load() == 0;
+}
+
+bool NetScheduler::runStream( const ExecutionPlan &plan, int queueCapacity )
+{
+	if (!m_running.testAndSetOrdered(0, 1))
+		return false;
+
+	m_canceled.store(0);
+	m_timer.start();
+	build(plan);
+	buildStream();
+	m_iCapacity = qMax(queueCapacity, 1);
+	m_iFrames.store(0);
+	m_failed.store(0);
+	m_remaining.store(m_nodes.size());
+	{
+		QMutexLocker locker(&m_streamMutex);
+		for (int i = 0; i < m_streamNodes.size(); i++)
+			updateStream(i);
+	}
+
+	waitForFinished();
+	m_bCanceled = isCanceled();
+	m_running.store(0);
+	return m_failed.load() == 0;
+}
+
+int NetScheduler::framesProcessed() const
+{
+	return m_iFrames.load();
+}
+
+int NetScheduler::processorsSkipped() const
+{
+	return m_skipped.load();
+}
+
+void NetScheduler::setResultCache( ResultCache *cache )
+{
+	m_cache = cache;
+}
+
+ResultCache* NetScheduler::resultCache() const
+{
+	return m_cache;
+}
+
+void NetScheduler::cancel()
+{
+	m_canceled.store(1);
+}
+
+bool NetScheduler::isCanceled() const
+{
+	if (m_running.load() == 0)
+		return false;
+	if (m_canceled.load() != 0)
+		return true;
+	return m_iDeadline > 0 && m_timer.elapsed() > m_iDeadline;
+}
+
+bool NetScheduler::wasCanceled() const
+{
+	return m_bCanceled;
+}
+
+void NetScheduler::setDeadline( int msecs )
+{
+	m_iDeadline = qMax(msecs, 0);
+}
+
+int NetScheduler::deadline() const
+{
+	return m_iDeadline;
+}
+
+void NetScheduler::waitForFinished()
+{
+	///
+	/// 嵌套的DesignNetSpace在工作线程中执行，等待时帮助执行其它任务
+	ProcessorExecutor *executor = ProcessorExecutor::instance();
+	while (executor->isWorkerThread())
+	{
+		const int completed = executor->completedTasks();
+		if (m_remaining.load() == 0)
+			break;
+		if (!executor->tryRunOne())
+			executor->waitForTask(completed);
+	}
+	{
+		QMutexLocker locker(&m_mutex);
+		while (m_remaining.load() > 0)
+			m_finished.wait(&m_mutex);
+	}
+}
+
+bool NetScheduler::isRunning() const
+{
+	return m_running.load() != 0;
+}
+
+void NetScheduler::build( const ExecutionPlan &plan )
+{
+	///
+	/// 计划没有变化时只重置计数
+	if (m_plan != &plan || m_iRevision != plan.revision())
+	{
+		qDeleteAll(m_nodes);
+		m_nodes.clear();
+		m_nodes.reserve(plan.size());
+		for (int i = 0; i < plan.size(); i++)
+		{
+			Node *node = new Node;
+			node->processor = plan.processor(i);
+			m_nodes.push_back(node);
+		}
+		m_plan		= &plan;
+		m_iRevision	= plan.revision();
+	}
+	for (int i = 0; i < m_nodes.size(); i++)
+		m_nodes[i]->pending.store(plan.parentCount(i));
+}
+
+void NetScheduler::dispatch( int index )
+{
+	///
+	/// 已经有处理器失败或者执行被取消，后续的处理器不再执行，直接标记为完成
+	if (m_failed.load() != 0 || isCanceled())
+	{
+		finished(index, false);
+		return;
+	}
+	///
+	/// 结果没有过期，不需要执行
+	if (m_nodes[index]->outdated.load() == 0)
+	{
+		m_skipped.ref();
+		finished(index, true);
+		return;
+	}
+	if (ProcessorProfiler *profiler = ProcessorProfiler::active())
+		profiler->queued(m_nodes[index]->processor);
+	ProcessorExecutor::instance()->start(new NetSchedulerTask(this, index));
+}
+
+void NetScheduler::execute( int index )
+{
+	Processor *processor = m_nodes[index]->processor;
+	///
+	/// 在队列中等待期间被取消
+	if (isCanceled())
+	{
+		if (ProcessorProfiler *profiler = ProcessorProfiler::active())
+			profiler->dequeued(processor);
+		finished(index, false);
+		return;
+	}
+	bool bSucessed = true;
+	QByteArray key;
+	if (!m_cache || !m_cache->restore(processor, &key))
+	{
+		bSucessed = processor->execute();
+		if (bSucessed && m_cache)
+			m_cache->store(processor, key);
+	}
+	else if (ProcessorProfiler *profiler = ProcessorProfiler::active())
+		profiler->dequeued(processor);
+	///
+	/// 输出已经更新，所有子处理器都需要重新执行，必须在减少子处理器的计数之前设置
+	const int *end = m_plan->childEnd(index);
+	for (const int *child = m_plan->childBegin(index); child != end; child++)
+		m_nodes[*child]->outdated.store(1);
+	finished(index, bSucessed);
+}
+
+void NetScheduler::finished( int index, bool bSucessed )
+{
+	if (!bSucessed)
+		m_failed.store(1);
+
+	const int *end = m_plan->childEnd(index);
+	for (const int *child = m_plan->childBegin(index); child != end; child++)
+	{
+		if (!m_nodes[*child]->pending.deref())
+			dispatch(*child);
+	}
+
+	if (!m_remaining.deref())
+	{
+		QMutexLocker locker(&m_mutex);
+		m_finished.wakeAll();
+	}
+}
+
+/*!
+ * \brief 放入队列的一帧数据
+ *
+ * 输出端口中的IData由处理器拥有，处理下一帧时会被修改，这里保存一份副本，
+ * 下游处理器读取的始终是放入队列时的数据。
+ */
+NetScheduler::StreamFrame NetScheduler::snapshot( const ProcessData &data )
+{
+	StreamFrame frame;
+	frame.data = data;
+	if (data.variant.userType() == qMetaTypeId<IData*>())
+	{
+		if (IData *idata = data.variant.value<IData*>())
+		{
+			frame.snapshot = QSharedPointer<IData>(idata->clone());
+			frame.data.variant.setValue<IData*>(frame.snapshot.data());
+		}
+	}
+	return frame;
+}
+
+void NetScheduler::buildStream()
+{
+	qDeleteAll(m_streamNodes);
+	qDeleteAll(m_streamEdges);
+	m_streamNodes.clear();
+	m_streamEdges.clear();
+
+	for (int i = 0; i < m_nodes.size(); i++)
+	{
+		StreamNode *node = new StreamNode;
+		node->bRunning	= false;
+		node->bDone		= false;
+		node->frames	= 0;
+		m_streamNodes.push_back(node);
+	}
+	///
+	/// 每一对相连的端口是一条边，与执行计划中的边一一对应
+	m_streamEdges.reserve(m_plan->edgeCount());
+	for (int i = 0; i < m_plan->edgeCount(); i++)
+	{
+		const ExecutionPlan::Edge &planEdge = m_plan->edge(i);
+		StreamEdge *edge = new StreamEdge;
+		edge->src		= planEdge.src;
+		edge->dst		= planEdge.dst;
+		edge->srcPort	= planEdge.srcPort;
+		edge->dstPort	= planEdge.dstPort;
+		m_streamNodes[edge->src]->outEdges.push_back(i);
+		m_streamNodes[edge->dst]->inEdges.push_back(i);
+		m_streamEdges.push_back(edge);
+	}
+}
+
+bool NetScheduler::isConstantEdge( const StreamEdge &edge ) const
+{
+	const StreamNode *src = m_streamNodes[edge.src];
+	return src->bDone && src->frames == 1;
+}
+
+bool NetScheduler::isStreamReady( int index ) const
+{
+	const StreamNode *node = m_streamNodes[index];
+	if (node->bRunning || node->bDone || m_failed.load() != 0 || isCanceled())
+		return false;
+
+	///
+	/// 下游队列已满，等待下游处理器取走数据
+	foreach (int iEdge, node->outEdges)
+	{
+		if (m_streamEdges[iEdge]->queue.size() >= m_iCapacity)
+			return false;
+	}
+
+	///
+	/// 源处理器：上次执行要求继续执行
+	if (node->inEdges.isEmpty())
+		return node->frames == 0 || m_nodes[index]->processor->result().m_bNeedLoop;
+
+	bool bHasFrame = false;
+	foreach (int iEdge, node->inEdges)
+	{
+		const StreamEdge *edge = m_streamEdges[iEdge];
+		if (!edge->queue.isEmpty())
+			bHasFrame = true;
+		else if (!isConstantEdge(*edge))
+			return false;
+	}
+	return bHasFrame;
+}
+
+void NetScheduler::updateStream( int index )
+{
+	StreamNode *node = m_streamNodes[index];
+	if (isStreamReady(index))
+	{
+		node->staged.clear();
+		node->stagedFrames.clear();
+		foreach (int iEdge, node->inEdges)
+		{
+			StreamEdge *edge = m_streamEdges[iEdge];
+			const StreamFrame frame = edge->queue.isEmpty() ? edge->last : edge->queue.dequeue();
+			node->staged[edge->dstPort] << frame.data;
+			node->stagedFrames << frame;
+		}
+		node->bRunning = true;
+		if (ProcessorProfiler *profiler = ProcessorProfiler::active())
+			profiler->queued(m_nodes[index]->processor);
+		ProcessorExecutor::instance()->start(new NetStreamTask(this, index));
+
+		///
+		/// 取走数据后上游处理器可能可以继续执行
+		foreach (int iEdge, node->inEdges)
+			updateStream(m_streamEdges[iEdge]->src);
+		return;
+	}
+	if (node->bRunning || node->bDone)
+		return;
+
+	///
+	/// 判断处理器是否已经不会再执行
+	bool bDone = m_failed.load() != 0 || isCanceled();
+	if (!bDone && node->inEdges.isEmpty())
+		bDone = node->frames > 0 && !m_nodes[index]->processor->result().m_bNeedLoop;
+	else if (!bDone)
+	{
+		bDone = true;
+		foreach (int iEdge, node->inEdges)
+		{
+			const StreamEdge *edge = m_streamEdges[iEdge];
+			if (!m_streamNodes[edge->src]->bDone || !edge->queue.isEmpty())
+			{
+				bDone = false;
+				break;
+			}
+		}
+	}
+	if (!bDone)
+		return;
+
+	node->bDone = true;
+	node->staged.clear();
+	node->stagedFrames.clear();
+	foreach (int iEdge, node->outEdges)
+		updateStream(m_streamEdges[iEdge]->dst);
+
+	if (!m_remaining.deref())
+	{
+		QMutexLocker locker(&m_mutex);
+		m_finished.wakeAll();
+	}
+}
+
+void NetScheduler::executeStream( int index )
+{
+	StreamNode *node = m_streamNodes[index];
+	Processor *processor = m_nodes[index]->processor;
+
+	QHash<Port*, QList<ProcessData> >::const_iterator itr = node->staged.constBegin();
+	for (; itr != node->staged.constEnd(); itr++)
+		itr.key()->setStagedData(itr.value());
+
+	bool bSucessed = processor->execute();
+
+	///
+	/// 在锁外复制数据，同一个输出端口的多条边共享一份副本
+	QList<StreamFrame> outputs;
+	for (int i = 0; i < node->outEdges.size(); i++)
+	{
+		Port *srcPort = m_streamEdges[node->outEdges[i]]->srcPort;
+		if (i > 0 && m_streamEdges[node->outEdges[i - 1]]->srcPort == srcPort)
+			outputs << outputs.last();
+		else
+			outputs << snapshot(*srcPort->data());
+	}
+	for (itr = node->staged.constBegin(); itr != node->staged.constEnd(); itr++)
+		itr.key()->clearStagedData();
+
+	QMutexLocker locker(&m_streamMutex);
+	node->stagedFrames.clear();
+	if (!bSucessed || isCanceled())
+		m_failed.store(1);
+	for (int i = 0; i < node->outEdges.size(); i++)
+	{
+		StreamEdge *edge = m_streamEdges[node->outEdges[i]];
+		edge->queue.enqueue(outputs[i]);
+		edge->last = outputs[i];
+	}
+	node->frames++;
+	node->bRunning = false;
+	if (node->inEdges.isEmpty())
+		m_iFrames.store(qMax(m_iFrames.load(), node->frames));
+
+	updateStream(index);
+	foreach (int iEdge, node->outEdges)
+		updateStream(m_streamEdges[iEdge]->dst);
+	if (m_failed.load() != 0)
+	{
+		for (int i = 0; i < m_streamNodes.size(); i++)
+			updateStream(i);
+	}
+}
+
+}
@@ -0,0 +1,141 @@
+#ifndef NETSCHEDULER_H
+#define NETSCHEDULER_H
+
+#include "../designnet_core_global.h"
+#include "port.h"
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QVector>
+#include <QWaitCondition>
+
+namespace DesignNet{
+
+class ExecutionPlan;
+class Processor;
+class ResultCache;
+class NetSchedulerTask;
+class NetStreamTask;
+
+/*!
+ * \brief DAG调度器
+ *
+ * 由DesignNetSpace在每次执行时使用。图结构来自DesignNetSpace冻结的ExecutionPlan，
+ * 计划没有变化时节点不重新分配，每次执行只按计划中的父处理器个数重置计数。
+ * 每个处理器维护一个原子入度计数，父处理器全部完成后立即把子处理器派发到ProcessorExecutor，
+ * 因此同一层以及不同层中已经就绪的处理器都可以并行执行。
+ *
+ * runStream()以流水线方式执行：入度为0的源处理器根据ProcessResult::m_bNeedLoop反复执行，
+ * 每次执行产生一帧数据，每条端口连接上有一个有界队列，下游处理器在处理第N帧时，
+ * 上游处理器可以同时处理第N+1帧，队列满时上游处理器暂停。
+ * 只产生一帧数据的处理器（例如常量参数）的输出会被之后的每一帧重复使用。
+ * 处理器拥有输出端口中的IData并且在下一帧中原地修改，放入队列时保存一份IData的副本（clone()，共享缓冲区，写时复制），
+ * 其它数据（MatPayload、基本类型）本身是不可变的值，直接复制。
+ *
+ * 增量执行时只执行数据已过期（Processor::isDataDirty()）或者要求继续执行（m_bNeedLoop）的处理器，
+ * 以及它们的全部下游处理器，其它处理器直接使用输出端口上保留的上一次结果。
+ * 设置ResultCache之后，需要执行的处理器先在缓存中查找相同类型、属性和输入的结果。
+ *
+ * cancel()或者超过setDeadline()设置的期限之后，尚未开始的处理器不再执行，
+ * 正在执行的处理器通过Processor::isCanceled()得知并尽快返回，run()和runStream()返回false。
+ */
+class DESIGNNET_CORE_EXPORT NetScheduler
+{
+	friend class NetSchedulerTask;
+	friend class NetStreamTask;
+public:
+	NetScheduler();
+	~NetScheduler();
+
+	bool run(const ExecutionPlan &plan, bool bIncremental = false);		//!< 阻塞执行，执行期间\e plan 不能改变
+	bool runStream(const ExecutionPlan &plan, int queueCapacity = 4);	//!< 流水线执行
+	bool isRunning() const;
+	int framesProcessed() const;	//!< 最近一次流水线执行中源处理器产生的帧数
+	int processorsSkipped() const;	//!< 最近一次增量执行中复用结果的处理器个数
+	void setResultCache(ResultCache *cache);	//!< 为0时不使用缓存
+	ResultCache* resultCache() const;
+
+	void cancel();					//!< 取消正在进行的执行
+	bool isCanceled() const;		//!< 正在执行，并且已被取消或者超过了期限
+	bool wasCanceled() const;		//!< 最近一次执行是否因为取消或者超过期限而停止
+	void setDeadline(int msecs);	//!< 每次run()或runStream()的时间上限，毫秒，0表示不限制
+	int  deadline() const;
+
+protected:
+
+	struct Node
+	{
+		Processor*		processor;
+		QAtomicInt		pending;	//!< 还未完成的父处理器个数
+		QAtomicInt		outdated;	//!< 本次执行中是否需要执行
+	};
+
+	struct StreamFrame
+	{
+		ProcessData				data;
+		QSharedPointer<IData>	snapshot;	//!< data中IData的副本，最后一个使用它的队列或者处理器释放
+	};
+
+	struct StreamEdge
+	{
+		int					src;
+		int					dst;
+		Port*				srcPort;
+		Port*				dstPort;
+		QQueue<StreamFrame>	queue;		//!< 还未被下游处理器使用的帧
+		StreamFrame			last;		//!< 最后一次放入队列的数据
+	};
+
+	struct StreamNode
+	{
+		QVector<int>	inEdges;
+		QVector<int>	outEdges;
+		QHash<Port*, QList<ProcessData> > staged;	//!< 本次执行使用的输入数据
+		QList<StreamFrame>	stagedFrames;			//!< staged中IData副本的所有者，执行完成后释放
+		bool			bRunning;
+		bool			bDone;
+		int				frames;		//!< 已经执行的次数
+	};
+
+	void build(const ExecutionPlan &plan);
+	void dispatch(int index);
+	void execute(int index);
+	void finished(int index, bool bSucessed);
+	void waitForFinished();
+
+	static StreamFrame snapshot(const ProcessData &data);
+	void buildStream();
+	bool isConstantEdge(const StreamEdge &edge) const;
+	bool isStreamReady(int index) const;
+	void updateStream(int index);
+	void executeStream(int index);
+
+	QVector<Node*>	m_nodes;		//!< 与m_plan中的处理器一一对应
+	const ExecutionPlan*	m_plan;
+	int				m_iRevision;	//!< 建立m_nodes时m_plan的版本
+	QAtomicInt		m_remaining;	//!< 还未完成的处理器个数
+	QAtomicInt		m_failed;		//!< 是否有处理器执行失败
+	QAtomicInt		m_running;
+	QAtomicInt		m_skipped;		//!< 复用结果的处理器个数
+	QAtomicInt		m_canceled;
+	QElapsedTimer	m_timer;		//!< 本次执行的开始时间
+	int				m_iDeadline;
+	bool			m_bCanceled;	//!< 最近一次执行的结果
+	QMutex			m_mutex;
+	QWaitCondition	m_finished;
+
+	QVector<StreamNode*>	m_streamNodes;
+	QVector<StreamEdge*>	m_streamEdges;
+	QMutex					m_streamMutex;	//!< 保护流水线的队列和状态
+	int						m_iCapacity;
+	QAtomicInt				m_iFrames;		//!< 在m_streamMutex中修改，framesProcessed()不加锁读取
+	ResultCache*			m_cache;
+};
+
+}
+
+#endif // NETSCHEDULER_H
@@ -1,7 +1,7 @@
 #include "port.h"
 #include <QWriteLocker>
-#include "../../../coreplugin/icore.h"
-#include "../../../coreplugin/messagemanager.h"
+#include <QtAlgorithms>
+#include <algorithm>
 #include "../designnetconstants.h"
 #include "utils/totemassert.h"
 #include "processor.h"
@@ -15,8 +15,12 @@ Port::Port(PortType portType, DataType dt, const QString &name, bool bRemovable,
 	m_bRemovable(bRemovable),
     m_portType(portType),
     m_processor(0),
+	m_bStaged(false),
 	m_name(name),
-	m_data(dt)
+	m_data(dt),
+	m_iTypeId(0),
+	m_pValue(0),
+	m_bBoxed(false)
 {
 }
 /*!
@@ -35,6 +39,7 @@ bool Port::connect(Port *port)
         return false;
 	bool bConnected = m_processor->isConnectTo(port->processor());
     m_portsConnected.push_back(port);
+	m_processor->unfreezePorts();
     port->addConnectedPort(this);/// ֱӽԼŵinputPortб
 	if (!bConnected)
 	{
@@ -59,6 +64,7 @@ bool Port::disconnect(Port *inputport)
 		   emit disconnectPort(this, p);
         }
         m_portsConnected.clear();
+		m_processor->unfreezePorts();
     }
     else
     {
@@ -104,6 +110,17 @@ bool Port::canConnectTo(Port *inputPort)
     {
         return false;
     }
+	///
+	/// ˶ʱͱٱȽDataType
+	if (m_iTypeId != 0 && inputPort->typeId() != 0)
+		return inputPort->acceptsType(m_iTypeId);
+	///
+	/// ֻһʱDATATYPE_USERTYPE˵ͬһ
+	if ((m_iTypeId != 0 || inputPort->typeId() != 0)
+		&& (data()->dataType == DATATYPE_USERTYPE || inputPort->data()->dataType == DATATYPE_USERTYPE))
+	{
+		return false;
+	}
 	return inputPort->processor()->connectionTest(this, inputPort);
 }
 
@@ -142,12 +159,17 @@ bool Port::isMultiInputSupported() const
 QList<Processor *> Port::connectedProcessors() const
 {
     QList<Processor *> result;
+	result.reserve(m_portsConnected.size());
 	QList<Port*>::const_iterator itr = m_portsConnected.begin();
     for(; itr != m_portsConnected.end(); itr++)
-    {
-        if(!result.contains((*itr)->processor()))
-            result.append((*itr)->processor());
-    }
+        result.append((*itr)->processor());
+	///
+	/// ȥأӺܶʱ
+	if (result.size() > 1)
+	{
+		qSort(result);
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
     return result;
 }
 
@@ -166,6 +188,8 @@ void Port::addConnectedPort(Port *port)
     if(m_portsConnected.contains(port))
         return;
     m_portsConnected.push_back(port);
+	if (m_processor)
+		m_processor->unfreezePorts();
 	if (m_portType == OUT_PORT)
 		emit connectPort(this, port);
 	else
@@ -175,6 +199,8 @@ void Port::addConnectedPort(Port *port)
 void Port::removeConnectedPort(Port *port)
 {
     m_portsConnected.removeOne(port);
+	if (m_processor)
+		m_processor->unfreezePorts();
 	if (m_portType == OUT_PORT)
 		emit disconnectPort(this, port);
 	else
@@ -196,22 +222,107 @@ void Port::addData(ProcessData* data)
 	Q_ASSERT(m_portType == OUT_PORT);
 	QWriteLocker locker(&m_dataLocker);
 	m_data = *data;
+	m_dataHash.clear();
+	if (m_pValue)
+	{
+		///
+		/// תʱһε
+		if (!m_pValue->fromVariant(m_data.variant))
+			m_pValue->clear();
+		m_bBoxed = true;
+	}
 	emit dataChanged();
 }
 
+/*!
+ * \brief ˿дŵ
+ *
+ * ̬͵˿ŰװΪQVariantͬһֻװһΡ
+ */
 ProcessData *Port::data()
 {
+	if (m_pValue)
+	{
+		QWriteLocker locker(&m_dataLocker);
+		if (!m_bBoxed)
+		{
+			m_data.variant = m_pValue->toVariant();
+			m_bBoxed = true;
+		}
+	}
 	return &m_data;
 }
 
 ProcessData* Port::getInputData()
 {
+	if (m_bStaged)
+		return m_stagedData.isEmpty() ? 0 : &m_stagedData[0];
 	QList<Port*> portsConnected = connectedPorts();
 	for (int i = 0; i < portsConnected.size(); i++)
 		return portsConnected[i]->data();
 	return 0;
 }
 
+void Port::setStagedData( const QList<ProcessData> &datas )
+{
+	m_stagedData	= datas;
+	m_bStaged		= true;
+}
+
+void Port::clearStagedData()
+{
+	m_stagedData.clear();
+	m_bStaged = false;
+}
+
+QList<ProcessData*> Port::stagedData()
+{
+	QList<ProcessData*> res;
+	for (int i = 0; i < m_stagedData.size(); i++)
+		res << &m_stagedData[i];
+	return res;
+}
+
+void Port::setDataHash( const QByteArray &hash )
+{
+	QWriteLocker locker(&m_dataLocker);
+	m_dataHash = hash;
+}
+
+QByteArray Port::dataHash()
+{
+	QReadLocker locker(&m_dataLocker);
+	return m_dataHash;
+}
+
+void Port::setTypeInfo( int typeId, const QVector<int> &acceptedTypes )
+{
+	m_iTypeId		= typeId;
+	m_acceptedTypes	= acceptedTypes;
+}
+
+bool Port::acceptsType( int typeId ) const
+{
+	return typeId == m_iTypeId || m_acceptedTypes.contains(typeId);
+}
+
+void Port::setTypedValue( PortValue *value )
+{
+	Q_ASSERT(m_portType == OUT_PORT);
+	delete m_pValue;
+	m_pValue	= value;
+	m_iTypeId	= value ? value->typeId() : 0;
+	m_bBoxed	= false;
+}
+
+void Port::commitValue()
+{
+	QWriteLocker locker(&m_dataLocker);
+	m_bBoxed = false;
+	m_dataHash.clear();
+	emit dataChanged();
+}
+
 void Port::setMultiInputSupported( const bool &bSupported /*= true*/ )
 {
 	m_bMultiInput = bSupported;
@@ -7,6 +7,7 @@
 #include <QObject>
 #include <QReadWriteLock>
 #include <QVariant>
+#include <QVector>
 
 
 namespace DesignNet{
@@ -23,6 +24,25 @@ public:
 	int			m_iIndex;		//!< 
 };
 
+/*!
+ * \brief ̬Ͷ˿е
+ *
+ * OutputPort<T>ڴ˿ʱһΣֱ֮д룬QVariant
+ * ֻδ͵Ķ˿ڡResultCacheˮִжȡPort::data()ʱװΪQVariant
+ */
+class DESIGNNET_CORE_EXPORT PortValue
+{
+public:
+	explicit PortValue(int typeId) : m_iTypeId(typeId) {}
+	virtual ~PortValue() {}
+	int typeId() const { return m_iTypeId; }		//!< QMetaType
+	virtual QVariant toVariant() const = 0;
+	virtual bool fromVariant(const QVariant &variant) = 0;
+	virtual void clear() = 0;						//!< ָΪĬֵ
+protected:
+	int m_iTypeId;
+};
+
 /**
  * @brief The Port class
  *
@@ -41,7 +61,7 @@ public:
 
     explicit Port(PortType portType, DataType dt,
 			const QString &label = "", bool bRemovable = false, QObject *parent = 0);
-	virtual ~Port() { }
+	virtual ~Port() { delete m_pValue; }
     PortType portType() const{ return m_portType; }
     void setPortType(const PortType &portType){ m_portType = portType; }
 
@@ -97,6 +117,25 @@ public:
     ProcessData* data();        //!< ˿дŵ
 	ProcessData* getInputData();
 
+	void setStagedData(const QList<ProcessData> &datas);	//!< ˮִʱ˿ڱʹõ
+	void clearStagedData();
+	bool hasStagedData() const { return m_bStaged; }
+	QList<ProcessData*> stagedData();
+	int stagedCount() const { return m_stagedData.size(); }
+	ProcessData* stagedData(int i) { return i < m_stagedData.size() ? &m_stagedData[i] : 0; }
+
+	void setDataHash(const QByteArray &hash);	//!< ݵݹϣaddData()֮ʧЧ
+	QByteArray dataHash();
+
+	///
+	/// ̬Ͷ˿ڣInputPort<T>OutputPort<T>
+	int typeId() const { return m_iTypeId; }		//!< QMetaTypeͣ0ʾδ
+	void setTypeInfo(int typeId, const QVector<int> &acceptedTypes);	//!< ˿ڿ\e acceptedTypes ͵˿
+	bool acceptsType(int typeId) const;
+	void setTypedValue(PortValue *value);		//!< ˿ڵݣ˿ȡȨ
+	PortValue* typedValue() const { return m_pValue; }
+	void commitValue();							//!< typedValue()Ѿдµ
+
 signals:
 
 	void connectPort(Port* src, Port* target);
@@ -114,6 +153,13 @@ protected:
     Processor*		m_processor;    //!< ö˿Ĵ
     QList<Port*>	m_portsConnected;//!< ǰ˿ӵPort
 	QReadWriteLock	m_dataLocker;
+	QList<ProcessData>	m_stagedData;	//!< ˮִʱ˿ڵ
+	bool			m_bStaged;
+	QByteArray		m_dataHash;		//!< ݵݹϣResultCache
+	int				m_iTypeId;
+	QVector<int>	m_acceptedTypes;
+	PortValue*		m_pValue;
+	bool			m_bBoxed;		//!< m_data.variantǷm_pValueһ
 };
 
 
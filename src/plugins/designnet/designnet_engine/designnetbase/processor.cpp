@@ -0,0 +1,1024 @@
+#include "processor.h"
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QtAlgorithms>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+#include "../data/idata.h"
+#include "Utils/runextensions.h"
+#include "utils/totemassert.h"
+#include "Utils/XML/xmldeserializer.h"
+#include "Utils/XML/xmlserializer.h"
+#include "designnetspace.h"
+#include "processorexecutor.h"
+#include "processorprofiler.h"
+
+
+namespace DesignNet{
+
+/*!
+ * \brief һprocessTiled()ȫֿ
+ *
+ * ߳ͨ\e next ȡֿ飬ֻȡķֿбʣ
+ * ȡֿĸֱ˳processTiled()֮ڶеĸǰȫġ
+ */
+struct Processor::TileJob
+{
+	TileJob() : processor(0), halo(0) {}
+	void run();
+
+	Processor*			processor;
+	cv::Mat				input;
+	cv::Mat				output;
+	QVector<cv::Rect>	tiles;		//!< ͼеķֿ飬halo
+	int					halo;
+	QAtomicInt			next;		//!< һȡķֿ
+	QAtomicInt			finished;	//!< Ѿķֿ
+	QAtomicInt			failed;
+};
+
+void Processor::TileJob::run()
+{
+	const cv::Rect bounds(0, 0, input.cols, input.rows);
+	int index;
+	while ((index = next.fetchAndAddOrdered(1)) < tiles.size())
+	{
+		if (failed.load() == 0 && processor->isCanceled())
+			failed.store(1);
+		if (failed.load() == 0)
+		{
+			const cv::Rect &tile = tiles.at(index);
+			const cv::Rect outer = cv::Rect(tile.x - halo, tile.y - halo,
+				tile.width + 2 * halo, tile.height + 2 * halo) & bounds;
+			cv::Mat target = output(tile);
+			cv::Mat result = target;
+			bool bOk = processor->processTile(input(outer), tile - outer.tl(), result);
+			///
+			/// processTile()·ʱƻͼ
+			if (bOk && result.data != target.data)
+			{
+				if (result.size() == target.size() && result.type() == target.type())
+					result.copyTo(target);
+				else
+					bOk = false;
+			}
+			if (!bOk)
+				failed.store(1);
+		}
+		finished.fetchAndAddOrdered(1);
+	}
+}
+
+class Processor::TileRunner : public QRunnable
+{
+public:
+	TileRunner(const QSharedPointer<TileJob> &job) : m_job(job) { setAutoDelete(true); }
+	void run() { m_job->run(); }
+private:
+	QSharedPointer<TileJob> m_job;
+};
+
+namespace {
+
+///
+/// зֳĺڴģֻҪhalo
+/// Ϊ߳ƽ⸺أÿһ鲻̫СҲܱhalo̫
+QVector<cv::Rect> splitTiles(const cv::Size &size, int halo, int threads)
+{
+	enum { MinimumRows = 16, MinimumPixels = 64 * 1024, TilesPerThread = 4 };
+	QVector<cv::Rect> tiles;
+	if (size.width <= 0 || size.height <= 0)
+		return tiles;
+	int rows = (size.height + threads * TilesPerThread - 1) / (threads * TilesPerThread);
+	rows = qMax(rows, qMax<int>(MinimumRows, 2 * halo));
+	rows = qMax(rows, (MinimumPixels + size.width - 1) / size.width);
+	for (int y = 0; y < size.height; y += rows)
+		tiles << cv::Rect(0, y, size.width, qMin(rows, size.height - y));
+	return tiles;
+}
+
+///
+/// ȥأtoSet().toList()
+QList<Processor*> uniqueProcessors(QList<Processor*> processors)
+{
+	if (processors.size() > 1)
+	{
+		qSort(processors);
+		processors.erase(std::unique(processors.begin(), processors.end()), processors.end());
+	}
+	return processors;
+}
+
+}
+
+
+ProcessorWorker::ProcessorWorker( Processor *processor )
+	: m_processor(processor)
+{
+	m_bWorking = false;
+	setAutoDelete(false);
+}
+
+QFuture<ProcessResult> ProcessorWorker::prepare()
+{
+	futureInterface = QFutureInterface<ProcessResult>();
+	futureInterface.reportStarted();
+	return futureInterface.future();
+}
+
+void ProcessorWorker::run()
+{
+	m_processor->run(futureInterface);
+	futureInterface.reportFinished();
+}
+
+bool ProcessorWorker::isWorking()
+{
+	QMutexLocker locker(&m_mutex);
+	return m_bWorking;
+}
+
+void ProcessorWorker::stopped()
+{
+	QMutexLocker locker(&m_mutex);
+	m_bWorking = false;
+	emit m_processor->processFinished();
+}
+
+void ProcessorWorker::started()
+{
+	QMutexLocker locker(&m_mutex);
+	m_bWorking = true;
+	emit m_processor->processStarted();
+}
+
+Processor::Processor(DesignNetSpace *space, QObject* parent, ProcessorType processorType)
+	: QObject(parent),
+	m_space(space),
+	m_worker(this),
+	m_eType(processorType), m_bResizableInput(false)
+{
+	m_bDataDirty = true;
+	m_iRunGeneration = 0;
+    m_name = "";
+	m_id = -1;
+	m_iExecutionTime = 0;
+	m_iExecutionCount = 0;
+	m_bFrozen = false;
+	m_iConsumers = 0;
+	///
+	/// ͵ĴProcessorExecutorִ
+	QObject::connect(&m_watcher, SIGNAL(finished()), &m_worker, SLOT(stopped()));
+	QObject::connect(&m_watcher, SIGNAL(started()), &m_worker, SLOT(started()));
+}
+
+Processor::~Processor()
+{
+	///
+	/// ִеprocess()ͨisCanceled()췵
+	Processor::cancel();
+	waitForFinish();
+	ProcessorProfiler::forget(this);
+}
+
+void Processor::setName(const QString &name)
+{
+    m_name = name;
+}
+
+QString Processor::name() const
+{
+    return m_name;
+}
+
+void Processor::setID(const int &id)
+{
+    m_id = id;
+}
+
+int Processor::id() const
+{
+    return m_id;
+}
+
+void Processor::pushData(ProcessData &pd, QString strLabel)
+{
+	QList<Port*>::Iterator itr = m_outputPort.begin();
+	for (; itr < m_outputPort.end(); itr++)
+	{
+		if ((*itr)->data()->dataType == pd.dataType && (*itr)->name() == strLabel)
+		{
+			(*itr)->addData(&pd);
+			break;
+		}
+	}
+}
+
+void Processor::pushData(QVariant &var, DataType dataType, QString strLabel /*= ""*/, int iProcessId /*= -1*/)
+{
+	ProcessData pd(dataType);
+	pd.variant	= var;
+	pd.processorID = iProcessId == -1 ? m_id : iProcessId;
+	pushData(pd, strLabel);
+}
+
+void Processor::pushData(IData* data, QString strLabel /*= ""*/, int iProcessId /*= -1*/)
+{
+	Port* pPort = getPort(Port::OUT_PORT, strLabel);
+	ProcessData pd(DATATYPE_USERTYPE);
+	pd.variant.setValue<IData*>(data);
+	if (pPort)
+		pPort->addData(&pd);
+}
+
+void Processor::pushData(const cv::Mat &mat, DataType dataType, QString strLabel /*= ""*/, int iProcessId /*= -1*/)
+{
+	///
+	/// ֮ԭ޸\e mat ƵMatBufferPoolĻβῴ֮޸
+	MatPayload payload;
+	payload.assign(mat);
+	ProcessData pd(dataType);
+	pd.variant.setValue(payload);
+	pd.processorID = iProcessId == -1 ? m_id : iProcessId;
+	pushData(pd, strLabel);
+}
+
+MatPayload Processor::getPortPayload(PortData ptData)
+{
+	return getPortData<MatPayload>(ptData);
+}
+
+QList<ProcessData> Processor::getOutputData(DataType dt)
+{
+	QList<ProcessData> res;
+	res.reserve(m_outputPort.size());
+	QList<Port*>::Iterator itr = m_outputPort.begin();
+	for (; itr < m_outputPort.end(); itr++)
+		if ((*itr)->data()->dataType == dt || dt == DATATYPE_INVALID)
+			res << *((*itr)->data());
+
+	return res;
+}
+
+QList<ProcessData> Processor::getInputData(DataType dt)
+{
+	QList<ProcessData> res;
+	///
+	/// ˮִʱʹ˿ϵ
+	foreach (Port* port, m_inputPort)
+	{
+		if (!port->hasStagedData())
+			continue;
+		foreach (ProcessData* pd, port->stagedData())
+		{
+			if (dt == pd->dataType || dt == DATATYPE_INVALID)
+				res << *pd;
+		}
+	}
+	if (!res.isEmpty())
+		return res;
+	QList<Processor*> fathers = getInputProcessor();
+	foreach (Processor* father, fathers)
+	{
+		const QList<ProcessData> datas = father->getOutputData(dt);
+		for(QList<ProcessData>::const_iterator itr = datas.begin(); itr != datas.end(); itr++)
+		{
+			if (dt ==  (*itr).dataType || dt == DATATYPE_INVALID)
+				res << *itr;
+		}
+	}
+	return res;
+}
+
+int Processor::indegree(QList<Processor *> exclusions) const
+{
+    int degree = 0;
+	const QList<Processor*> processors = getInputProcessor();
+
+	foreach(Processor *processor, processors)
+	{
+		if(!exclusions.contains(processor))
+			degree++;
+	}
+    return degree;
+}
+
+bool Processor::beforeProcess(QFutureInterface<ProcessResult> &future)
+{
+	ProcessResult *pr = new ProcessResult;
+	pr->m_bNeedLoop = false;
+	pr->m_bSucessed = true;
+	future.reportResult(*pr, 0);
+	return true;
+}
+
+void Processor::afterProcess(bool status)
+{
+	clearDataDirty();
+	emit logout(tr("%1 id: %2 processing finished.").arg(name()).arg(id()));
+}
+
+void Processor::run(QFutureInterface<ProcessResult> &future)
+{
+	ProcessorProfiler *profiler = ProcessorProfiler::active();
+	ProcessorProfiler::Record record;
+	if (profiler)
+		profiler->begin(this, record);
+	beginRun();
+	m_future.store(&future);
+	m_processTimer.start();
+ 	ProcessResult *pr = new ProcessResult;
+ 	future.reportResult(pr, 0);
+	///
+	/// Ѿȡʱٿʼprocess()isCanceled()
+	bool bPrepared = !isCanceled() && beforeProcess(future);
+	if (profiler)
+		record.beforeProcessEnd = profiler->now();
+	if(!bPrepared || isCanceled() || !process(future))
+	{
+		if (profiler)
+		{
+			record.processEnd = profiler->now();
+			profiler->end(this, record, false);
+		}
+		(*pr).m_bSucessed = false;
+		(*pr).m_bCanceled = isCanceled();
+		if ((*pr).m_bCanceled)
+			emit logout(tr("%1 id: %2 was canceled.").arg(name()).arg(id()));
+		m_future.store(0);
+		m_processTimer.invalidate();
+		future.reportResult(pr, 0);
+		m_result = *pr;
+		{
+			///
+			/// ˿ϵݲһαִ
+			QWriteLocker lock(&m_workingLock);
+			m_bDataDirty = true;
+		}
+		emit childProcessFinished();
+		return;
+	}
+	m_future.store(0);
+	m_processTimer.invalidate();
+	if (profiler)
+		record.processEnd = profiler->now();
+	*pr = future.future().resultAt(0);
+	m_result = *pr;
+	afterProcess(future.future().resultAt(0).m_bSucessed);
+	if (profiler)
+		profiler->end(this, record, m_result.m_bSucessed);
+	if (consumerCount() == 0)
+		emit childProcessFinished();
+}
+
+void Processor::start()
+{
+	m_canceled.store(0);
+	m_worker.started();
+	if (ProcessorProfiler *profiler = ProcessorProfiler::active())
+		profiler->queued(this);
+	m_watcher.setFuture(m_worker.prepare());
+	ProcessorExecutor::instance()->start(&m_worker);
+}
+
+bool Processor::execute()
+{
+	QElapsedTimer timer;
+	timer.start();
+	m_canceled.store(0);
+	m_worker.started();
+	QFutureInterface<ProcessResult> futureInterface;
+	futureInterface.reportStarted();
+	run(futureInterface);
+	futureInterface.reportFinished();
+	m_worker.stopped();
+	m_iExecutionTime += timer.nsecsElapsed() / 1000;
+	++m_iExecutionCount;
+	return m_result.m_bSucessed;
+}
+
+bool Processor::isCacheable() const
+{
+	return false;
+}
+
+void Processor::cancel()
+{
+	m_canceled.store(1);
+	m_watcher.cancel();
+}
+
+/*!
+ * \brief ǷӦֹͣ
+ *
+ * һtruecancel()start()QFutureȡ
+ * δDesignNetSpaceprocessTimeout()ڵDesignNetSpaceȡ򳬹runDeadline()
+ * ֻȡԭӱʱӣڴÿһлÿһֿʱá
+ */
+bool Processor::isCanceled() const
+{
+	if (m_canceled.load() != 0)
+		return true;
+	QFutureInterface<ProcessResult> *future = m_future.load();
+	if (future && future->isCanceled())
+		return true;
+	if (!m_space)
+		return false;
+	const int processTimeout = m_space->processTimeout();
+	if (processTimeout > 0 && m_processTimer.isValid() && m_processTimer.elapsed() > processTimeout)
+		return true;
+	return m_space->isCanceled();
+}
+
+int Processor::tileHalo() const
+{
+	return -1;
+}
+
+/*!
+ * \brief ԭֻԴ
+ *
+ * Ѿͨл\e prototype ƣֻҪ֮⡢򿪻ִʱԴ
+ * ģͻģͼ񣬱ÿһݡĬϲκԴ
+ * Դڶͬʱʹãֻܶȡ
+ */
+void Processor::shareResources(const Processor *prototype)
+{
+	Q_UNUSED(prototype);
+}
+
+bool Processor::processTile(const cv::Mat &input, const cv::Rect &roi, cv::Mat &output)
+{
+	Q_UNUSED(input);
+	Q_UNUSED(roi);
+	Q_UNUSED(output);
+	return false;
+}
+
+/*!
+ * \brief ֿ鲢д
+ *
+ * tileHalo()С0ʱ\e input ֿ飬ֿProcessorExecutorϲдֱд\e output ĶӦ
+ * Ҫƴӡǰ߳Ҳֿ飬ڹ߳еȴʱִ
+ * tileHalo()С0ͼ̫Сʱڵǰ߳аͼΪһֿ鴦
+ *
+ * ִ治ԶãֻдԼ֪ĸ˿ڵͼҪֿԼĸʽ
+ * ҪֿĴprocess()зͼá
+ */
+bool Processor::processTiled(const cv::Mat &input, cv::Mat &output)
+{
+	if (input.empty() || output.rows != input.rows || output.cols != input.cols)
+		return false;
+	ProcessorExecutor *executor = ProcessorExecutor::instance();
+	const int halo = tileHalo();
+
+	QSharedPointer<TileJob> job(new TileJob);
+	job->processor	= this;
+	job->input		= input;
+	job->output		= output;
+	if (halo < 0)
+	{
+		job->tiles << cv::Rect(0, 0, input.cols, input.rows);
+	}
+	else
+	{
+		job->halo	= halo;
+		job->tiles	= splitTiles(input.size(), halo, qMax(1, executor->threadCount()));
+	}
+
+	const int helpers = qMin(job->tiles.size(), executor->threadCount()) - 1;
+	for (int i = 0; i < helpers; ++i)
+		executor->start(new TileRunner(job));
+	job->run();
+	forever
+	{
+		const int completed = executor->completedTasks();
+		if (job->finished.load() >= job->tiles.size())
+			break;
+		if (!executor->tryRunOne())
+			executor->waitForTask(completed);
+	}
+	return job->failed.load() == 0;
+}
+
+void Processor::cacheRestored()
+{
+	clearDataDirty();
+	m_result = ProcessResult();
+	emit logout(tr("%1 id: %2 reused the cached result.").arg(name()).arg(id()));
+}
+
+void Processor::waitForFinish()
+{
+	if (m_watcher.isFinished())
+		return;
+	ProcessorExecutor::instance()->waitForFinished(m_watcher.future());
+}
+
+bool Processor::connectionTest(Port* pOutput, Port* pInput)
+{
+	if (pOutput->data()->dataType == pInput->data()->dataType)
+		return true;
+	if (pInput->data()->dataType == DATATYPE_MATRIX
+		&& (pOutput->data()->dataType >= DATATYPE_MATRIX || pOutput->data()->dataType <= END_DATATYPE_MATRIX))
+	{
+		return true;
+	}
+	return false;
+}
+
+bool Processor::connectionTest(Processor* father)
+{
+	QList<Port*> portsNeed		= getPorts(Port::IN_PORT);
+	QList<Port*> fatherProvided	= father->getPorts(Port::OUT_PORT);
+	foreach (Port* p, portsNeed)
+	{
+		foreach(Port* provide, fatherProvided)
+		{
+			if (p->data()->dataType == provide->data()->dataType)
+				return true;//!< пṩ
+		}
+	}
+	return false;//!< ṩͷ
+}
+
+void Processor::serialize( Utils::XmlSerializer& s ) const
+{
+	s.serialize("Name", name());
+	s.serialize("ID", id());
+	PropertyOwner::serialize(s);
+}
+
+void Processor::deserialize( Utils::XmlDeserializer& s )
+{
+	s.deserialize("Name", m_name);
+	s.deserialize("ID", m_id);
+	PropertyOwner::deserialize(s);
+}
+
+QString Processor::serializableType() const
+{
+	return typeID().toString();
+}
+
+Utils::XmlSerializable* Processor::createSerializable() const
+{
+	return (Utils::XmlSerializable*)create();
+}
+
+void Processor::setSpace( DesignNetSpace *space ) 
+{
+	if (m_space)
+	{
+		m_space->detachProcessor(this);
+	}
+	m_space = space;
+}
+
+QIcon Processor::icon() const
+{
+	if (m_icon.isNull())
+		return QIcon(":/media/default_processor.png");
+	return m_icon;
+}
+
+Core::Id Processor::typeID() const
+{
+	return Core::Id(QString(category() + "/" + name()));
+}
+
+Core::Id Processor::cachedTypeID(QBasicAtomicInt &cache) const
+{
+	int id = cache.loadAcquire();
+	if (!id)
+	{
+		id = Processor::typeID().uniqueIdentifier();
+		cache.storeRelease(id);
+	}
+	Q_ASSERT_X(id == Processor::typeID().uniqueIdentifier(), "Processor::typeID()",
+		"processors of the same type must use the same name");
+	return Core::Id::fromUniqueIdentifier(id);
+}
+
+QString Processor::category() const
+{
+	return tr("Default");
+}
+
+void Processor::setIcon( const QString &str )
+{
+	m_icon = QIcon(str);
+}
+
+bool Processor::isRunning()
+{
+	return m_worker.isWorking();
+}
+
+void Processor::propertyAdded( Property* prop )
+{
+	QObject::connect(prop, SIGNAL(changed()), this, SLOT(onPropertyChanged_internal()));
+}
+
+void Processor::propertyChanged( Property *prop )
+{
+	invalidate();
+	emit processorModified();
+}
+
+void Processor::onPropertyChanged_internal()
+{
+	Property *prop = qobject_cast<Property*>(sender());
+	if(prop)
+		propertyChanged(prop);
+}
+
+bool Processor::connectTo(Processor* child)
+{
+	if (!child->connectionTest(this))
+		return false;
+
+	QList<Port*> ports = child->getPorts(Port::IN_PORT);
+	QList<Port*>::iterator itr = m_outputPort.begin();
+	while (itr != m_outputPort.end())
+	{
+		QList<Port*>::iterator itrInput = ports.begin();
+		while (itrInput != ports.end())
+		{
+			if ((*itr)->data()->dataType == (*itrInput)->data()->dataType)
+			{
+				(*itr)->connect(*itrInput);
+				break;
+			}
+			itrInput++;
+		}
+		itr++;
+	}
+	return true;
+}
+
+bool Processor::disconnect(Processor* pChild)
+{
+	foreach (Port* portOut, m_outputPort)
+	{
+		QList<Port*> ports = portOut->connectedPorts();
+		foreach (Port* p, ports)
+		{
+			if (p->processor() == pChild)
+				portOut->disconnect(p);
+		}
+	}
+	
+	return true;
+}
+
+bool Processor::isConnectTo(Processor* pChild)
+{
+	QList<Port*>::iterator itr = m_outputPort.begin();
+	while (itr != m_outputPort.end())
+	{
+		if ((*itr)->connectedProcessors().contains(pChild))
+			return true;
+		itr++;
+	}
+	return false;
+}
+
+void Processor::detach()
+{
+	QList<Processor*> inputProcessors = getInputProcessor();
+	QList<Processor*> outputProcessors = getOutputProcessor();
+
+	foreach(Processor* p, inputProcessors)
+		p->disconnect(this);
+
+	foreach(Processor* p, outputProcessors)
+		disconnect(p);
+}
+
+bool Processor::addPort(Port::PortType pt, DataType dt, QString sLabel, bool bRemovable)
+{
+	Port *pPort = new Port(pt, dt, sLabel, bRemovable, this);
+	pPort->setProcessor(this);
+	QObject::connect(pPort, SIGNAL(connectPort(Port*, Port*)), this, SLOT(onPortConnected(Port*, Port*)));
+	if (pt == Port::IN_PORT)
+		m_inputPort.push_back(pPort);
+	else if (pt == Port::OUT_PORT)
+		m_outputPort.push_back(pPort);
+	unfreezePorts();
+	
+	emit portAdded(pPort);
+	return true;
+}
+
+void Processor::removePort(Port *pPort)
+{
+	pPort->disconnect();
+	m_inputPort.removeAll(pPort);
+	m_outputPort.removeAll(pPort);
+	unfreezePorts();
+	emit portRemoved(pPort);
+	pPort->deleteLater();
+}
+
+Port* Processor::getPort(Port::PortType pt, DataType dt)
+{
+	QList<Port*> &ports = pt == Port::IN_PORT ? m_inputPort : m_outputPort;
+	foreach (Port* p, ports)
+	{
+		if (p->data()->dataType == dt)
+			return p;
+	}
+	return NULL;
+}
+
+Port* Processor::getPort(Port::PortType pt, QString sLabel)
+{
+	QList<Port*> &ports = pt == Port::IN_PORT ? m_inputPort : m_outputPort;
+	foreach (Port* p, ports)
+	{
+		if (p->name() == sLabel)
+			return p;
+	}
+	return NULL;
+}
+Port* Processor::getPort(const int iIndex)
+{
+	QList<Port*> ports;
+	ports << m_inputPort << m_outputPort;
+	if (iIndex >= ports.size())
+		return 0;
+	return ports[iIndex];
+}
+
+QList<DesignNet::ProcessData*> Processor::getData(QString sLabel)
+{
+	return getData(inputSlot(sLabel));
+}
+
+ProcessData Processor::getOneData(QString sLabel)
+{
+	return getOneData(inputSlot(sLabel));
+}
+
+int Processor::inputSlot(const QString &sLabel) const
+{
+	for (int i = 0; i < m_inputPort.size(); i++)
+	{
+		if (m_inputPort.at(i)->name() == sLabel)
+			return i;
+	}
+	return -1;
+}
+
+int Processor::inputDataCount(int slot)
+{
+	if (slot < 0 || slot >= m_inputPort.size())
+		return 0;
+	Port *pPort = m_inputPort.at(slot);
+	if (pPort->hasStagedData())
+		return pPort->stagedCount();
+	if (m_bFrozen)
+		return m_slotOffsets.at(slot + 1) - m_slotOffsets.at(slot);
+	return pPort->connectedCount();
+}
+
+ProcessData* Processor::inputData(int slot, int i)
+{
+	if (slot < 0 || slot >= m_inputPort.size() || i < 0)
+		return 0;
+	Port *pPort = m_inputPort.at(slot);
+	if (pPort->hasStagedData())
+		return pPort->stagedData(i);
+	Port *src = inputSource(slot, i);
+	return src ? src->data() : 0;
+}
+
+Port* Processor::inputSource(int slot, int i)
+{
+	if (slot < 0 || slot >= m_inputPort.size() || i < 0)
+		return 0;
+	if (m_bFrozen)
+	{
+		const int k = m_slotOffsets.at(slot) + i;
+		return k < m_slotOffsets.at(slot + 1) ? m_slotSources.at(k) : 0;
+	}
+	const QList<Port*> portsConnected = m_inputPort.at(slot)->connectedPorts();
+	return i < portsConnected.size() ? portsConnected.at(i) : 0;
+}
+
+QList<DesignNet::ProcessData*> Processor::getData(int slot)
+{
+	QList<DesignNet::ProcessData*> res;
+	const int count = inputDataCount(slot);
+	res.reserve(count);
+	for (int i = 0; i < count; i++)
+		res << inputData(slot, i);
+	return res;
+}
+
+ProcessData Processor::getOneData(int slot)
+{
+	///
+	/// ProcessDataеǹģظḴͼ񻺳
+	const ProcessData *pd = inputData(slot);
+	return pd ? *pd : ProcessData();
+}
+
+QList<Port*> Processor::getPorts(Port::PortType pt) const
+{
+	return pt == Port::IN_PORT ? m_inputPort : m_outputPort;
+}
+
+QList<Processor*> Processor::getInputProcessor() const
+{
+	QList<Port*> ports = getPorts(Port::IN_PORT);
+	QList<Processor*> res;
+	foreach(Port* p, ports)
+		res << p->connectedProcessors();
+	return uniqueProcessors(res);
+}
+
+QList<Processor*> Processor::getOutputProcessor() const
+{
+	QList<Port*> ports = getPorts(Port::OUT_PORT);
+	QList<Processor*> res;
+	foreach(Port* p, ports)
+		res << p->connectedProcessors();
+	return uniqueProcessors(res);
+}
+
+int Processor::consumerCount() const
+{
+	if (m_bFrozen)
+		return m_iConsumers;
+	return getOutputProcessor().size();
+}
+
+/*!
+ * \brief 
+ *
+ * ÿ˿ӵ˿ڰУ¼߸
+ * ӻ˿б仯ʱunfreezePorts()˶˿ָڶڼһֱЧ
+ */
+void Processor::freezePorts()
+{
+	m_slotOffsets.resize(m_inputPort.size() + 1);
+	m_slotSources.clear();
+	for (int i = 0; i < m_inputPort.size(); i++)
+	{
+		m_slotOffsets[i] = m_slotSources.size();
+		m_slotSources << m_inputPort.at(i)->connectedPorts().toVector();
+	}
+	m_slotOffsets[m_inputPort.size()] = m_slotSources.size();
+	m_iConsumers = getOutputProcessor().size();
+	m_bFrozen = true;
+}
+
+void Processor::unfreezePorts()
+{
+	m_bFrozen = false;
+	if (m_space)
+		m_space->invalidatePlan();
+}
+
+void Processor::onPortConnected(Port* src, Port* target)
+{
+	if (target && target->processor())
+		target->processor()->invalidate();
+	emit processorModified();
+}
+
+void Processor::onPortDisconnected(Port* src, Port* target)
+{
+	if (target && target->processor())
+		target->processor()->invalidate();
+	emit processorModified();
+}
+
+void Processor::notifyDataWillChange()
+{
+	{
+		QWriteLocker lock(&m_workingLock);
+		m_bDataDirty	= true;
+	}
+	///
+	/// ɵִʱӴһûпʼִУҪȴ
+	if (m_space && m_space->isScheduling())
+		return;
+	QList<Processor*> processors = getOutputProcessor();
+	for (QList<Processor*>::iterator itr = processors.begin(); itr != processors.end(); itr++)
+	{
+		(*itr)->waitForFinish();
+		(*itr)->notifyDataWillChange();
+	}
+}
+
+void Processor::notifyProcess()
+{
+	clearDataDirty();
+	///
+	/// ɵִʱӴɵɷ
+	if (m_space && m_space->isScheduling())
+		return;
+	QList<Processor*> processors = getOutputProcessor();
+	m_waitProcessors = processors;
+	for (QList<Processor*>::iterator itr = processors.begin(); itr != processors.end(); itr++)
+		(*itr)->onNotifyProcess();
+}
+
+void Processor::onNotifyDataChanged()
+{
+	QWriteLocker lock(&m_workingLock);
+	m_iGeneration.ref();
+	m_bDataDirty = true;
+}
+
+void Processor::onNotifyProcess()
+{
+	QWriteLocker lock(&m_workingLock);
+	if (isRunning())
+		return;
+	for (QList<Port*>::iterator itr = m_inputPort.begin(); itr != m_inputPort.end(); itr++)
+	{
+		QList<Processor*> processors = (*itr)->connectedProcessors();
+		for (QList<Processor*>::iterator itr = processors.begin(); itr != processors.end(); itr++)
+		{
+			if ((*itr)->isDataDirty())
+				return;
+		}
+	}
+	start();
+}
+
+void Processor::onChildProcessFinished()
+{
+	onChildProcessorFinish((Processor*)sender());
+}
+
+void Processor::onChildProcessorFinish(Processor* p)
+{
+	m_waitProcessors.removeOne(p);
+	if (m_waitProcessors.size() == 0)
+		emit childProcessFinished();
+}
+
+void Processor::onCreateNewPort(Port::PortType pt)
+{
+	QString str;
+	if (pt == Port::IN_PORT)
+		str = tr("Input Port(%1)").arg(m_inputPort.size());
+	else
+		str = tr("Output Port(%1)").arg(m_outputPort.size());
+	addPort(pt, DATATYPE_MATRIX, str, true);
+}
+
+void Processor::beginRun()
+{
+	QWriteLocker lock(&m_workingLock);
+	m_iRunGeneration = m_iGeneration.load();
+}
+
+void Processor::clearDataDirty()
+{
+	QWriteLocker lock(&m_workingLock);
+	if (m_iGeneration.load() == m_iRunGeneration)
+		m_bDataDirty = false;
+}
+
+bool Processor::isDataDirty()
+{
+	QReadLocker lock(&m_workingLock);
+	return m_bDataDirty;
+}
+
+void Processor::invalidate()
+{
+	{
+		///
+		/// ִеĴm_bDataDirtyѾΪtrueҲҪm_iGenerationִнʱŲ
+		QWriteLocker lock(&m_workingLock);
+		m_iGeneration.ref();
+		if (m_bDataDirty)
+			return;
+		m_bDataDirty = true;
+	}
+	///
+	/// ѾǵĴټݣִʱҲִбִдδ
+	QList<Processor*> processors = getOutputProcessor();
+	foreach (Processor* processor, processors)
+		processor->invalidate();
+	if (m_space)
+		m_space->invalidate();
+}
+
+void Processor::waitChildrenFinished()
+{
+	QList<Processor*> ls = getOutputProcessor();
+	for (int i = 0; i < ls.size(); i++)
+		ls[i]->waitForFinish();
+}
+
+}
@@ -5,9 +5,12 @@
 #include "../designnet_core_global.h"
 #include "../property/propertyowner.h"
 #include "../data/datatype.h"
+#include "../data/matpayload.h"
 #include "Utils/XML/xmldeserializer.h"
 #include "port.h"
-#include "../widgets/processorfrontwidget.h"
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QElapsedTimer>
 #include <QFutureInterface>
 #include <QFutureWatcher>
 #include <QObject>
@@ -16,27 +19,34 @@
 #include <QList>
 #include <QMap>
 #include <QReadWriteLock>
+#include <QRunnable>
 
+/*!
+ * 声明处理器的create()和typeID()。typeID()按类型缓存，每个类型只在第一次调用时查表，
+ * 因此同一类型的处理器必须在构造函数中设置相同的名称，之后不能再用setName()修改。
+ */
 #define DECLEAR_PROCESSOR(x) \
 	virtual Processor* create(DesignNet::DesignNetSpace *space = 0) const \
 	{ \
 		return new x(space); \
+	} \
+	virtual Core::Id typeID() const \
+	{ \
+		static QBasicAtomicInt cache = Q_BASIC_ATOMIC_INITIALIZER(0); \
+		return cachedTypeID(cache); \
 	}
 
 #define BEGIN_PROCESS() \
 	notifyDataWillChange(); \
 	m_bDataDirty = true;
 #define END_PROCESS() \
-	m_bDataDirty = false;
-
+	clearDataDirty();
 
-QT_BEGIN_NAMESPACE
-class QThread;
-QT_END_NAMESPACE
 
 namespace DesignNet{
 
 class IData;
+class ProcessorFrontWidget;
 class DesignNetSpace;
 class Processor;
 
@@ -49,18 +59,20 @@ enum ProcessorType
 class ProcessResult
 {
 public:
-	ProcessResult() : m_bSucessed(true), m_bNeedLoop(false)
+	ProcessResult() : m_bSucessed(true), m_bNeedLoop(false), m_bCanceled(false)
 	{
 	}
 	bool m_bSucessed;
 	bool m_bNeedLoop;	// 是否需要重复执行
+	bool m_bCanceled;	// 是否因为取消或者超过期限而停止
 };
 
-class ProcessorWorker : public QObject{
+class ProcessorWorker : public QObject, public QRunnable{
 	Q_OBJECT
 public:
 	ProcessorWorker(Processor *processor);
 	bool isWorking();
+	QFuture<ProcessResult> prepare();	//!< 为下一次执行准备futureInterface
 	Processor* m_processor;
 public slots:
 	void run();
@@ -75,6 +87,8 @@ protected:
 class DESIGNNET_CORE_EXPORT Processor : public QObject, public PropertyOwner
 {
 	friend class ProcessorWorker;
+	friend class ResultCache;
+	friend class ExecutionPlan;
 	Q_OBJECT
 public:
     
@@ -88,7 +102,7 @@ public:
 
 	void waitForFinish();
 	void waitChildrenFinished();
-	ProcessResult result() { return m_watcher.result(); }
+	ProcessResult result() { return m_result; }
 
 	int indegree(QList<Processor*> exclusions = QList<Processor*>()) const; //!< 计算入度
 	virtual bool connectionTest(Port* pOutput, Port* pInput);
@@ -96,6 +110,7 @@ public:
 
 	QList<Processor*> getInputProcessor() const;
 	QList<Processor*> getOutputProcessor() const;
+	int consumerCount() const;		//!< 连接到输出端口的处理器个数
 
 	//////////////////////////////////////////////////////////////////////////
 
@@ -126,22 +141,43 @@ public:
 	QList<ProcessData*> getData(QString sLabel);
 	ProcessData			getOneData(QString sLabel);
 
+	///
+	/// 按槽访问输入：槽是输入端口的下标，应在prepareProcess()中用inputSlot()查找一次，
+	/// 执行时直接按下标读取，不再比较端口名称。执行计划建立后数据指针已经冻结，不需要遍历连接
+	int					inputSlot(const QString &sLabel) const;	//!< 名称为\e sLabel 的输入端口的槽，不存在时返回-1
+	int					inputDataCount(int slot);				//!< 槽\e slot 上数据的个数
+	ProcessData*		inputData(int slot, int i = 0);			//!< 槽\e slot 上的第\e i 份数据，不存在时返回0
+	Port*				inputSource(int slot, int i = 0);		//!< 槽\e slot 所连接的第\e i 个输出端口，不存在时返回0
+	QList<ProcessData*> getData(int slot);
+	ProcessData			getOneData(int slot);
+
 	template<class T>
 	T getPortData(PortData ptData)
 	{
 		return getOneData(ptData.strName).variant.value<T>();
 	}
+	template<class T>
+	T getPortData(int slot)
+	{
+		const ProcessData *pd = inputData(slot);
+		return pd ? pd->variant.value<T>() : T();
+	}
+	MatPayload getPortPayload(PortData ptData);	//!< 读取pushData(const cv::Mat&...)放入的数据，不复制缓冲区
 
 
 	void pushData(ProcessData &pd, QString strLabel);
 	void pushData(QVariant &var, DataType dataType, QString strLabel = "", int iProcessId = -1);
 	void pushData(IData* data, QString strLabel = "", int iProcessId = -1);
+	void pushData(const cv::Mat &mat, DataType dataType, QString strLabel = "", int iProcessId = -1);	//!< 复制\e mat 到MatBufferPool的缓冲区，以MatPayload放入端口；已有MatPayload时使用pushData(QVariant&...)避免复制
 
 	QList<ProcessData>	getOutputData(DataType dt = DATATYPE_INVALID);
 	QList<ProcessData>	getInputData(DataType dt = DATATYPE_INVALID);
 	//////////////////////////////////////////////////////////////////////////
 
 	void start();
+	bool execute();					//!< 在当前线程中同步执行，由调度器调用
+	qint64 executionTime() const { return m_iExecutionTime; }	//!< execute()累计耗时，微秒
+	int executionCount() const { return m_iExecutionCount; }	//!< execute()执行次数，从缓存恢复不计
 
 	virtual void serialize(Utils::XmlSerializer& s) const;
 	virtual void deserialize(Utils::XmlDeserializer& s) ;
@@ -150,7 +186,13 @@ public:
 	
 	bool isRunning();
 
+	virtual void cancel();				//!< 请求停止正在进行的执行，下一次start()或execute()时清除
+	virtual bool isCanceled() const;	//!< 已被取消或者超过所在DesignNetSpace的期限，process()中的长循环应定期检查，返回true时尽快返回false
+
 	virtual bool prepareProcess() { return true; }
+	virtual bool isCacheable() const;	//!< 结果是否只由类型、属性和输入数据决定，可以由ResultCache缓存；默认false，纯函数式的处理器重载返回true
+	virtual int  tileHalo() const;		//!< 分块处理时每个分块四周需要的额外像素数，-1表示不能分块（默认）
+	virtual void shareResources(const Processor *prototype);	//!< 作为DesignNetSpace::createReplica()的副本时，共享\e prototype 已经载入的只读资源
 
 	bool connectTo(Processor* child);
 	bool disconnect(Processor* pChild);
@@ -158,6 +200,7 @@ public:
 	void detach();
 
 	bool isDataDirty();
+	void invalidate();				//!< 标记需要重新执行，下游处理器和所在的DesignNetSpace也会被标记
 
 	bool isResizableInput() { return m_bResizableInput; }
 
@@ -203,12 +246,28 @@ protected:
 	virtual void propertyChanged(Property *prop);
 	virtual void propertyAdded(Property* prop);
 
+	Core::Id cachedTypeID(QBasicAtomicInt &cache) const;	//!< DECLEAR_PROCESSOR使用，\e cache 为0时计算Processor::typeID()并保存
 	virtual bool beforeProcess(QFutureInterface<ProcessResult> &future);		//!< 处理之前的准备,这里会确保数据已经准备好了
 	virtual bool process(QFutureInterface<ProcessResult> &future) = 0;			//!< 正式处理
 	virtual void afterProcess(bool status = true);		//!< 完成处理
 	virtual bool finishProcess() { return true; }
+
+	/*!
+	 * \brief 处理一个分块
+	 *
+	 * \e input 为分块加上四周tileHalo()个像素（在图像边界处截断），\e roi 为分块在\e input 中的位置，
+	 * \e output 为输出图像中对应分块的区域，与\e roi 大小相同。结果应直接写入\e output 。
+	 * 多个分块在不同的线程中同时处理，不能修改处理器的状态。
+	 */
+	virtual bool processTile(const cv::Mat &input, const cv::Rect &roi, cv::Mat &output);
+	bool processTiled(const cv::Mat &input, cv::Mat &output);	//!< 把\e input 分块后并行调用processTile()，\e output 需要预先分配为相同的行列数；由process()调用，引擎不会自动调用
 	
 	virtual void onCreateNewPort(Port::PortType pt);
+	void cacheRestored();				//!< 输出端口的数据已经由ResultCache恢复
+	void beginRun();					//!< 记录本次执行开始时的m_iGeneration
+	void clearDataDirty();				//!< 执行期间没有invalidate()时清除m_bDataDirty
+	void freezePorts();					//!< 由ExecutionPlan调用，冻结输入槽和消费者个数
+	void unfreezePorts();				//!< 端口或连接有变化，冻结的数据和所在Space的执行计划失效
 
 	//////////////////////////////////////////////////////////////////////////
 
@@ -217,6 +276,8 @@ protected:
 	int				m_id;
 	ProcessorType	m_eType;
 	bool			m_bDataDirty;			//!< 数据有更新
+	QAtomicInt		m_iGeneration;			//!< invalidate()等修改的次数
+	int				m_iRunGeneration;		//!< 本次执行开始时的m_iGeneration
 
 	QList<Port*>	m_outputPort;			//!< 所有的输出端口
 	QList<Port*>	m_inputPort;			//!< 输入端口
@@ -228,9 +289,22 @@ protected:
 	bool			m_bResizableInput;		//!< 可变数量的输入
 
 	QFutureWatcher<ProcessResult> m_watcher;	//!< 用于控制进度
-	QThread*  m_thread;
+	ProcessResult	m_result;				//!< 最近一次执行的结果
+	qint64			m_iExecutionTime;		//!< execute()累计耗时，微秒
+	int				m_iExecutionCount;		//!< execute()执行次数
+	QAtomicInt		m_canceled;				//!< cancel()设置
+	QAtomicPointer<QFutureInterface<ProcessResult> > m_future;	//!< run()执行期间的future，用于检查QFuture::cancel()
+	QElapsedTimer	m_processTimer;			//!< 本次run()的开始时间，用于DesignNetSpace::processTimeout()
+
+	bool					m_bFrozen;		//!< m_slotOffsets、m_slotSources和m_iConsumers是否有效
+	QVector<int>			m_slotOffsets;	//!< 槽i连接的端口为m_slotSources[m_slotOffsets[i]] ~ m_slotSources[m_slotOffsets[i + 1] - 1]
+	QVector<Port*>			m_slotSources;	//!< 上游输出端口
+	int						m_iConsumers;
 
 	friend class Port;
+private:
+	struct TileJob;
+	class TileRunner;
 };
 }
 
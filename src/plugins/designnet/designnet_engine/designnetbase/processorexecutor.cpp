@@ -0,0 +1,251 @@
+#include "processorexecutor.h"
+#include <QAtomicInt>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadStorage>
+#include <QVector>
+#include <QWaitCondition>
+
+namespace DesignNet{
+
+static QThreadStorage<int> s_workerIndex;	//!< 工作线程在执行器中的下标
+
+class ProcessorExecutorWorker : public QThread
+{
+public:
+	ProcessorExecutorWorker(ProcessorExecutorPrivate *d, int index)
+		: m_d(d), m_index(index)
+	{
+	}
+	void run();
+
+	QMutex				m_mutex;
+	QList<QRunnable*>	m_tasks;	//!< 本线程的任务队列，尾部由本线程使用，头部用于窃取
+protected:
+	ProcessorExecutorPrivate*	m_d;
+	int							m_index;
+};
+
+class ProcessorExecutorPrivate
+{
+public:
+	ProcessorExecutorPrivate();
+	~ProcessorExecutorPrivate();
+
+	void push(int index, QRunnable *task);
+	QRunnable* take(int index);
+	void runTask(QRunnable *task);
+
+	QVector<ProcessorExecutorWorker*>	m_workers;
+	QAtomicInt		m_pending;		//!< 所有队列中的任务个数
+	QAtomicInt		m_next;			//!< 外部线程提交任务时轮流选择队列
+	QAtomicInt		m_bQuit;
+	QAtomicInt		m_completed;	//!< 已经执行完的任务个数
+	QMutex			m_sleepMutex;
+	QWaitCondition	m_wake;
+	QWaitCondition	m_taskFinished;	//!< 任务执行完或有新任务时唤醒waitForTask()
+	int				m_iWaiters;		//!< 阻塞在waitForTask()中的线程个数，由m_sleepMutex保护
+};
+
+void ProcessorExecutorWorker::run()
+{
+	s_workerIndex.setLocalData(m_index);
+	forever
+	{
+		QRunnable *task = m_d->take(m_index);
+		if (task)
+		{
+			m_d->runTask(task);
+			continue;
+		}
+		QMutexLocker locker(&m_d->m_sleepMutex);
+		if (m_d->m_bQuit.load())
+			break;
+		if (m_d->m_pending.load() > 0)
+			continue;
+		m_d->m_wake.wait(&m_d->m_sleepMutex);
+	}
+}
+
+ProcessorExecutorPrivate::ProcessorExecutorPrivate()
+	: m_iWaiters(0)
+{
+	int count = qMax(QThread::idealThreadCount(), 1);
+	for (int i = 0; i < count; i++)
+		m_workers.push_back(new ProcessorExecutorWorker(this, i));
+	foreach (ProcessorExecutorWorker *worker, m_workers)
+		worker->start();
+}
+
+ProcessorExecutorPrivate::~ProcessorExecutorPrivate()
+{
+	{
+		QMutexLocker locker(&m_sleepMutex);
+		m_bQuit.store(1);
+		m_wake.wakeAll();
+		m_taskFinished.wakeAll();
+	}
+	foreach (ProcessorExecutorWorker *worker, m_workers)
+	{
+		worker->wait();
+		foreach (QRunnable *task, worker->m_tasks)
+		{
+			if (task->autoDelete())
+				delete task;
+		}
+	}
+	qDeleteAll(m_workers);
+}
+
+void ProcessorExecutorPrivate::push( int index, QRunnable *task )
+{
+	ProcessorExecutorWorker *worker = m_workers[index];
+	{
+		QMutexLocker locker(&worker->m_mutex);
+		worker->m_tasks.append(task);
+	}
+	m_pending.ref();
+	QMutexLocker locker(&m_sleepMutex);
+	m_wake.wakeOne();
+	///
+	/// 等待中的工作线程也可以执行新任务
+	if (m_iWaiters > 0)
+		m_taskFinished.wakeAll();
+}
+
+QRunnable* ProcessorExecutorPrivate::take( int index )
+{
+	///
+	/// 先取自己队列尾部的任务（刚提交的任务数据还在缓存中）
+	if (index >= 0)
+	{
+		ProcessorExecutorWorker *worker = m_workers[index];
+		QMutexLocker locker(&worker->m_mutex);
+		if (!worker->m_tasks.isEmpty())
+		{
+			m_pending.deref();
+			return worker->m_tasks.takeLast();
+		}
+	}
+	///
+	/// 从其它队列头部窃取
+	const int count = m_workers.size();
+	for (int i = 1; i <= count; i++)
+	{
+		ProcessorExecutorWorker *victim = m_workers[(qMax(index, 0) + i) % count];
+		QMutexLocker locker(&victim->m_mutex);
+		if (!victim->m_tasks.isEmpty())
+		{
+			m_pending.deref();
+			return victim->m_tasks.takeFirst();
+		}
+	}
+	return 0;
+}
+
+void ProcessorExecutorPrivate::runTask( QRunnable *task )
+{
+	bool bAutoDelete = task->autoDelete();
+	task->run();
+	if (bAutoDelete)
+		delete task;
+	///
+	/// 计数在加锁之前增加，waitForTask()在锁内检查计数，不会错过唤醒
+	m_completed.ref();
+	QMutexLocker locker(&m_sleepMutex);
+	if (m_iWaiters > 0)
+		m_taskFinished.wakeAll();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+QAtomicPointer<ProcessorExecutor> ProcessorExecutor::m_instance;
+static QBasicMutex s_instanceMutex;	//!< 保护instance()中的创建
+
+ProcessorExecutor::ProcessorExecutor()
+	: d(new ProcessorExecutorPrivate)
+{
+}
+
+ProcessorExecutor::~ProcessorExecutor()
+{
+	delete d;
+	d = 0;
+}
+
+ProcessorExecutor* ProcessorExecutor::instance()
+{
+	///
+	/// 调度器和处理器可能在不同线程中第一次调用
+	ProcessorExecutor *executor = m_instance.loadAcquire();
+	if (executor)
+		return executor;
+	QMutexLocker locker(&s_instanceMutex);
+	executor = m_instance.load();
+	if (!executor)
+	{
+		executor = new ProcessorExecutor;
+		m_instance.storeRelease(executor);
+	}
+	return executor;
+}
+
+void ProcessorExecutor::Release()
+{
+	QMutexLocker locker(&s_instanceMutex);
+	delete m_instance.fetchAndStoreOrdered(0);
+}
+
+void ProcessorExecutor::start( QRunnable *task )
+{
+	if (s_workerIndex.hasLocalData())
+	{
+		d->push(s_workerIndex.localData(), task);
+		return;
+	}
+	int index = (d->m_next.fetchAndAddRelaxed(1) & 0x7fffffff) % d->m_workers.size();
+	d->push(index, task);
+}
+
+bool ProcessorExecutor::tryRunOne()
+{
+	if (!s_workerIndex.hasLocalData())
+		return false;
+	QRunnable *task = d->take(s_workerIndex.localData());
+	if (!task)
+		return false;
+	d->runTask(task);
+	return true;
+}
+
+bool ProcessorExecutor::isWorkerThread() const
+{
+	return s_workerIndex.hasLocalData();
+}
+
+int ProcessorExecutor::threadCount() const
+{
+	return d->m_workers.size();
+}
+
+int ProcessorExecutor::completedTasks() const
+{
+	return d->m_completed.load();
+}
+
+void ProcessorExecutor::waitForTask( int completed )
+{
+	QMutexLocker locker(&d->m_sleepMutex);
+	if (d->m_bQuit.load() || d->m_completed.load() != completed)
+		return;
+	if (isWorkerThread() && d->m_pending.load() > 0)
+		return;
+	d->m_iWaiters++;
+	d->m_taskFinished.wait(&d->m_sleepMutex);
+	d->m_iWaiters--;
+}
+
+}
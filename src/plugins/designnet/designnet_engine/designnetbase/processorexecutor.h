@@ -0,0 +1,65 @@
+#ifndef PROCESSOREXECUTOR_H
+#define PROCESSOREXECUTOR_H
+
+#include "../designnet_core_global.h"
+#include <QAtomicPointer>
+#include <QFuture>
+
+QT_BEGIN_NAMESPACE
+class QRunnable;
+QT_END_NAMESPACE
+
+namespace DesignNet{
+
+class ProcessorExecutorPrivate;
+
+/*!
+ * \brief 处理器专用的执行器
+ *
+ * 每个核心一个工作线程，每个工作线程拥有自己的任务队列。工作线程从自己队列的尾部取任务，
+ * 自己的队列为空时从其它线程队列的头部窃取任务。与QtConcurrent使用的全局QThreadPool相互独立，
+ * 所有的Processor（包括ProcessorType_Permanent）都在该执行器上执行，不再为每个处理器创建线程。
+ */
+class DESIGNNET_CORE_EXPORT ProcessorExecutor
+{
+public:
+	static ProcessorExecutor* instance();
+	static void Release();	//!< 停止所有工作线程并释放
+
+	void start(QRunnable *task);	//!< 提交任务，工作线程中提交的任务放入本线程的队列
+	bool tryRunOne();				//!< 在工作线程中执行一个等待中的任务，没有任务时返回false
+	bool isWorkerThread() const;	//!< 当前线程是否是执行器的工作线程
+	int threadCount() const;
+	int completedTasks() const;		//!< 已经执行完的任务个数，在检查等待条件之前读取，传给waitForTask()
+	void waitForTask(int completed);	//!< 阻塞到有任务执行完（completedTasks()不等于\e completed ），工作线程中有等待的任务时立即返回
+
+	/*!
+	 * \brief 等待\e future 完成
+	 *
+	 * 在工作线程中等待时会帮助执行其它任务，避免所有工作线程都阻塞在等待上。
+	 */
+	template<class T>
+	void waitForFinished(const QFuture<T> &future)
+	{
+		while (isWorkerThread())
+		{
+			const int completed = completedTasks();
+			if (future.isFinished())
+				break;
+			if (!tryRunOne())
+				waitForTask(completed);
+		}
+		future.waitForFinished();
+	}
+
+protected:
+	ProcessorExecutor();
+	~ProcessorExecutor();
+
+	ProcessorExecutorPrivate*	d;
+	static QAtomicPointer<ProcessorExecutor>	m_instance;
+};
+
+}
+
+#endif // PROCESSOREXECUTOR_H
@@ -0,0 +1,93 @@
+#include "processorfactory.h"
+#include "processor.h"
+#include "designnetspace.h"
+#include "extensionsystem/pluginmanager.h"
+#include "Utils/XML/xmlserializablefactory.h"
+#include <QHash>
+
+using namespace ExtensionSystem;
+namespace DesignNet{
+
+class ProcessorFactoryPrivate
+{
+public:
+	QHash<QString, Processor*>	m_processors;	//!< typeID-->原型
+	QList<Processor*>			m_order;		//!< 登记的顺序
+};
+
+ProcessorFactory *ProcessorFactory::m_instance = 0;
+
+ProcessorFactory::ProcessorFactory(QObject *parent)
+	: QObject(parent),
+	  d(new ProcessorFactoryPrivate)
+{
+	m_instance = this;
+	///
+	/// 嵌套的DesignNetSpace也通过XmlSerializableFactory创建
+	DesignNetSpace prototype;
+	Utils::XmlSerializableFactory::instance()->registerSerializable(&prototype);
+
+	PluginManager *pm = PluginManager::instance();
+	foreach (QObject *obj, pm->getAllObjects())
+		objectAdded(obj);
+	connect(pm, SIGNAL(objectAdded(QObject*)), this, SLOT(objectAdded(QObject*)));
+	connect(pm, SIGNAL(aboutToRemoveObject(QObject*)), this, SLOT(aboutToRemoveObject(QObject*)));
+}
+
+ProcessorFactory::~ProcessorFactory()
+{
+	if (m_instance == this)
+		m_instance = 0;
+	delete d;
+}
+
+ProcessorFactory *ProcessorFactory::instance()
+{
+	return m_instance;
+}
+
+void ProcessorFactory::registerProcessor(Processor *processor)
+{
+	if (!processor)
+		return;
+	const QString typeId = processor->typeID().toString();
+	if (d->m_processors.contains(typeId))
+		return;
+	d->m_processors.insert(typeId, processor);
+	d->m_order.append(processor);
+	Utils::XmlSerializableFactory::instance()->registerSerializable(processor);
+}
+
+Processor *ProcessorFactory::create(DesignNetSpace *space, const QString &typeId) const
+{
+	Processor *prototype = d->m_processors.value(typeId);
+	if (!prototype)
+		return 0;
+	Processor *processor = prototype->create(space);
+	processor->init();
+	return processor;
+}
+
+QList<Processor*> ProcessorFactory::processors() const
+{
+	return d->m_order;
+}
+
+void ProcessorFactory::objectAdded(QObject *obj)
+{
+	registerProcessor(qobject_cast<Processor*>(obj));
+}
+
+void ProcessorFactory::aboutToRemoveObject(QObject *obj)
+{
+	Processor *processor = qobject_cast<Processor*>(obj);
+	if (!processor)
+		return;
+	const QString typeId = processor->typeID().toString();
+	if (d->m_processors.value(typeId) != processor)
+		return;
+	d->m_processors.remove(typeId);
+	d->m_order.removeOne(processor);
+}
+
+}
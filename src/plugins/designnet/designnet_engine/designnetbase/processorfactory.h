@@ -0,0 +1,44 @@
+#ifndef PROCESSORFACTORY_H
+#define PROCESSORFACTORY_H
+
+#include "../designnet_core_global.h"
+#include <QObject>
+#include <QList>
+
+namespace DesignNet{
+
+class DesignNetSpace;
+class Processor;
+class ProcessorFactoryPrivate;
+
+/*!
+ * \brief 按类型ID创建处理器
+ *
+ * 插件放入对象池的Processor作为原型登记（同时登记到Utils::XmlSerializableFactory，
+ * 读取网络文件时按serializableType()创建），create()根据Processor::typeID()复制原型。
+ * 由DesignNetCorePlugin创建，插件卸载时释放。
+ */
+class DESIGNNET_CORE_EXPORT ProcessorFactory : public QObject
+{
+	Q_OBJECT
+public:
+	explicit ProcessorFactory(QObject *parent = 0);
+	~ProcessorFactory();
+	static ProcessorFactory* instance();
+
+	void registerProcessor(Processor *processor);	//!< 登记原型，同一typeID只登记第一个
+	Processor* create(DesignNetSpace *space, const QString &typeId) const;	//!< 没有该类型时返回0
+	QList<Processor*> processors() const;			//!< 所有原型
+
+public slots:
+	void objectAdded(QObject *obj);
+	void aboutToRemoveObject(QObject *obj);
+
+private:
+	ProcessorFactoryPrivate *d;
+	static ProcessorFactory *m_instance;
+};
+
+}
+
+#endif // PROCESSORFACTORY_H
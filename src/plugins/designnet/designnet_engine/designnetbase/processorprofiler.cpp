@@ -0,0 +1,396 @@
+#include "processorprofiler.h"
+#include "processor.h"
+#include "../data/imagedata.h"
+#include "../data/matbufferpool.h"
+#include "../data/matpayload.h"
+#include "../data/matrixdata.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+
+namespace DesignNet{
+
+static qint64 matBytes(const cv::Mat &mat)
+{
+	return mat.empty() ? 0 : qint64(mat.total() * mat.elemSize());
+}
+
+ProcessorProfiler::Record::Record()
+	: processorId(-1),
+	threadIndex(0),
+	queued(-1),
+	started(0),
+	beforeProcessEnd(0),
+	processEnd(0),
+	finished(0),
+	bytesIn(0),
+	bytesOut(0),
+	peakMatBytes(0),
+	bSucceeded(false)
+{
+}
+
+qint64 ProcessorProfiler::Record::queueWait() const
+{
+	return queued < 0 ? 0 : started - queued;
+}
+
+qint64 ProcessorProfiler::Record::beforeProcessTime() const
+{
+	return beforeProcessEnd - started;
+}
+
+qint64 ProcessorProfiler::Record::processTime() const
+{
+	return processEnd - beforeProcessEnd;
+}
+
+qint64 ProcessorProfiler::Record::afterProcessTime() const
+{
+	return finished - processEnd;
+}
+
+qint64 ProcessorProfiler::Record::totalTime() const
+{
+	return finished - started;
+}
+
+ProcessorProfiler *ProcessorProfiler::m_instance = 0;
+QAtomicInt ProcessorProfiler::m_enabled(0);
+
+ProcessorProfiler::ProcessorProfiler()
+	: m_iMaximumRecords(100000)
+{
+	m_clock.start();
+}
+
+ProcessorProfiler::~ProcessorProfiler()
+{
+}
+
+ProcessorProfiler* ProcessorProfiler::instance()
+{
+	if (!m_instance)
+		m_instance = new ProcessorProfiler;
+	return m_instance;
+}
+
+void ProcessorProfiler::Release()
+{
+	m_enabled.store(0);
+	if (m_instance)
+	{
+		delete m_instance;
+		m_instance = 0;
+	}
+}
+
+ProcessorProfiler* ProcessorProfiler::active()
+{
+	return m_enabled.load() ? m_instance : 0;
+}
+
+void ProcessorProfiler::setEnabled( bool bEnabled )
+{
+	if (m_enabled.fetchAndStoreOrdered(bEnabled ? 1 : 0) != (bEnabled ? 1 : 0))
+		emit enabledChanged(bEnabled);
+}
+
+bool ProcessorProfiler::isEnabled() const
+{
+	return m_enabled.load() != 0;
+}
+
+void ProcessorProfiler::setMaximumRecords( int count )
+{
+	QMutexLocker locker(&m_mutex);
+	m_iMaximumRecords = qMax(1, count);
+	while (m_records.size() > m_iMaximumRecords)
+		m_records.removeFirst();
+}
+
+int ProcessorProfiler::maximumRecords() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_iMaximumRecords;
+}
+
+void ProcessorProfiler::clear()
+{
+	{
+		QMutexLocker locker(&m_mutex);
+		m_records.clear();
+		m_last.clear();
+		m_queued.clear();
+	}
+	emit cleared();
+}
+
+qint64 ProcessorProfiler::now() const
+{
+	return m_clock.nsecsElapsed() / 1000;
+}
+
+void ProcessorProfiler::queued( Processor *processor )
+{
+	const qint64 t = now();
+	QMutexLocker locker(&m_mutex);
+	m_queued.insert(processor, t);
+}
+
+void ProcessorProfiler::dequeued( Processor *processor )
+{
+	QMutexLocker locker(&m_mutex);
+	m_queued.remove(processor);
+}
+
+void ProcessorProfiler::begin( Processor *processor, Record &record )
+{
+	record.processorId		= processor->id();
+	record.processorName	= processor->name();
+	record.processorType	= processor->typeID().toString();
+	record.bytesIn			= inputBytes(processor);
+	{
+		QMutexLocker locker(&m_mutex);
+		record.threadIndex	= threadIndex();
+		QHash<const Processor*, qint64>::iterator itr = m_queued.find(processor);
+		if (itr != m_queued.end())
+		{
+			record.queued = itr.value();
+			m_queued.erase(itr);
+		}
+	}
+	MatBufferPool::beginThreadTracking();
+	record.started = now();
+	record.beforeProcessEnd = record.processEnd = record.started;
+}
+
+void ProcessorProfiler::end( Processor *processor, Record &record, bool bSucceeded )
+{
+	record.finished		= now();
+	record.peakMatBytes	= MatBufferPool::endThreadTracking();
+	record.bSucceeded	= bSucceeded;
+	record.bytesOut		= outputBytes(processor);
+	{
+		QMutexLocker locker(&m_mutex);
+		if (m_records.size() >= m_iMaximumRecords)
+			m_records.removeFirst();
+		m_records << record;
+		m_last.insert(processor, record);
+	}
+	emit recorded(record.processorId);
+}
+
+void ProcessorProfiler::forget( Processor *processor )
+{
+	if (!m_instance)
+		return;
+	QMutexLocker locker(&m_instance->m_mutex);
+	m_instance->m_last.remove(processor);
+	m_instance->m_queued.remove(processor);
+}
+
+QList<ProcessorProfiler::Record> ProcessorProfiler::records() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_records;
+}
+
+bool ProcessorProfiler::lastRecord( const Processor *processor, Record *record ) const
+{
+	QMutexLocker locker(&m_mutex);
+	QHash<const Processor*, Record>::const_iterator itr = m_last.constFind(processor);
+	if (itr == m_last.constEnd())
+		return false;
+	if (record)
+		*record = itr.value();
+	return true;
+}
+
+qint64 ProcessorProfiler::maximumLastTime() const
+{
+	QMutexLocker locker(&m_mutex);
+	qint64 maximum = 0;
+	foreach (const Record &record, m_last)
+		maximum = qMax(maximum, record.totalTime());
+	return maximum;
+}
+
+/*!
+ * \brief Chrome trace-event格式
+ *
+ * 每次执行是一个"X"事件，beforeProcess/process/afterProcess是嵌套在其中的子事件，
+ * 排队等待用异步事件（"b"/"e"）表示，显示在单独的轨道上。
+ */
+QByteArray ProcessorProfiler::chromeTrace() const
+{
+	QList<Record> all;
+	QHash<Qt::HANDLE, int> threads;
+	{
+		QMutexLocker locker(&m_mutex);
+		all = m_records;
+		threads = m_threads;
+	}
+	const qint64 pid = QCoreApplication::applicationPid();
+	QJsonArray events;
+
+	QHash<Qt::HANDLE, int>::const_iterator itr = threads.constBegin();
+	for (; itr != threads.constEnd(); itr++)
+	{
+		QJsonObject meta;
+		meta.insert(QLatin1String("name"), QLatin1String("thread_name"));
+		meta.insert(QLatin1String("ph"), QLatin1String("M"));
+		meta.insert(QLatin1String("pid"), pid);
+		meta.insert(QLatin1String("tid"), itr.value());
+		QJsonObject args;
+		args.insert(QLatin1String("name"), itr.value() == 0 ? QString(QLatin1String("Main"))
+			: QString(QLatin1String("Worker %1")).arg(itr.value()));
+		meta.insert(QLatin1String("args"), args);
+		events.append(meta);
+	}
+
+	for (int i = 0; i < all.size(); i++)
+	{
+		const Record &record = all.at(i);
+		const QString name = QString(QLatin1String("%1 (%2)")).arg(record.processorName).arg(record.processorId);
+
+		QJsonObject args;
+		args.insert(QLatin1String("id"), record.processorId);
+		args.insert(QLatin1String("type"), record.processorType);
+		args.insert(QLatin1String("queue_us"), double(record.queueWait()));
+		args.insert(QLatin1String("before_us"), double(record.beforeProcessTime()));
+		args.insert(QLatin1String("process_us"), double(record.processTime()));
+		args.insert(QLatin1String("after_us"), double(record.afterProcessTime()));
+		args.insert(QLatin1String("bytes_in"), double(record.bytesIn));
+		args.insert(QLatin1String("bytes_out"), double(record.bytesOut));
+		args.insert(QLatin1String("peak_mat_bytes"), double(record.peakMatBytes));
+		args.insert(QLatin1String("succeeded"), record.bSucceeded);
+
+		QJsonObject event;
+		event.insert(QLatin1String("name"), name);
+		event.insert(QLatin1String("cat"), QLatin1String("processor"));
+		event.insert(QLatin1String("ph"), QLatin1String("X"));
+		event.insert(QLatin1String("ts"), double(record.started));
+		event.insert(QLatin1String("dur"), double(record.totalTime()));
+		event.insert(QLatin1String("pid"), pid);
+		event.insert(QLatin1String("tid"), record.threadIndex);
+		event.insert(QLatin1String("args"), args);
+		events.append(event);
+
+		const char *phases[3] = { "beforeProcess", "process", "afterProcess" };
+		const qint64 starts[3] = { record.started, record.beforeProcessEnd, record.processEnd };
+		const qint64 ends[3] = { record.beforeProcessEnd, record.processEnd, record.finished };
+		for (int j = 0; j < 3; j++)
+		{
+			QJsonObject phase;
+			phase.insert(QLatin1String("name"), QLatin1String(phases[j]));
+			phase.insert(QLatin1String("cat"), QLatin1String("phase"));
+			phase.insert(QLatin1String("ph"), QLatin1String("X"));
+			phase.insert(QLatin1String("ts"), double(starts[j]));
+			phase.insert(QLatin1String("dur"), double(ends[j] - starts[j]));
+			phase.insert(QLatin1String("pid"), pid);
+			phase.insert(QLatin1String("tid"), record.threadIndex);
+			events.append(phase);
+		}
+
+		if (record.queued >= 0)
+		{
+			QJsonObject wait;
+			wait.insert(QLatin1String("name"), name);
+			wait.insert(QLatin1String("cat"), QLatin1String("queue"));
+			wait.insert(QLatin1String("id"), i);
+			wait.insert(QLatin1String("pid"), pid);
+			wait.insert(QLatin1String("tid"), record.threadIndex);
+			wait.insert(QLatin1String("ph"), QLatin1String("b"));
+			wait.insert(QLatin1String("ts"), double(record.queued));
+			events.append(wait);
+			wait.insert(QLatin1String("ph"), QLatin1String("e"));
+			wait.insert(QLatin1String("ts"), double(record.started));
+			events.append(wait);
+		}
+	}
+
+	QJsonObject root;
+	root.insert(QLatin1String("traceEvents"), events);
+	root.insert(QLatin1String("displayTimeUnit"), QLatin1String("ms"));
+	return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool ProcessorProfiler::exportChromeTrace( const QString &fileName, QString *errorString ) const
+{
+	QSaveFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly)
+		|| file.write(chromeTrace()) < 0
+		|| !file.commit())
+	{
+		if (errorString)
+			*errorString = file.errorString();
+		return false;
+	}
+	return true;
+}
+
+qint64 ProcessorProfiler::payloadBytes( const ProcessData &data )
+{
+	const QVariant &variant = data.variant;
+	if (variant.userType() == qMetaTypeId<MatPayload>())
+		return matBytes(variant.value<MatPayload>().mat());
+	if (variant.userType() == qMetaTypeId<IData*>())
+	{
+		IData *idata = variant.value<IData*>();
+		if (ImageData *image = qobject_cast<ImageData*>(idata))
+			return matBytes(image->payload().mat());
+		if (MatrixData *matrix = qobject_cast<MatrixData*>(idata))
+			return matBytes(matrix->payload().mat());
+	}
+	return 0;
+}
+
+int ProcessorProfiler::threadIndex()
+{
+	const Qt::HANDLE handle = QThread::currentThreadId();
+	QHash<Qt::HANDLE, int>::const_iterator itr = m_threads.constFind(handle);
+	if (itr != m_threads.constEnd())
+		return itr.value();
+	int index = 0;
+	if (!QCoreApplication::instance() || QThread::currentThread() != QCoreApplication::instance()->thread())
+	{
+		index = 1;
+		foreach (int i, m_threads)
+			index = qMax(index, i + 1);
+	}
+	m_threads.insert(handle, index);
+	return index;
+}
+
+qint64 ProcessorProfiler::inputBytes( Processor *processor )
+{
+	qint64 bytes = 0;
+	foreach (Port *port, processor->getPorts(Port::IN_PORT))
+	{
+		if (port->hasStagedData())
+		{
+			foreach (ProcessData *data, port->stagedData())
+				bytes += payloadBytes(*data);
+			continue;
+		}
+		foreach (Port *src, port->connectedPorts())
+			bytes += payloadBytes(*src->data());
+	}
+	return bytes;
+}
+
+qint64 ProcessorProfiler::outputBytes( Processor *processor )
+{
+	qint64 bytes = 0;
+	foreach (Port *port, processor->getPorts(Port::OUT_PORT))
+		bytes += payloadBytes(*port->data());
+	return bytes;
+}
+
+}
@@ -0,0 +1,111 @@
+#ifndef PROCESSORPROFILER_H
+#define PROCESSORPROFILER_H
+
+#include "../designnet_core_global.h"
+#include "port.h"
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+
+namespace DesignNet{
+
+class Processor;
+
+/*!
+ * \brief 处理器执行的性能记录
+ *
+ * 启用之后，Processor::run()每执行一次产生一条Record，记录在队列中等待的时间、
+ * beforeProcess()/process()/afterProcess()各自的耗时、执行线程、输入输出端口上的数据量，
+ * 以及执行期间当前线程通过MatBufferPool同时持有的最大字节数。
+ * 时间都是相对于profiler启动时刻的微秒数。
+ *
+ * exportChromeTrace()输出Chrome trace-event格式的JSON，可以在chrome://tracing或Perfetto中查看；
+ * ProcessorGraphicsBlock根据lastRecord()在网络图上显示每个处理器所占的时间比例。
+ */
+class DESIGNNET_CORE_EXPORT ProcessorProfiler : public QObject
+{
+	Q_OBJECT
+public:
+	struct Record
+	{
+		Record();
+		qint64 queueWait() const;			//!< 在执行队列中等待的时间
+		qint64 beforeProcessTime() const;
+		qint64 processTime() const;
+		qint64 afterProcessTime() const;
+		qint64 totalTime() const;			//!< 从开始执行到完成，不包括排队
+
+		int		processorId;
+		QString	processorName;
+		QString	processorType;
+		int		threadIndex;		//!< 执行线程的序号，主线程为0
+		qint64	queued;				//!< 进入执行队列的时间，-1表示没有经过队列
+		qint64	started;
+		qint64	beforeProcessEnd;
+		qint64	processEnd;
+		qint64	finished;
+		qint64	bytesIn;			//!< 输入端口上的数据字节数
+		qint64	bytesOut;			//!< 输出端口上的数据字节数
+		qint64	peakMatBytes;		//!< 执行期间当前线程同时持有的MatBufferPool缓冲区最大字节数
+		bool	bSucceeded;
+	};
+
+	static ProcessorProfiler* instance();
+	static void Release();
+	static ProcessorProfiler* active();	//!< 启用时返回instance()，否则返回0
+
+	void setEnabled(bool bEnabled = true);
+	bool isEnabled() const;
+	void setMaximumRecords(int count);	//!< 超出时丢弃最早的记录
+	int maximumRecords() const;
+	void clear();
+
+	qint64 now() const;					//!< 相对于启动时刻的微秒数
+	void queued(Processor *processor);	//!< 处理器被放入执行队列
+	void dequeued(Processor *processor);	//!< 处理器离开队列但没有执行，例如结果来自ResultCache
+	void begin(Processor *processor, Record &record);
+	void end(Processor *processor, Record &record, bool bSucceeded);
+	static void forget(Processor *processor);	//!< 处理器删除时调用，删除它的记录
+
+	QList<Record> records() const;
+	bool lastRecord(const Processor *processor, Record *record) const;	//!< 处理器最近一次的记录
+	qint64 maximumLastTime() const;		//!< 所有处理器最近一次记录中最长的totalTime()
+
+	QByteArray chromeTrace() const;
+	bool exportChromeTrace(const QString &fileName, QString *errorString = 0) const;
+
+	static qint64 payloadBytes(const ProcessData &data);	//!< 图像和矩阵数据的字节数
+
+signals:
+	void recorded(int processorId);	//!< 在执行线程中发出
+	void cleared();
+	void enabledChanged(bool bEnabled);
+
+protected:
+	ProcessorProfiler();
+	~ProcessorProfiler();
+
+	int threadIndex();	//!< 调用者需要持有m_mutex
+	static qint64 inputBytes(Processor *processor);
+	static qint64 outputBytes(Processor *processor);
+
+	static ProcessorProfiler*	m_instance;
+	static QAtomicInt			m_enabled;
+
+	mutable QMutex							m_mutex;
+	QElapsedTimer							m_clock;
+	QList<Record>							m_records;
+	QHash<const Processor*, Record>			m_last;
+	QHash<const Processor*, qint64>			m_queued;	//!< 处理器 -> 进入队列的时间
+	QHash<Qt::HANDLE, int>					m_threads;	//!< 线程 -> 序号
+	int										m_iMaximumRecords;
+};
+
+}
+
+#endif // PROCESSORPROFILER_H
@@ -0,0 +1,102 @@
+#include "replicabatch.h"
+#include "designnetspace.h"
+#include <QRunnable>
+#include <QThreadPool>
+
+namespace DesignNet{
+
+/*!
+ * \brief 一个副本的执行线程，依次领取输入直到全部领取完
+ */
+class ReplicaBatch::Runner : public QRunnable
+{
+public:
+	Runner(ReplicaBatch *batch, DesignNetSpace *replica)
+		: m_batch(batch), m_replica(replica)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		int index;
+		while (!m_batch->isCanceled()
+			&& (index = m_batch->m_next.fetchAndAddOrdered(1)) < m_batch->m_inputCount)
+		{
+			if (!m_batch->processInput(m_replica, index))
+				m_batch->m_failures.fetchAndAddOrdered(1);
+		}
+	}
+
+protected:
+	ReplicaBatch*	m_batch;
+	DesignNetSpace*	m_replica;
+};
+
+ReplicaBatch::ReplicaBatch(DesignNetSpace *prototype)
+	: m_prototype(prototype),
+	m_inputCount(0)
+{
+	m_replicas << prototype;
+}
+
+ReplicaBatch::~ReplicaBatch()
+{
+	for (int i = 1; i < m_replicas.size(); ++i)
+		delete m_replicas.at(i);
+}
+
+/*!
+ * \brief 创建副本
+ *
+ * 原DesignNetSpace应该已经执行过prepareProcess()，这样副本通过Processor::shareResources()
+ * 可以直接共享已经载入的资源。
+ */
+bool ReplicaBatch::createReplicas(int count)
+{
+	while (m_replicas.size() < count)
+	{
+		DesignNetSpace *replica = m_prototype->createReplica();
+		m_replicas << replica;
+		if (!replica->prepareProcess())
+			return false;
+	}
+	return true;
+}
+
+int ReplicaBatch::replicaCount() const
+{
+	return m_replicas.size();
+}
+
+DesignNetSpace* ReplicaBatch::replica(int index) const
+{
+	return m_replicas.value(index);
+}
+
+int ReplicaBatch::run(int inputCount)
+{
+	m_inputCount = inputCount;
+	m_next.store(0);
+	m_failures.store(0);
+	m_canceled.store(0);
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(m_replicas.size());
+	foreach (DesignNetSpace *replica, m_replicas)
+		pool.start(new Runner(this, replica));
+	pool.waitForDone();
+	return m_failures.load();
+}
+
+void ReplicaBatch::cancel()
+{
+	m_canceled.store(1);
+}
+
+bool ReplicaBatch::isCanceled() const
+{
+	return m_canceled.load() != 0;
+}
+
+}
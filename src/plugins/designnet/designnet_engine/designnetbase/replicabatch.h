@@ -0,0 +1,52 @@
+#ifndef REPLICABATCH_H
+#define REPLICABATCH_H
+
+#include "../designnet_core_global.h"
+#include <QAtomicInt>
+#include <QList>
+
+namespace DesignNet{
+
+class DesignNetSpace;
+
+/*!
+ * \brief 数据并行的批量执行
+ *
+ * 由一个DesignNetSpace通过DesignNetSpace::createReplica()创建若干副本，原DesignNetSpace作为第一个副本。
+ * 每个副本在自己的线程中依次领取下一个输入并执行，副本中的处理器仍然在ProcessorExecutor上执行，
+ * 因此一个输入内部的并行和多个输入之间的并行共用同一组工作线程。
+ *
+ * 子类实现processInput()把第\e index 个输入绑定到副本上并执行。
+ * processInput()在副本的线程中调用，不同副本的调用会同时发生。
+ */
+class DESIGNNET_CORE_EXPORT ReplicaBatch
+{
+public:
+	explicit ReplicaBatch(DesignNetSpace *prototype);
+	virtual ~ReplicaBatch();
+
+	bool createReplicas(int count);		//!< 副本总数为\e count ，包括原DesignNetSpace，新副本执行prepareProcess()失败时返回false
+	int replicaCount() const;
+	DesignNetSpace* replica(int index) const;
+
+	int run(int inputCount);			//!< 阻塞执行全部输入，返回失败的输入个数
+	void cancel();						//!< 不再领取新的输入，正在执行的输入会执行完
+	bool isCanceled() const;
+
+protected:
+	virtual bool processInput(DesignNetSpace *replica, int index) = 0;	//!< 执行第\e index 个输入，返回是否成功
+
+private:
+	class Runner;
+
+	DesignNetSpace*			m_prototype;
+	QList<DesignNetSpace*>	m_replicas;		//!< m_replicas[0]为m_prototype
+	QAtomicInt				m_next;			//!< 下一个待领取的输入
+	QAtomicInt				m_failures;
+	QAtomicInt				m_canceled;
+	int						m_inputCount;
+};
+
+}
+
+#endif // REPLICABATCH_H
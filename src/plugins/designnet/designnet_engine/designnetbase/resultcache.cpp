@@ -0,0 +1,604 @@
+#include "resultcache.h"
+#include "processor.h"
+#include "../data/imagedata.h"
+#include "../data/matpayload.h"
+#include "../data/matrixdata.h"
+#include "Utils/XML/xmlserializer.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStringList>
+#include <QtXml/QDomDocument>
+#include <limits.h>
+
+namespace DesignNet{
+
+static const quint32 CACHE_FILE_MAGIC	= 0x444E4352;	//!< "DNCR"
+static const quint32 CACHE_FILE_VERSION	= 2;			//!< 2：DataType中加入了DATATYPE_DOUBLE
+
+///
+/// 磁盘缓存中数据的种类
+enum PayloadKind
+{
+	PayloadKind_Variant,
+	PayloadKind_Mat,
+	PayloadKind_Image,
+	PayloadKind_Matrix
+};
+
+static void addString(QCryptographicHash &hash, const QString &str)
+{
+	const QByteArray bytes = str.toUtf8();
+	const qint32 size = bytes.size();
+	hash.addData((const char*)&size, sizeof(size));
+	hash.addData(bytes);
+}
+
+static void addInt(QCryptographicHash &hash, qint64 value)
+{
+	hash.addData((const char*)&value, sizeof(value));
+}
+
+static void addElement(QCryptographicHash &hash, const QDomElement &elem)
+{
+	///
+	/// QDom中属性的顺序不固定，按名称排序之后再计算
+	addString(hash, elem.tagName());
+	QDomNamedNodeMap attributes = elem.attributes();
+	QStringList names;
+	for (int i = 0; i < attributes.count(); i++)
+		names << attributes.item(i).nodeName();
+	names.sort();
+	addInt(hash, names.size());
+	foreach (const QString &name, names)
+	{
+		addString(hash, name);
+		addString(hash, elem.attribute(name));
+	}
+	for (QDomElement child = elem.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+		addElement(hash, child);
+	addInt(hash, -1);
+}
+
+static void addMat(QCryptographicHash &hash, const cv::Mat &mat)
+{
+	addInt(hash, mat.type());
+	addInt(hash, mat.dims);
+	for (int i = 0; i < mat.dims; i++)
+		addInt(hash, mat.size[i]);
+	if (mat.empty())
+		return;
+	if (mat.isContinuous())
+	{
+		hash.addData((const char*)mat.data, int(mat.total() * mat.elemSize()));
+		return;
+	}
+	const int rowBytes = int(mat.cols * mat.elemSize());
+	for (int r = 0; r < mat.rows; r++)
+		hash.addData((const char*)mat.ptr(r), rowBytes);
+}
+
+static bool isSimpleVariant(const QVariant &variant)
+{
+	return variant.userType() < int(QVariant::UserType);
+}
+
+static void writeMat(QDataStream &out, const cv::Mat &mat)
+{
+	out << qint32(mat.type()) << qint32(mat.rows) << qint32(mat.cols);
+	const int rowBytes = int(mat.cols * mat.elemSize());
+	for (int r = 0; r < mat.rows; r++)
+		out.writeRawData((const char*)mat.ptr(r), rowBytes);
+}
+
+static bool readMat(QDataStream &in, MatPayload &payload)
+{
+	qint32 type, rows, cols;
+	in >> type >> rows >> cols;
+	if (in.status() != QDataStream::Ok || rows < 0 || cols < 0 || type != CV_MAT_TYPE(type))
+		return false;
+	///
+	/// 大小和类型来自文件，先确认文件中还有这么多数据，损坏的文件不会申请过大的缓冲区
+	const qint64 rowBytes = qint64(cols) * CV_ELEM_SIZE(type);
+	if (rowBytes > INT_MAX || (rows > 0 && rowBytes > in.device()->bytesAvailable() / rows))
+		return false;
+	cv::Mat &mat = payload.create(rows, cols, type);
+	for (int r = 0; r < mat.rows; r++)
+	{
+		if (in.readRawData((char*)mat.ptr(r), int(rowBytes)) != rowBytes)
+			return false;
+	}
+	return true;
+}
+
+static qint64 payloadCost(const ProcessData &data)
+{
+	if (data.variant.userType() == qMetaTypeId<MatPayload>())
+		return qint64(data.variant.value<MatPayload>().byteSize());
+	if (data.variant.userType() == qMetaTypeId<IData*>())
+	{
+		IData *idata = data.variant.value<IData*>();
+		if (ImageData *image = qobject_cast<ImageData*>(idata))
+			return qint64(image->payload().byteSize());
+		if (MatrixData *matrix = qobject_cast<MatrixData*>(idata))
+			return qint64(matrix->payload().byteSize());
+	}
+	return 64;
+}
+
+ResultCache::Statistics::Statistics()
+	: hits(0), diskHits(0), misses(0), stores(0), evictions(0), memoryBytes(0)
+{
+}
+
+QAtomicPointer<ResultCache> ResultCache::m_instance;
+static QBasicMutex s_instanceMutex;	//!< 保护instance()中的创建
+
+ResultCache::ResultCache()
+	: m_iCapacity(512 * 1024 * 1024)
+{
+}
+
+ResultCache::~ResultCache()
+{
+	clear();
+}
+
+ResultCache* ResultCache::instance()
+{
+	///
+	/// 调度器的工作线程和designnet-run的主线程可能同时第一次调用
+	ResultCache *cache = m_instance.loadAcquire();
+	if (cache)
+		return cache;
+	QMutexLocker locker(&s_instanceMutex);
+	cache = m_instance.load();
+	if (!cache)
+	{
+		cache = new ResultCache;
+		m_instance.storeRelease(cache);
+	}
+	return cache;
+}
+
+void ResultCache::Release()
+{
+	QMutexLocker locker(&s_instanceMutex);
+	delete m_instance.fetchAndStoreOrdered(0);
+}
+
+bool ResultCache::restore( Processor *processor, QByteArray *key /*= 0*/ )
+{
+	///
+	/// 计算key之后的修改使恢复的结果过期，cacheRestored()不会清除m_bDataDirty
+	processor->beginRun();
+	const QByteArray k = this->key(processor);
+	if (key)
+		*key = k;
+	if (k.isEmpty())
+		return false;
+
+	///
+	/// 写输出端口会发出信号，锁内只复制结果，apply()在锁外调用
+	QList<Output> outputs;
+	bool bHit = false;
+	{
+		QMutexLocker locker(&m_mutex);
+		Entry *entry = m_entries.value(k, 0);
+		if (entry)
+		{
+			m_lru.erase(entry->lruPos);
+			entry->lruPos = m_lru.insert(m_lru.begin(), k);
+			m_statistics.hits++;
+			outputs = entry->outputs;
+			bHit = true;
+		}
+	}
+	if (!bHit)
+	{
+		const QString directory = diskDirectory();
+		Entry *entry = directory.isEmpty() ? 0 : loadFromDisk(directory, k);
+		QMutexLocker locker(&m_mutex);
+		if (!entry)
+		{
+			m_statistics.misses++;
+			return false;
+		}
+		m_statistics.diskHits++;
+		outputs = entry->outputs;
+		insert(k, entry);
+	}
+	apply(processor, k, outputs);
+	return true;
+}
+
+void ResultCache::store( Processor *processor, const QByteArray &key )
+{
+	if (key.isEmpty())
+		return;
+	foreach (Port* port, processor->getPorts(Port::OUT_PORT))
+		port->setDataHash(outputHash(key, port->name()));
+
+	Entry *entry = createEntry(processor);
+	const QString directory = diskDirectory();
+	if (!directory.isEmpty())
+		saveToDisk(directory, key, entry);
+
+	QMutexLocker locker(&m_mutex);
+	m_statistics.stores++;
+	insert(key, entry);
+}
+
+QByteArray ResultCache::key( Processor *processor )
+{
+	if (!processor->isCacheable() || processor->result().m_bNeedLoop)
+		return QByteArray();
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	addString(hash, processor->typeID().toString());
+	hash.addData(propertyHash(processor));
+
+	bool bHasInput = false;
+	foreach (Port* port, processor->getPorts(Port::IN_PORT))
+	{
+		addString(hash, port->name());
+		foreach (Port* src, port->connectedPorts())
+		{
+			const QByteArray h = inputHash(src);
+			if (h.isEmpty())
+				return QByteArray();
+			hash.addData(h);
+			bHasInput = true;
+		}
+		addInt(hash, -1);
+	}
+	///
+	/// 没有输入的处理器从外部读取数据，相同的属性不代表相同的结果
+	if (!bHasInput)
+		return QByteArray();
+	return hash.result();
+}
+
+void ResultCache::setMemoryCapacity( qint64 bytes )
+{
+	QMutexLocker locker(&m_mutex);
+	m_iCapacity = bytes;
+	evict();
+}
+
+qint64 ResultCache::memoryCapacity() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_iCapacity;
+}
+
+void ResultCache::setDiskDirectory( const QString &path )
+{
+	if (!path.isEmpty())
+		QDir().mkpath(path);
+	QMutexLocker locker(&m_mutex);
+	m_diskDirectory = path;
+}
+
+QString ResultCache::diskDirectory() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_diskDirectory;
+}
+
+void ResultCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	foreach (Entry *entry, m_entries)
+		deleteEntry(entry);
+	m_entries.clear();
+	m_lru.clear();
+	m_statistics.memoryBytes = 0;
+}
+
+ResultCache::Statistics ResultCache::statistics() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_statistics;
+}
+
+QByteArray ResultCache::payloadHash( const ProcessData &data )
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	addInt(hash, data.dataType);
+	const QVariant &variant = data.variant;
+	if (variant.userType() == qMetaTypeId<MatPayload>())
+	{
+		addMat(hash, variant.value<MatPayload>().mat());
+	}
+	else if (variant.userType() == qMetaTypeId<IData*>())
+	{
+		IData *idata = variant.value<IData*>();
+		if (ImageData *image = qobject_cast<ImageData*>(idata))
+		{
+			addInt(hash, image->imageType());
+			addMat(hash, image->payload().mat());
+		}
+		else if (MatrixData *matrix = qobject_cast<MatrixData*>(idata))
+			addMat(hash, matrix->payload().mat());
+		else if (idata)
+			return QByteArray();
+	}
+	else if (isSimpleVariant(variant))
+	{
+		addInt(hash, variant.userType());
+		addString(hash, variant.toString());
+	}
+	else
+		return QByteArray();
+	return hash.result();
+}
+
+QByteArray ResultCache::propertyHash( Processor *processor ) const
+{
+	///
+	/// 只使用属性，处理器的ID、名称以及位置不影响结果
+	Utils::XmlSerializer s;
+	processor->PropertyOwner::serialize(s);
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	addElement(hash, s.document().documentElement());
+	return hash.result();
+}
+
+QByteArray ResultCache::inputHash( Port *port ) const
+{
+	QByteArray h = port->dataHash();
+	if (!h.isEmpty())
+		return h;
+	///
+	/// 上游处理器没有使用缓存，按内容计算一次并保存在端口上
+	h = payloadHash(*port->data());
+	if (!h.isEmpty())
+		port->setDataHash(h);
+	return h;
+}
+
+QByteArray ResultCache::outputHash( const QByteArray &key, const QString &portName )
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(key);
+	addString(hash, portName);
+	return hash.result();
+}
+
+ResultCache::Entry* ResultCache::createEntry( Processor *processor ) const
+{
+	Entry *entry = new Entry;
+	entry->cost = 0;
+	foreach (Port* port, processor->getPorts(Port::OUT_PORT))
+	{
+		Output output;
+		output.name = port->name();
+		output.data = *port->data();
+		///
+		/// 处理器之后会修改自己的IData，缓存保存一份共享缓冲区的副本
+		if (output.data.variant.userType() == qMetaTypeId<IData*>())
+		{
+			IData *idata = output.data.variant.value<IData*>();
+			if (idata)
+				output.idata = QSharedPointer<IData>(idata->clone());
+			output.data.variant.setValue<IData*>(output.idata.data());
+		}
+		entry->cost += payloadCost(output.data);
+		entry->outputs << output;
+	}
+	return entry;
+}
+
+void ResultCache::deleteEntry( Entry *entry ) const
+{
+	delete entry;
+}
+
+void ResultCache::insert( const QByteArray &key, Entry *entry )
+{
+	Entry *old = m_entries.value(key, 0);
+	if (old)
+	{
+		m_lru.erase(old->lruPos);
+		m_statistics.memoryBytes -= old->cost;
+		deleteEntry(old);
+	}
+	entry->lruPos = m_lru.insert(m_lru.begin(), key);
+	m_entries.insert(key, entry);
+	m_statistics.memoryBytes += entry->cost;
+	evict();
+}
+
+void ResultCache::evict()
+{
+	while (m_statistics.memoryBytes > m_iCapacity && !m_lru.isEmpty())
+	{
+		const QByteArray key = m_lru.takeLast();
+		Entry *entry = m_entries.take(key);
+		m_statistics.memoryBytes -= entry->cost;
+		m_statistics.evictions++;
+		deleteEntry(entry);
+	}
+}
+
+void ResultCache::apply( Processor *processor, const QByteArray &key, const QList<Output> &outputs )
+{
+	foreach (const Output &output, outputs)
+	{
+		Port *port = processor->getPort(Port::OUT_PORT, output.name);
+		if (!port)
+			continue;
+		ProcessData data = output.data;
+		data.processorID = processor->id();
+		if (IData *cached = output.idata.data())
+		{
+			///
+			/// 端口上不能保存缓存拥有的IData，更新处理器原有的IData（共享缓冲区，不复制）；
+			/// 端口上没有相同类型的IData时使用以前为这个端口创建的IData，只在第一次命中时创建
+			IData *current = port->data()->variant.value<IData*>();
+			if (!current || current->id() != cached->id())
+			{
+				const QString name = QLatin1String("ResultCache:") + output.name;
+				current = processor->findChild<IData*>(name, Qt::FindDirectChildrenOnly);
+				if (current && current->id() != cached->id())
+				{
+					delete current;
+					current = 0;
+				}
+			}
+			if (current)
+				current->copy(cached);
+			else
+			{
+				current = cached->clone(processor);
+				current->setObjectName(QLatin1String("ResultCache:") + output.name);
+			}
+			data.variant.setValue<IData*>(current);
+		}
+		port->addData(&data);
+		port->setDataHash(outputHash(key, output.name));
+	}
+	processor->cacheRestored();
+}
+
+QString ResultCache::diskPath( const QString &directory, const QByteArray &key )
+{
+	return QDir(directory).filePath(QString::fromLatin1(key.toHex()) + QLatin1String(".dnc"));
+}
+
+bool ResultCache::saveToDisk( const QString &directory, const QByteArray &key, const Entry *entry ) const
+{
+	QSaveFile file(diskPath(directory, key));
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << CACHE_FILE_MAGIC << CACHE_FILE_VERSION << qint32(entry->outputs.size());
+	foreach (const Output &output, entry->outputs)
+	{
+		const ProcessData &data = output.data;
+		out << output.name << qint32(data.dataType) << qint32(data.m_iIndex);
+		if (data.variant.userType() == qMetaTypeId<MatPayload>())
+		{
+			const cv::Mat &mat = data.variant.value<MatPayload>().mat();
+			if (mat.dims > 2)
+			{
+				file.cancelWriting();
+				return false;
+			}
+			out << qint32(PayloadKind_Mat);
+			writeMat(out, mat);
+		}
+		else if (data.variant.userType() == qMetaTypeId<IData*>())
+		{
+			IData *idata = data.variant.value<IData*>();
+			ImageData *image = qobject_cast<ImageData*>(idata);
+			MatrixData *matrix = qobject_cast<MatrixData*>(idata);
+			const cv::Mat mat = image ? image->payload().mat() : (matrix ? matrix->payload().mat() : cv::Mat());
+			if ((!image && !matrix) || mat.dims > 2)
+			{
+				file.cancelWriting();
+				return false;
+			}
+			if (image)
+				out << qint32(PayloadKind_Image) << qint32(image->imageType());
+			else
+				out << qint32(PayloadKind_Matrix);
+			writeMat(out, mat);
+		}
+		else if (isSimpleVariant(data.variant))
+		{
+			out << qint32(PayloadKind_Variant) << data.variant;
+		}
+		else
+		{
+			file.cancelWriting();
+			return false;
+		}
+	}
+	if (out.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+ResultCache::Entry* ResultCache::loadFromDisk( const QString &directory, const QByteArray &key ) const
+{
+	QFile file(diskPath(directory, key));
+	if (!file.open(QIODevice::ReadOnly))
+		return 0;
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic, version;
+	qint32 count;
+	in >> magic >> version >> count;
+	if (magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION || count < 0)
+		return 0;
+
+	Entry *entry = new Entry;
+	entry->cost = 0;
+	for (int i = 0; i < count; i++)
+	{
+		QString name;
+		qint32 dataType, index, kind;
+		in >> name >> dataType >> index >> kind;
+		ProcessData data(DataType(dataType));
+		data.m_iIndex = index;
+
+		bool bOk = in.status() == QDataStream::Ok;
+		///
+		/// 直接读入MatBufferPool的缓冲区，再由数据共享，不再复制
+		MatPayload payload;
+		switch (kind)
+		{
+		case PayloadKind_Variant:
+			in >> data.variant;
+			break;
+		case PayloadKind_Mat:
+			bOk = bOk && readMat(in, payload);
+			data.variant.setValue(payload);
+			break;
+		case PayloadKind_Image:
+			{
+				qint32 imageType;
+				in >> imageType;
+				bOk = bOk && readMat(in, payload);
+				ImageData *image = new ImageData(imageType);
+				image->setPayload(payload);
+				data.variant.setValue<IData*>(image);
+			}
+			break;
+		case PayloadKind_Matrix:
+			{
+				bOk = bOk && readMat(in, payload);
+				MatrixData *matrix = new MatrixData;
+				matrix->setPayload(payload);
+				data.variant.setValue<IData*>(matrix);
+			}
+			break;
+		default:
+			bOk = false;
+		}
+		Output output;
+		output.name = name;
+		output.data = data;
+		if (data.variant.userType() == qMetaTypeId<IData*>())
+			output.idata = QSharedPointer<IData>(data.variant.value<IData*>());
+		entry->cost += payloadCost(data);
+		entry->outputs << output;
+		if (!bOk || in.status() != QDataStream::Ok)
+		{
+			deleteEntry(entry);
+			return 0;
+		}
+	}
+	return entry;
+}
+
+}
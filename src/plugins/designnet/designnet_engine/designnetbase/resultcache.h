@@ -0,0 +1,107 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "../designnet_core_global.h"
+#include "port.h"
+#include <QAtomicPointer>
+#include <QByteArray>
+#include <QHash>
+#include <QLinkedList>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+namespace DesignNet{
+
+class Processor;
+
+/*!
+ * \brief 处理器结果缓存
+ *
+ * 缓存的键是处理器类型ID、全部属性序列化之后的内容以及所有输入数据哈希的SHA1，
+ * 键相同的处理器直接把缓存的数据写到输出端口，不再调用process()。
+ * 输出端口的哈希由键和端口名称得到，下游处理器计算键时不需要再读取图像数据。
+ *
+ * 内存中按最近使用顺序淘汰，总大小不超过memoryCapacity()；设置diskDirectory()之后
+ * 结果同时保存到磁盘，内存中淘汰的结果以及之后的进程都可以从磁盘读取。
+ *
+ * 没有输入的处理器（数据来自外部）、要求继续执行的处理器以及Processor::isCacheable()
+ * 返回false的处理器不使用缓存。
+ */
+class DESIGNNET_CORE_EXPORT ResultCache
+{
+public:
+	struct Statistics
+	{
+		Statistics();
+		qint64	hits;			//!< 内存命中次数
+		qint64	diskHits;		//!< 磁盘命中次数
+		qint64	misses;			//!< 未命中次数
+		qint64	stores;			//!< 保存次数
+		qint64	evictions;		//!< 从内存中淘汰的次数
+		qint64	memoryBytes;	//!< 内存中缓存的字节数
+	};
+
+	static ResultCache* instance();
+	static void Release();
+
+	bool restore(Processor *processor, QByteArray *key = 0);	//!< 命中时把结果写到输出端口，\e key 返回本次使用的键
+	void store(Processor *processor, const QByteArray &key);	//!< 保存处理器刚刚产生的结果
+	QByteArray key(Processor *processor);						//!< 不能缓存时返回空
+
+	void setMemoryCapacity(qint64 bytes);
+	qint64 memoryCapacity() const;
+	void setDiskDirectory(const QString &path);	//!< 为空时不使用磁盘缓存
+	QString diskDirectory() const;
+
+	void clear();								//!< 清空内存中的缓存
+	Statistics statistics() const;
+
+	static QByteArray payloadHash(const ProcessData &data);	//!< 按内容计算数据的哈希，不支持的数据类型返回空
+
+protected:
+	struct Output
+	{
+		QString					name;	//!< 输出端口名称
+		ProcessData				data;	//!< IData类型时variant中的指针与idata相同
+		QSharedPointer<IData>	idata;	//!< 缓存拥有的IData，apply()期间条目被淘汰也不会被删除
+	};
+
+	struct Entry
+	{
+		QList<Output>	outputs;
+		qint64			cost;
+		QLinkedList<QByteArray>::iterator lruPos;
+	};
+
+	ResultCache();
+	~ResultCache();
+
+	QByteArray propertyHash(Processor *processor) const;
+	QByteArray inputHash(Port *port) const;
+	static QByteArray outputHash(const QByteArray &key, const QString &portName);
+
+	Entry* createEntry(Processor *processor) const;
+	void deleteEntry(Entry *entry) const;
+	void insert(const QByteArray &key, Entry *entry);
+	void evict();
+	static void apply(Processor *processor, const QByteArray &key, const QList<Output> &outputs);	//!< 不持有m_mutex调用
+
+	static QString diskPath(const QString &directory, const QByteArray &key);
+	bool saveToDisk(const QString &directory, const QByteArray &key, const Entry *entry) const;
+	Entry* loadFromDisk(const QString &directory, const QByteArray &key) const;
+
+	static QAtomicPointer<ResultCache>	m_instance;
+
+	mutable QMutex				m_mutex;
+	QHash<QByteArray, Entry*>	m_entries;
+	QLinkedList<QByteArray>		m_lru;			//!< 头部是最近使用的键
+	qint64						m_iCapacity;
+	QString						m_diskDirectory;
+	Statistics					m_statistics;
+};
+
+}
+
+#endif // RESULTCACHE_H
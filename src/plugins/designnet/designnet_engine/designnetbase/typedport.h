@@ -0,0 +1,179 @@
+#ifndef TYPEDPORT_H
+#define TYPEDPORT_H
+
+#include "port.h"
+#include "processor.h"
+#include "../data/matpayload.h"
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+namespace DesignNet{
+
+/*!
+ * \brief 端口类型表
+ *
+ * 每个C++类型对应的DataType（与未声明类型的端口比较时使用），
+ * 以及输入端口可以接收的输出类型。两端都声明了类型时，Port::canConnectTo()只查这张表，
+ * 不再调用Processor::connectionTest()。新的类型需要Q_DECLARE_METATYPE，必要时特化本模板。
+ * 没有特化的类型为DATATYPE_USERTYPE，只能连接到声明了类型的端口。
+ */
+template<class T>
+struct PortTypeTraits
+{
+	static DataType dataType() { return DATATYPE_USERTYPE; }
+	static QVector<int> acceptedTypes() { return QVector<int>() << qMetaTypeId<T>(); }
+};
+
+template<>
+struct PortTypeTraits<int>
+{
+	static DataType dataType() { return DATATYPE_INT; }
+	static QVector<int> acceptedTypes() { return QVector<int>() << QMetaType::Int << QMetaType::Bool; }
+};
+
+template<>
+struct PortTypeTraits<double>
+{
+	static DataType dataType() { return DATATYPE_DOUBLE; }
+	static QVector<int> acceptedTypes() { return QVector<int>() << QMetaType::Double << QMetaType::Float << QMetaType::Int; }
+};
+
+template<>
+struct PortTypeTraits<QString>
+{
+	static DataType dataType() { return DATATYPE_STRING; }
+	static QVector<int> acceptedTypes() { return QVector<int>() << QMetaType::QString; }
+};
+
+template<>
+struct PortTypeTraits<MatPayload>
+{
+	static DataType dataType() { return DATATYPE_MATRIX; }
+	static QVector<int> acceptedTypes() { return QVector<int>() << qMetaTypeId<MatPayload>(); }
+};
+
+/*!
+ * \brief 端口中类型为\e T 的数据
+ */
+template<class T>
+class TypedPortValue : public PortValue
+{
+public:
+	TypedPortValue() : PortValue(qMetaTypeId<T>()), value() {}
+	QVariant toVariant() const { return QVariant::fromValue(value); }
+	bool fromVariant(const QVariant &variant)
+	{
+		if (!variant.canConvert<T>())
+			return false;
+		value = variant.value<T>();
+		return true;
+	}
+	void clear() { value = T(); }
+
+	T value;
+};
+
+/*!
+ * \brief 静态类型的输出端口
+ *
+ * 作为处理器的成员在构造函数中创建，例如：
+ * \code
+ * MeanProcessor(DesignNetSpace *space) : Processor(space), m_image(this, "Image"), m_mean(this, "Mean") {}
+ * ...
+ * InputPort<MatPayload>	m_image;
+ * OutputPort<double>		m_mean;
+ * \endcode
+ * push()直接写入端口，连接到InputPort<T>的下游处理器直接读取，不装箱为QVariant。
+ */
+template<class T>
+class OutputPort
+{
+public:
+	OutputPort(Processor *processor, const QString &label)
+		: m_value(new TypedPortValue<T>)
+	{
+		processor->addPort(Port::OUT_PORT, PortTypeTraits<T>::dataType(), label);
+		m_port = processor->getPorts(Port::OUT_PORT).last();
+		m_port->setTypedValue(m_value);
+	}
+
+	void push(const T &value)		//!< 写入新的数据
+	{
+		m_value->value = value;
+		m_port->commitValue();
+	}
+	T& value() { return m_value->value; }	//!< 原地写入，完成后调用commit()
+	void commit() { m_port->commitValue(); }
+	Port* port() const { return m_port; }
+
+private:
+	Port*				m_port;
+	TypedPortValue<T>*	m_value;	//!< 由m_port所有
+};
+
+/*!
+ * \brief 静态类型的输入端口
+ *
+ * value()在上游是相同类型的OutputPort<T>时直接返回上游端口中数据的指针；
+ * 上游是未声明类型的端口或者流水线执行时从ProcessData中读取，类型相同时也不复制。
+ * 只有类型表中允许的其它类型（例如int连接到double）才需要转换。
+ */
+template<class T>
+class InputPort
+{
+public:
+	InputPort(Processor *processor, const QString &label, bool bMultiInput = false)
+		: m_processor(processor),
+		m_iSlot(processor->getPorts(Port::IN_PORT).size()),
+		m_iTypeId(qMetaTypeId<T>())
+	{
+		processor->addPort(Port::IN_PORT, PortTypeTraits<T>::dataType(), label);
+		m_port = processor->getPorts(Port::IN_PORT).last();
+		m_port->setMultiInputSupported(bMultiInput);
+		m_port->setTypeInfo(m_iTypeId, PortTypeTraits<T>::acceptedTypes());
+	}
+
+	int count() const { return m_processor->inputDataCount(m_iSlot); }	//!< 数据的份数，多输入端口可以大于1
+	const T* value(int i = 0)	//!< 第\e i 份数据，没有数据或者类型不能转换时返回0
+	{
+		ProcessData *pd = 0;
+		if (m_port->hasStagedData())
+			pd = m_port->stagedData(i);
+		else
+		{
+			Port *src = m_processor->inputSource(m_iSlot, i);
+			if (!src)
+				return 0;
+			if (src->typeId() == m_iTypeId && src->typedValue())
+				return &static_cast<TypedPortValue<T>*>(src->typedValue())->value;
+			pd = src->data();
+		}
+		if (!pd)
+			return 0;
+		if (pd->variant.userType() == m_iTypeId)
+			return static_cast<const T*>(pd->variant.constData());
+		if (!pd->variant.canConvert<T>())
+			return 0;
+		m_converted = pd->variant.value<T>();
+		return &m_converted;
+	}
+	T valueOr(const T &defaultValue = T(), int i = 0)
+	{
+		const T *v = value(i);
+		return v ? *v : defaultValue;
+	}
+	int slot() const { return m_iSlot; }
+	Port* port() const { return m_port; }
+
+private:
+	Processor*	m_processor;
+	Port*		m_port;
+	int			m_iSlot;		//!< 在处理器构造函数中创建，之前的输入端口不会被移除
+	int			m_iTypeId;
+	T			m_converted;	//!< 需要转换类型时的结果，只在处理器的执行线程中使用
+};
+
+}
+
+#endif // TYPEDPORT_H
@@ -14,6 +14,7 @@ const char GRAPHICS_DESIGNNET_ID[]  = "Editor.DesignNet";
 const char NETEDITOR_ID[]           = "DesignNet.DesignNetEditor";
 const char NETEDITOREDITOR_DISPLAYNAME[] = QT_TRANSLATE_NOOP("OpenWith::Editors","DesignNet Editor");
 const char NETEDITOR_FILETYPE[]     = "txt";
+const char NETEDITOR_BINARY_FILETYPE[] = "dnb";	//!< 二进制格式，由Utils::BinarySerializer保存
 const char DEFAULT_DOCK_AREA[]      = "DesignNet.DefaultDockArea";
 
 const char DESIGNNET_MODE[]         = "Mode.DesignNetMode";
@@ -26,6 +27,8 @@ const char DESIGNNET_PROCESS_ID[]   = "DesignNet.Process";
 const char DESIGNNET_EDITSTATE_MOVE_ACTION[]	= "DesignNet.EditState.Move";
 const char DESIGNNET_EDITSTATE_LINK_ACTION[]	= "DesignNet.EditState.Link";
 const char DESIGNNET_EDITSTATE_RELAYOUT_ACTION[] = "DesignNet.EditState.Relayout";
+const char DESIGNNET_PROFILE_ACTION[]			= "DesignNet.Profile";
+const char DESIGNNET_EXPORT_TRACE_ACTION[]		= "DesignNet.ExportTrace";
 /// DockWidget Name
 const char DESIGN_DOCKNAME_TOOL[]       = "DockName.Tools";
 const char DESIGN_DOCKNAME_PROPERTY[]   = "DockName.Properties";
@@ -0,0 +1,48 @@
+#include "designnetcoreplugin.h"
+#include <QtPlugin>
+#include "data/matbufferpool.h"
+#include "designnetbase/processorexecutor.h"
+#include "designnetbase/processorfactory.h"
+#include "designnetbase/processorprofiler.h"
+#include "designnetbase/resultcache.h"
+
+
+using namespace ExtensionSystem;
+namespace DesignNet{
+
+DesignNetEnginePlugin::DesignNetEnginePlugin()
+{
+}
+
+DesignNetEnginePlugin::~DesignNetEnginePlugin()
+{
+	ProcessorExecutor::Release();
+	ResultCache::Release();
+	ProcessorProfiler::Release();
+	MatBufferPool::Release();
+}
+
+bool DesignNetEnginePlugin::initialize( const QStringList &arguments, QString *errorMessage /*= 0*/ )
+{
+	Q_UNUSED(arguments)
+	Q_UNUSED(errorMessage)
+	addAutoReleasedObject(new ProcessorFactory(this));
+	return true;
+}
+
+void DesignNetEnginePlugin::extensionsInitialized()
+{
+	
+}
+
+bool DesignNetEnginePlugin::delayedInitialize()
+{
+	return true;
+}
+
+IPlugin::ShutdownFlag DesignNetEnginePlugin::aboutToShutdown()
+{
+	return IPlugin::SynchronousShutdown;
+}
+
+}
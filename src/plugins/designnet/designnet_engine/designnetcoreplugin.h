@@ -4,27 +4,27 @@
 #include "designnet_core_global.h"
 #include "extensionsystem/iplugin.h"
 namespace DesignNet{
-class DesignNetCorePluginPrivate;
-class DesignNetCorePlugin : public ExtensionSystem::IPlugin
+
+/*!
+ * \brief 执行引擎插件
+ *
+ * 只提供处理器、调度器和数据类型，不创建界面，也不登记编辑器（.txt文件由designnet_core打开），
+ * 可以在designnet-run等无界面程序中载入。
+ */
+class DesignNetEnginePlugin : public ExtensionSystem::IPlugin
 {
 	Q_OBJECT
-	Q_PLUGIN_METADATA(IID "com.michaelmiao.totem.DesignNetCorePlugin")
+	Q_PLUGIN_METADATA(IID "com.totem.plugins.designnet.engine")
 	Q_INTERFACES(ExtensionSystem::IPlugin)
 
 public:
 
-	DesignNetCorePlugin();
-	~DesignNetCorePlugin();
+	DesignNetEnginePlugin();
+	~DesignNetEnginePlugin();
 	bool initialize(const QStringList &arguments, QString *errorMessage = 0);
 	void extensionsInitialized();
 	bool delayedInitialize();
 	ShutdownFlag aboutToShutdown();
-
-public slots:
-	void writeSettings();
-
-private:
-	DesignNetCorePluginPrivate *d;
 };
 
 }
@@ -3,10 +3,13 @@
 
 #include "designnetconstants.h"
 #include "designnetspace.h"
-#include "Utils/XML/xmlserializer.h"
-#include "Utils/XML/xmldeserializer.h"
+#include "Utils/XML/binarydeserializer.h"
+#include "Utils/XML/binaryserializer.h"
+#include "Utils/XML/xmlstreamdeserializer.h"
+#include "Utils/XML/xmlstreamserializer.h"
 #include "Utils/XML/xmlserializable.h"
 #include <QFileInfo>
+#include <QScopedPointer>
 using namespace Core;
 namespace DesignNet{
 
@@ -115,12 +118,25 @@ bool DesignNetDocument::reload(QString *errorString, IDocument::ReloadFlag flag,
     return d->editor->open(errorString, d->fileName, d->fileName);
 }
 
+/*!
+ * \brief 保存文件
+ *
+ * 后缀为Constants::NETEDITOR_BINARY_FILETYPE时保存为二进制格式，否则通过Utils::XmlStreamSerializer直接写XML。
+ */
 bool DesignNetDocument::save(QString *errorString, const QString &fileName, bool autoSave)
 {
-	Utils::XmlSerializer x;
-	x.serialize("DesignNetSpace", *(d->space));
-	emit serialized(x);
-	x.write(fileName);
+	const QString saveFileName = fileName.isEmpty() ? d->fileName : fileName;
+	const bool bBinary = QFileInfo(saveFileName).suffix().compare(QLatin1String(Constants::NETEDITOR_BINARY_FILETYPE), Qt::CaseInsensitive) == 0;
+	QScopedPointer<Utils::XmlSerializer> x(bBinary ? new Utils::BinarySerializer
+		: new Utils::XmlStreamSerializer(saveFileName));
+	x->serialize("DesignNetSpace", *(d->space));
+	emit serialized(*x);
+	if (!x->write(saveFileName))
+	{
+		if (errorString)
+			*errorString = tr("Cannot write %1.").arg(saveFileName);
+		return false;
+	}
 	setModified(false);
     return true;
 }
@@ -141,9 +157,27 @@ bool DesignNetDocument::open( QString *errorString, const QString &fileName, con
 	m_bOpening = true;
 	bool bRet = IDocument::open(errorString, fileName, realFileName);
 	d->space->setObjectName(realFileName);
-	Utils::XmlDeserializer deserializer(realFileName);
-	deserializer.deserialize("DesignNetSpace", *(d->space));
-	emit deserialized(deserializer);
+	///
+	/// 根据文件头判断格式，与后缀无关
+	QScopedPointer<Utils::XmlDeserializer> deserializer;
+	if (Utils::BinaryDeserializer::isBinaryFile(realFileName))
+	{
+		Utils::BinaryDeserializer *binary = new Utils::BinaryDeserializer(realFileName);
+		deserializer.reset(binary);
+		if (!binary->isValid())
+		{
+			if (errorString)
+				*errorString = binary->errorString();
+			m_bOpening = false;
+			return false;
+		}
+	}
+	else
+	{
+		deserializer.reset(new Utils::XmlStreamDeserializer(realFileName));
+	}
+	deserializer->deserialize("DesignNetSpace", *(d->space));
+	emit deserialized(*deserializer);
 	m_bOpening = false;
 	return bRet;
 }
@@ -144,8 +144,13 @@ void DesignNetEditor::createCommand()
 
 bool DesignNetEditor::run()
 {
+	///
+	/// һִеĽѾʱٴִУֹͣǵִ
 	if (d->m_file->designNetSpace()->isRunning())
-		return false;
+	{
+		d->m_file->designNetSpace()->cancel();
+		d->m_file->designNetSpace()->waitForFinish();
+	}
 
 	QFutureWatcher<bool> bWatcher;
 	bWatcher.setFuture(QtConcurrent::run(d->m_file->designNetSpace(), &DesignNetSpace::prepareProcess));
@@ -18,7 +18,7 @@ public:
 
 DesignNetEditorFactoryPrivate::DesignNetEditorFactoryPrivate()
 {
-	m_suffixList << _T(Constants::NETEDITOR_FILETYPE);
+	m_suffixList << _T(Constants::NETEDITOR_FILETYPE) << _T(Constants::NETEDITOR_BINARY_FILETYPE);
 }
 
 DesignNetEditorFactoryPrivate::~DesignNetEditorFactoryPrivate()
@@ -1,5 +1,6 @@
 #include "designnetformmanager.h"
 #include <QAction>
+#include <QFileDialog>
 #include <QMessageBox>
 #include <QPushButton>
 #include <QStyle>
@@ -18,6 +19,7 @@
 #include "designnetmainwindow.h"
 #include "designnetmode.h"
 #include "designnetview.h"
+#include "designnetbase/processorprofiler.h"
 
 
 
@@ -175,6 +177,19 @@ void DesignNetFormManager::setupActions()
 	pCommand->setAttribute(Core::Command::CA_Hide);
 
 	QObject::connect(pAction, SIGNAL(triggered()), this, SLOT(onRelayout()));
+
+	d->m_toolActionIds.push_back(Core::Id(Constants::DESIGNNET_PROFILE_ACTION));
+	pAction = new QAction(QApplication::style()->standardIcon(QStyle::SP_FileDialogDetailedView), tr("Profile Processors"), this);
+	pAction->setCheckable(true);
+	pCommand = Core::ActionManager::registerAction(pAction, d->m_toolActionIds.back(), d->m_context);
+	pCommand->setAttribute(Core::Command::CA_Hide);
+	QObject::connect(pAction, SIGNAL(toggled(bool)), this, SLOT(onProfile(bool)));
+
+	d->m_toolActionIds.push_back(Core::Id(Constants::DESIGNNET_EXPORT_TRACE_ACTION));
+	pAction = new QAction(QApplication::style()->standardIcon(QStyle::SP_DialogSaveButton), tr("Export Timeline..."), this);
+	pCommand = Core::ActionManager::registerAction(pAction, d->m_toolActionIds.back(), d->m_context);
+	pCommand->setAttribute(Core::Command::CA_Hide);
+	QObject::connect(pAction, SIGNAL(triggered()), this, SLOT(onExportTrace()));
 }
 
 void DesignNetFormManager::addToolAction( QAction* pAction, const Core::Context& context, const Core::Id &id, Core::ActionContainer *pContainer, const QString& keySequence )
@@ -202,6 +217,32 @@ void DesignNetFormManager::onDesignNetFinished()
 	pRun->action()->setDisabled(false);
 }
 
+void DesignNetFormManager::onProfile( bool bEnabled )
+{
+	ProcessorProfiler *profiler = ProcessorProfiler::instance();
+	if (bEnabled)
+		profiler->clear();
+	profiler->setEnabled(bEnabled);
+}
+
+void DesignNetFormManager::onExportTrace()
+{
+	ProcessorProfiler *profiler = ProcessorProfiler::instance();
+	if (profiler->records().isEmpty())
+	{
+		QMessageBox::information(d->m_mainWindow, tr("Export Timeline"),
+			tr("There is no record. Enable profiling and run the designnet space first."));
+		return;
+	}
+	const QString fileName = QFileDialog::getSaveFileName(d->m_mainWindow, tr("Export Timeline"),
+		QString(), tr("Chrome Trace (*.json)"));
+	if (fileName.isEmpty())
+		return;
+	QString errorString;
+	if (!profiler->exportChromeTrace(fileName, &errorString))
+		QMessageBox::warning(d->m_mainWindow, tr("Export Timeline"), tr("Cannot write %1: %2").arg(fileName).arg(errorString));
+}
+
 void DesignNetFormManager::onRelayout()
 {
 	DesignNetEditor *pEditor = qobject_cast<DesignNetEditor *>(Core::EditorManager::instance()->currentEditor());
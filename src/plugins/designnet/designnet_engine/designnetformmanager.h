@@ -37,6 +37,8 @@ public slots:
 	void onRunDesignNet();
 	void onDesignNetFinished();
 	void onRelayout();
+	void onProfile(bool bEnabled);	//!< /ֹͣ¼ִʱ
+	void onExportTrace();			//!< Chrome trace-eventʽʱ
 
 protected:
 	void setupActions();
@@ -16,6 +16,7 @@
 #include "../../coreplugin/messagemanager.h"
 #include "designnetbase/processor.h"
 #include "designnetbase/processorfactory.h"
+#include "designnetbase/processorprofiler.h"
 #include "graphicsitem/blocktextitem.h"
 #include "graphicsitem/portarrowlink.h"
 #include "graphicsitem/portitem.h"
@@ -94,6 +95,8 @@ public:
 	~DesignNetViewPrivate();
 	DesignNetSpace*								m_designnetSpace;
 	QMap<Processor*, ProcessorGraphicsBlock*>	m_processorMaps;
+	QHash<int, ProcessorGraphicsBlock*>			m_blocksById;	//!< idַProcessorProfiler::recorded()
+	qint64										m_iMaximumLastTime;	//!< һλʱProcessorProfiler::maximumLastTime()
 	QList<ProcessorArrowLink*>					m_links;
 	ProcessorGraphicsBlock*						m_tempProcessor;
 	ProcessorGraphicsBlock*						m_srcProcessor;
@@ -106,6 +109,7 @@ DesignNetViewPrivate::DesignNetViewPrivate()
 	m_tempProcessor = 0;
 	m_lineItem = 0;
 	m_srcProcessor = 0;
+	m_iMaximumLastTime = -1;
 }
 
 DesignNetViewPrivate::~DesignNetViewPrivate()
@@ -144,6 +148,12 @@ DesignNetView::DesignNetView(DesignNetSpace *space, QWidget *parent)
 		QObject::connect(space, SIGNAL(connectionAdded(Processor*, Processor*)), this, SLOT(onConnectionAdded(Processor*, Processor*)));
 		QObject::connect(space, SIGNAL(connectionRemoved(Processor*, Processor*)), this, SLOT(onConnectionAdded(Processor*, Processor*)));
 	}
+	///
+	/// ÿͼֻһΣÿͼԪֱ
+	ProcessorProfiler *profiler = ProcessorProfiler::instance();
+	QObject::connect(profiler, SIGNAL(recorded(int)), this, SLOT(onProfileRecorded(int)));
+	QObject::connect(profiler, SIGNAL(cleared()), this, SLOT(onProfileReset()));
+	QObject::connect(profiler, SIGNAL(enabledChanged(bool)), this, SLOT(onProfileReset()));
 }
 
 DesignNetView::~DesignNetView()
@@ -383,6 +393,7 @@ void DesignNetView::mouseReleaseEvent( QMouseEvent * event )
 void DesignNetView::addProcessor(ProcessorGraphicsBlock *processor)
 {
 	d->m_processorMaps[processor->processor()] = processor;
+	d->m_blocksById.insert(processor->processor()->id(), processor);
 	QObject::connect(processor, SIGNAL(closed()), this, SLOT(processorClosed()));
 	QObject::connect(processor, SIGNAL(portVisibleChanged(bool, int)), this, SLOT(processorPortVisibleChanged(bool, int)));
 }
@@ -529,6 +540,28 @@ void DesignNetView::OnShowMessage( const QString &strMessage )
 	Core::ICore::messageManager()->printToOutputPanePopup(sender()->objectName() + ": " + strMessage);
 }
 
+void DesignNetView::onProfileRecorded( int processorId )
+{
+	if (ProcessorGraphicsBlock *pBlock = d->m_blocksById.value(processorId))
+		pBlock->onProfileUpdated();
+	///
+	/// ʱĴʱ仯ʱҲҪػ
+	ProcessorProfiler *profiler = ProcessorProfiler::active();
+	const qint64 maximum = profiler ? profiler->maximumLastTime() : -1;
+	if (maximum == d->m_iMaximumLastTime)
+		return;
+	d->m_iMaximumLastTime = maximum;
+	foreach (ProcessorGraphicsBlock *pBlock, d->m_processorMaps)
+		pBlock->update();
+}
+
+void DesignNetView::onProfileReset()
+{
+	d->m_iMaximumLastTime = -1;
+	foreach (ProcessorGraphicsBlock *pBlock, d->m_processorMaps)
+		pBlock->onProfileUpdated();
+}
+
 void DesignNetView::onProcessorAdded(Processor* processor)
 {
 	ProcessorGraphicsBlock *pBlock = new ProcessorGraphicsBlock(processor, scene(), this);
@@ -544,6 +577,8 @@ void DesignNetView::onProcessorRemoved( Processor* processor )
 	{
 		ProcessorGraphicsBlock* p = itr.value();
 		d->m_processorMaps.erase(itr);
+		if (d->m_blocksById.value(processor->id()) == p)
+			d->m_blocksById.remove(processor->id());
 		scene()->removeItem(p);
 		delete p;
 	}
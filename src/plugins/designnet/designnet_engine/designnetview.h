@@ -73,6 +73,9 @@ public slots:
 	void reloadSpace();
 	void OnShowMessage(const QString &strMessage);
 
+	void onProfileRecorded(int processorId);	//!< ֻ¶ӦĴʱ仯ʱػд
+	void onProfileReset();						//!< ܼ¼߿أд
+
 protected:
 
 	virtual void mouseMoveEvent ( QMouseEvent * event );
@@ -20,6 +20,7 @@
 #include "../../../coreplugin/messagemanager.h"
 #include "../data/matrixdata.h"
 #include "../designnetbase/processorconfigmanager.h"
+#include "../designnetbase/processorprofiler.h"
 #include "../graphicsitem/blocktextitem.h"
 #include "../property/property.h"
 #include "../widgets/processorconfigwidget.h"
@@ -228,6 +229,37 @@ void ProcessorGraphicsBlock::paint(QPainter* painter,
 	QPixmap iconPixmap = m_processor->icon().pixmap(16, 16);
 	QRectF rcIcon(-iconPixmap.width() / 2, -iconPixmap.height() / 2, iconPixmap.width(), iconPixmap.height());
 	painter->drawImage(rcIcon, iconPixmap.toImage());
+	paintProfile(painter, rcBounding);
+}
+
+/*!
+ * \brief 性能记录启用时，在边框上绘制最近一次执行时间相对于网络中最慢处理器的比例
+ *
+ * 圆弧长度和颜色（绿到红）表示比例，下方显示耗时。
+ */
+void ProcessorGraphicsBlock::paintProfile( QPainter* painter, const QRectF &rcBounding )
+{
+	ProcessorProfiler *profiler = ProcessorProfiler::active();
+	ProcessorProfiler::Record record;
+	if (!profiler || !profiler->lastRecord(m_processor, &record))
+		return;
+	const qint64 maximum = profiler->maximumLastTime();
+	const qreal ratio = maximum > 0 ? qreal(record.totalTime()) / qreal(maximum) : 0;
+
+	painter->save();
+	QPen pen(QColor::fromHsvF((1.0 - ratio) / 3.0, 0.9, 0.95), 4);
+	pen.setCapStyle(Qt::FlatCap);
+	painter->setPen(pen);
+	painter->drawArc(rcBounding.adjusted(2, 2, -2, -2), 90 * 16, -qRound(ratio * 360 * 16));
+
+	QFont font = painter->font();
+	font.setPointSizeF(7);
+	painter->setFont(font);
+	painter->setPen(Qt::white);
+	const QRectF rcText(rcBounding.left(), 9, rcBounding.width(), rcBounding.bottom() - 9);
+	painter->drawText(rcText, Qt::AlignHCenter | Qt::AlignTop,
+		QString::number(record.totalTime() / 1000.0, 'f', record.totalTime() < 10000 ? 2 : 1) + tr("ms"));
+	painter->restore();
 }
 
 void ProcessorGraphicsBlock::hoverEnterEvent( QGraphicsSceneHoverEvent * event )
@@ -556,6 +588,35 @@ void ProcessorGraphicsBlock::onProcessFinished()
 {
 }
 
+void ProcessorGraphicsBlock::onProfileUpdated()
+{
+	ProcessorProfiler *profiler = ProcessorProfiler::active();
+	ProcessorProfiler::Record record;
+	if (!profiler || !profiler->lastRecord(m_processor, &record))
+	{
+		setToolTip(QString());
+		update();
+		return;
+	}
+	setToolTip(tr("%1 (%2)\n"
+		"Queued: %3 ms\n"
+		"beforeProcess: %4 ms\n"
+		"process: %5 ms\n"
+		"afterProcess: %6 ms\n"
+		"Thread: %7\n"
+		"Input: %8 KB, output: %9 KB\n"
+		"Peak Mat memory: %10 KB")
+		.arg(m_processor->name()).arg(m_processor->id())
+		.arg(record.queueWait() / 1000.0, 0, 'f', 2)
+		.arg(record.beforeProcessTime() / 1000.0, 0, 'f', 2)
+		.arg(record.processTime() / 1000.0, 0, 'f', 2)
+		.arg(record.afterProcessTime() / 1000.0, 0, 'f', 2)
+		.arg(record.threadIndex)
+		.arg(record.bytesIn / 1024).arg(record.bytesOut / 1024)
+		.arg(record.peakMatBytes / 1024));
+	update();
+}
+
 void ProcessorGraphicsBlock::onAddPort(Port* port)
 {
 	PortItem* portItem = new PortItem(port, this);
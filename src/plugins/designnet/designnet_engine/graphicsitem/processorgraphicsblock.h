@@ -142,6 +142,7 @@ public slots:
 
 	void onProcessStarted();
 	void onProcessFinished();
+	void onProfileUpdated();	//!< 性能记录有变化，更新时间比例和提示，由DesignNetView分发
 
 	void onAddPort(Port*);			//!< process添加Port的槽
 	void onClickAddPort();		//!< Action Clicked了
@@ -170,6 +171,7 @@ protected:
 
 	void setLayoutDirty(const bool &dirty = true);				//!< 设置是否需要重新计算布局
 	void showStatus(const QString &msg);
+	void paintProfile(QPainter* painter, const QRectF &rcBounding);	//!< 绘制执行时间所占的比例
 
 	QGraphicsDropShadowEffect*				m_dropdownShadowEffect;
 	GraphicsUI::GraphicsToolButton*			m_btnShowPort;		//!< 显示端口
@@ -0,0 +1,69 @@
+#include "property.h"
+#include "propertyowner.h"
+
+namespace DesignNet{
+
+Property::Property(const QString &id, const QString &name, QObject *parent)
+	: QObject(parent),
+	  m_id(id),
+	  m_name(name),
+	  m_owner(0)
+{
+}
+
+Property::~Property()
+{
+
+}
+
+QString Property::id() const
+{
+	return m_id;
+}
+
+void Property::setId(const QString &id)
+{
+	m_id = id;
+}
+
+QString Property::name() const
+{
+	return m_name;
+}
+
+void Property::setName(const QString &name)
+{
+	m_name = name;
+}
+
+PropertyOwner *Property::owner() const
+{
+	return m_owner;
+}
+
+void Property::setOwner(PropertyOwner *owner)
+{
+	m_owner = owner;
+}
+
+void Property::serialize(Utils::XmlSerializer& s) const
+{
+
+}
+
+void Property::deserialize(Utils::XmlDeserializer& s)
+{
+
+}
+
+QString Property::serializableType() const
+{
+	return typeID().toString();
+}
+
+Utils::XmlSerializable* Property::createSerializable() const
+{
+	return 0;
+}
+
+}
@@ -4,7 +4,7 @@
 #include <QObject>
 #include "aggregation/aggregate.h"
 #include "../designnet_core_global.h"
-#include "coreplugin/id.h"
+#include "coreplugin/Common/id.h"
 #include "Utils/XML/xmlserializable.h"
 namespace Utils{
 class XmlSerializer;
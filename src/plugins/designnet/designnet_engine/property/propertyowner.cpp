@@ -1,5 +1,4 @@
 ﻿#include "propertyowner.h"
-#include "coreplugin/icore.h"
 #include "property.h"
 #include "Utils/XML/xmlserializer.h"
 #include "Utils/XML/xmlserializable.h"
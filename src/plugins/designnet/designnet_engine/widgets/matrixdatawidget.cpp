@@ -87,7 +87,7 @@ int MatrixModel::rowCount( const QModelIndex & parent /*= QModelIndex() */ ) con
 
 int MatrixModel::columnCount( const QModelIndex &/*parent*/ ) const
 {
-	cv::Mat &mat = matrix();
+	const cv::Mat &mat = matrix();
 	return mat.cols;
 }
 
@@ -140,7 +140,7 @@ cv::Mat MatrixModel::matrix() const
 	MatrixData *data = qobject_cast<MatrixData*>(m_widget->m_data);
 	if(data)
 	{
-		return data->getMatrix();
+		return data->matrix();
 	}
 	return cv::Mat();
 }